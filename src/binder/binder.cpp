@@ -9,8 +9,11 @@
 #include "binder/statements/statements.h"
 #include "binder/table_refs/table_refs.h"
 #include "catalog/column_definition.h"
+#include "common/constants.h"
 #include "common/exceptions.h"
+#include "common/string_util.h"
 #include "common/value.h"
+#include "function/function_registry.h"
 #include "nodes/parsenodes.hpp"
 
 namespace huadb {
@@ -24,6 +27,8 @@ std::unique_ptr<Statement> Binder::BindStatement(duckdb_libpgquery::PGNode *stmt
       return BindCreateDatabaseStatement(reinterpret_cast<duckdb_libpgquery::PGCreateDatabaseStmt *>(stmt));
     case duckdb_libpgquery::T_PGCreateStmt:
       return BindCreateTableStatement(reinterpret_cast<duckdb_libpgquery::PGCreateStmt *>(stmt));
+    case duckdb_libpgquery::T_PGIndexStmt:
+      return BindCreateIndexStatement(reinterpret_cast<duckdb_libpgquery::PGIndexStmt *>(stmt));
     case duckdb_libpgquery::T_PGDropStmt:
       return BindDropStatement(reinterpret_cast<duckdb_libpgquery::PGDropStmt *>(stmt));
 
@@ -120,6 +125,87 @@ ColumnDefinition Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *co
   return {col_name, col_type, max_size};
 }
 
+std::unique_ptr<Statement> Binder::BindCreateIndexStatement(duckdb_libpgquery::PGIndexStmt *stmt) {
+  std::string table_name = stmt->relation->relname;
+  std::string access_method = stmt->accessMethod;
+  // 未指定访问方法时语法分析器返回 art，与 btree 一样使用 B+ 树
+  IndexType index_type;
+  if (access_method == "art" || access_method == "btree") {
+    index_type = IndexType::BTREE;
+  } else if (access_method == "hash") {
+    index_type = IndexType::HASH;
+  } else {
+    throw DbException("Unsupported index access method: " + access_method);
+  }
+  if (stmt->unique) {
+    throw DbException("Unique index is not supported");
+  }
+  if (stmt->whereClause != nullptr) {
+    throw DbException("Partial index is not supported");
+  }
+  std::vector<std::string> columns;
+  for (auto *cell = stmt->indexParams->head; cell != nullptr; cell = lnext(cell)) {
+    auto *elem = reinterpret_cast<duckdb_libpgquery::PGIndexElem *>(cell->data.ptr_value);
+    if (elem->name == nullptr) {
+      throw DbException("Expression index is not supported");
+    }
+    if (elem->ordering == duckdb_libpgquery::PG_SORTBY_DESC ||
+        elem->nulls_ordering == duckdb_libpgquery::PG_SORTBY_NULLS_FIRST) {
+      throw DbException("Index only supports ascending order with nulls last");
+    }
+    columns.emplace_back(elem->name);
+  }
+  // 语法不支持 INCLUDE 子句，包含列通过 WITH (include = 'a, b') 指定
+  std::vector<std::string> include_columns;
+  size_t fill_factor = DEFAULT_INDEX_FILL_FACTOR;
+  if (stmt->options != nullptr) {
+    for (auto *cell = stmt->options->head; cell != nullptr; cell = lnext(cell)) {
+      auto *elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+      auto *arg = reinterpret_cast<duckdb_libpgquery::PGValue *>(elem->arg);
+      if (strcasecmp(elem->defname, "fillfactor") == 0) {
+        if (arg == nullptr || arg->type != duckdb_libpgquery::T_PGInteger ||
+            arg->val.ival < static_cast<int>(MIN_INDEX_FILL_FACTOR) || arg->val.ival > 100) {
+          throw DbException("Index option fillfactor must be an integer between " +
+                            std::to_string(MIN_INDEX_FILL_FACTOR) + " and 100");
+        }
+        fill_factor = arg->val.ival;
+        continue;
+      }
+      if (strcasecmp(elem->defname, "include") != 0) {
+        throw DbException("Unknown index option: " + std::string(elem->defname));
+      }
+      if (arg == nullptr || arg->type != duckdb_libpgquery::T_PGString) {
+        throw DbException("Index option include must be a string of column names");
+      }
+      for (auto column : StringUtil::Split(arg->val.str, ',')) {
+        StringUtil::LTrim(column);
+        StringUtil::RTrim(column);
+        if (column.empty()) {
+          throw DbException("Empty column name in index option include");
+        }
+        include_columns.push_back(StringUtil::Lower(column));
+      }
+    }
+  }
+  if (index_type == IndexType::HASH && !include_columns.empty()) {
+    throw DbException("Hash index does not support included columns");
+  }
+  // 未指定索引名时与 PostgreSQL 一样使用 表名_列名_idx
+  std::string index_name;
+  if (stmt->idxname != nullptr) {
+    index_name = stmt->idxname;
+  } else {
+    index_name = table_name;
+    for (const auto &column : columns) {
+      index_name += "_" + column;
+    }
+    index_name += "_idx";
+  }
+  bool if_not_exists = stmt->onconflict == duckdb_libpgquery::PG_IGNORE_ON_CONFLICT;
+  return std::make_unique<CreateIndexStatement>(std::move(index_name), std::move(table_name), std::move(columns),
+                                                std::move(include_columns), index_type, fill_factor, if_not_exists);
+}
+
 std::unique_ptr<Statement> Binder::BindDropStatement(duckdb_libpgquery::PGDropStmt *stmt) {
   std::string name;
   auto *name_list = reinterpret_cast<duckdb_libpgquery::PGList *>(stmt->objects->head->data.ptr_value);
@@ -134,6 +220,8 @@ std::unique_ptr<Statement> Binder::BindDropStatement(duckdb_libpgquery::PGDropSt
       return std::make_unique<DropDatabaseStatement>(name, stmt->missing_ok);
     case duckdb_libpgquery::PG_OBJECT_TABLE:
       return std::make_unique<DropTableStatement>(name, stmt->missing_ok);
+    case duckdb_libpgquery::PG_OBJECT_INDEX:
+      return std::make_unique<DropIndexStatement>(name, stmt->missing_ok);
     default:
       throw DbException("Unknown catalog type");
   }
@@ -394,6 +482,8 @@ std::unique_ptr<Expression> Binder::BindExpression(duckdb_libpgquery::PGNode *ex
       return BindListExpression(reinterpret_cast<duckdb_libpgquery::PGList *>(expr));
     case duckdb_libpgquery::T_PGTypeCast:
       return BindTypeCastExpression(reinterpret_cast<duckdb_libpgquery::PGTypeCast *>(expr));
+    case duckdb_libpgquery::T_PGSubLink:
+      return BindSubqueryExpression(reinterpret_cast<duckdb_libpgquery::PGSubLink *>(expr));
     default:
       throw DbException("Unsupported expression type: " + NodeTagToString(expr->type));
   }
@@ -490,8 +580,9 @@ std::unique_ptr<Expression> Binder::BindStarExpression(duckdb_libpgquery::PGASta
 }
 
 std::unique_ptr<Expression> Binder::BindFuncCallExpression(duckdb_libpgquery::PGFuncCall *expr) {
+  // trim 等特殊语法生成的函数名带有模式前缀，取最后一部分
   std::string function_name =
-      reinterpret_cast<duckdb_libpgquery::PGValue *>(expr->funcname->head->data.ptr_value)->val.str;
+      reinterpret_cast<duckdb_libpgquery::PGValue *>(expr->funcname->tail->data.ptr_value)->val.str;
   std::transform(function_name.begin(), function_name.end(), function_name.begin(),
                  [](unsigned char character) { return std::tolower(character); });
 
@@ -504,10 +595,10 @@ std::unique_ptr<Expression> Binder::BindFuncCallExpression(duckdb_libpgquery::PG
   }
 
   if (function_name == "avg" || function_name == "count" || function_name == "sum" || function_name == "min" ||
-      function_name == "max") {
+      function_name == "max" || function_name == "approx_count_distinct") {
     return std::make_unique<AggregateExpression>(std::move(function_name), expr->agg_distinct, std::move(args));
   }
-  if (function_name == "lower" || function_name == "upper" || function_name == "length") {
+  if (FunctionRegistry::GetInstance().Exists(function_name)) {
     if (expr->agg_distinct) {
       throw DbException(fmt::format("DISTINCT specified, but {} is not an aggregate function", function_name));
     }
@@ -587,6 +678,52 @@ std::unique_ptr<Expression> Binder::BindTypeCastExpression(duckdb_libpgquery::PG
   return std::make_unique<TypeCastExpression>(TypeUtil::String2Type(type_name), std::move(arg));
 }
 
+std::unique_ptr<Expression> Binder::BindSubqueryExpression(duckdb_libpgquery::PGSubLink *expr) {
+  SubqueryType subquery_type;
+  std::unique_ptr<Expression> left;
+  switch (expr->subLinkType) {
+    case duckdb_libpgquery::PG_EXISTS_SUBLINK:
+      subquery_type = SubqueryType::EXISTS;
+      break;
+    case duckdb_libpgquery::PG_ANY_SUBLINK: {
+      // IN 没有运算符名，= ANY 的运算符名为 =
+      if (expr->operName != nullptr) {
+        auto *name = reinterpret_cast<duckdb_libpgquery::PGValue *>(expr->operName->head->data.ptr_value);
+        std::string op_name = name->val.str;
+        if (op_name != "=") {
+          throw DbException("Unsupported operator in ANY subquery: " + op_name);
+        }
+      }
+      subquery_type = SubqueryType::IN;
+      left = BindExpression(expr->testexpr);
+      break;
+    }
+    default:
+      throw DbException("Only EXISTS and IN subqueries are supported");
+  }
+  if (expr->subselect->type != duckdb_libpgquery::T_PGSelectStmt) {
+    throw DbException("Unsupported subquery: " + NodeTagToString(expr->subselect->type));
+  }
+
+  // 子查询有独立的别名，绑定结束后恢复外层查询的状态
+  auto *outer_table = table_;
+  auto outer_aliases = std::move(aliases_);
+  auto outer_adding_alias = adding_alias_;
+  outer_tables_.push_back(outer_table);
+  aliases_.clear();
+  adding_alias_ = true;
+  auto subquery = BindSelectStatement(reinterpret_cast<duckdb_libpgquery::PGSelectStmt *>(expr->subselect));
+  outer_tables_.pop_back();
+  table_ = outer_table;
+  aliases_ = std::move(outer_aliases);
+  adding_alias_ = outer_adding_alias;
+
+  if (subquery_type == SubqueryType::IN && subquery->select_list_.size() != 1) {
+    throw DbException("Subquery must return only one column");
+  }
+  return std::make_unique<SubqueryExpression>(subquery_type, std::move(left), std::move(subquery));
+}
+
 std::vector<std::unique_ptr<OrderBy>> Binder::BindOrderBy(duckdb_libpgquery::PGList *list) {
   auto order_by = std::vector<std::unique_ptr<OrderBy>>();
   for (auto *node = list->head; node != nullptr; node = lnext(node)) {
@@ -751,6 +888,15 @@ std::unique_ptr<Expression> Binder::ResolveColumn(const std::vector<std::string>
   }
   if (column == nullptr) {
     if (column_name.size() != 1 || aliases_.find(column_name[0]) == aliases_.end()) {
+      // 子查询中引用外层查询的列
+      for (auto it = outer_tables_.rbegin(); it != outer_tables_.rend(); it++) {
+        if ((*it)->type_ == TableRefType::EMPTY) {
+          continue;
+        }
+        if (auto outer_column = ResolveColumnInternal(**it, column_name)) {
+          return outer_column;
+        }
+      }
       throw DbException(fmt::format("Column {} not found", fmt::join(column_name, ".")));
     }
     // 别名重合
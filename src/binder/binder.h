@@ -14,6 +14,7 @@ struct PGCreateDatabaseStmt;
 struct PGUseStmt;
 struct PGDropStmt;
 struct PGCreateStmt;
+struct PGIndexStmt;
 
 struct PGInsertStmt;
 struct PGDeleteStmt;
@@ -38,6 +39,7 @@ struct PGList;
 struct PGTypeCast;
 struct PGColumnRef;
 struct PGFuncCall;
+struct PGSubLink;
 
 struct PGRangeVar;
 struct PGJoinExpr;
@@ -71,6 +73,7 @@ class Binder {
 
   std::unique_ptr<Statement> BindCreateTableStatement(duckdb_libpgquery::PGCreateStmt *stmt);
   std::unique_ptr<Statement> BindCreateDatabaseStatement(duckdb_libpgquery::PGCreateDatabaseStmt *stmt);
+  std::unique_ptr<Statement> BindCreateIndexStatement(duckdb_libpgquery::PGIndexStmt *stmt);
   std::unique_ptr<Statement> BindDropStatement(duckdb_libpgquery::PGDropStmt *stmt);
 
   std::unique_ptr<Statement> BindInsertStatement(duckdb_libpgquery::PGInsertStmt *stmt);
@@ -107,6 +110,7 @@ class Binder {
   std::unique_ptr<Expression> BindNullTestExpression(duckdb_libpgquery::PGNullTest *expr);
   std::unique_ptr<Expression> BindListExpression(duckdb_libpgquery::PGList *expr);
   std::unique_ptr<Expression> BindTypeCastExpression(duckdb_libpgquery::PGTypeCast *expr);
+  std::unique_ptr<Expression> BindSubqueryExpression(duckdb_libpgquery::PGSubLink *expr);
 
   std::vector<std::unique_ptr<OrderBy>> BindOrderBy(duckdb_libpgquery::PGList *list);
 
@@ -130,6 +134,8 @@ class Binder {
 
   Catalog &catalog_;
   const TableRef *table_ = nullptr;
+  // 正在绑定子查询时，外层查询的表，子查询中找不到的列由内向外依次查找
+  std::vector<const TableRef *> outer_tables_;
   std::unordered_multimap<std::string, std::string> aliases_;
   std::unordered_set<std::string> table_names_;
   bool adding_alias_ = true;
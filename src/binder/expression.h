@@ -19,6 +19,7 @@ enum class ExpressionType {
   LIST,
   NULL_TEST,
   STAR,
+  SUBQUERY,
   UNARY_OP,
 };
 
@@ -9,5 +9,6 @@
 #include "binder/expressions/list_expression.h"
 #include "binder/expressions/null_test_expression.h"
 #include "binder/expressions/star_expression.h"
+#include "binder/expressions/subquery_expression.h"
 #include "binder/expressions/type_cast_expression.h"
 #include "binder/expressions/unary_op_expression.h"
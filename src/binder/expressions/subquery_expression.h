@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "binder/expression.h"
+#include "binder/statements/select_statement.h"
+#include "fmt/format.h"
+
+namespace huadb {
+
+enum class SubqueryType { EXISTS, IN };
+
+// WHERE 子句中的 EXISTS (SELECT ...) 或 expr IN (SELECT ...)，子查询可以引用外层查询的列
+// 由规划器改写为半连接或反连接，不逐行执行子查询
+class SubqueryExpression : public Expression {
+ public:
+  SubqueryExpression(SubqueryType subquery_type, std::unique_ptr<Expression> left,
+                     std::unique_ptr<SelectStatement> subquery)
+      : Expression(ExpressionType::SUBQUERY),
+        subquery_type_(subquery_type),
+        left_(std::move(left)),
+        subquery_(std::move(subquery)) {}
+  std::string ToString() const override {
+    if (subquery_type_ == SubqueryType::EXISTS) {
+      return "exists (subquery)";
+    }
+    return fmt::format("{} in (subquery)", left_);
+  }
+  bool HasAggregation() const override { return false; }
+
+  SubqueryType subquery_type_;
+  // IN 左侧的表达式，EXISTS 时为空
+  std::unique_ptr<Expression> left_;
+  std::unique_ptr<SelectStatement> subquery_;
+};
+
+}  // namespace huadb
@@ -8,9 +8,11 @@ enum class StatementType {
   ANALYZE_STATEMENT,
   CHECKPOINT_STATEMENT,
   CREATE_DATABASE_STATEMENT,
+  CREATE_INDEX_STATEMENT,
   CREATE_TABLE_STATEMENT,
   DELETE_STATEMENT,
   DROP_DATABASE_STATEMENT,
+  DROP_INDEX_STATEMENT,
   DROP_TABLE_STATEMENT,
   EXPLAIN_STATEMENT,
   INSERT_STATEMENT,
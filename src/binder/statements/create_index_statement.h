@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "binder/statement.h"
+#include "index/index_type.h"
+#include "fmt/ranges.h"
+
+namespace huadb {
+
+class CreateIndexStatement : public Statement {
+ public:
+  CreateIndexStatement(std::string index, std::string table, std::vector<std::string> columns,
+                       std::vector<std::string> include_columns, IndexType index_type, size_t fill_factor,
+                       bool if_not_exists)
+      : Statement(StatementType::CREATE_INDEX_STATEMENT),
+        index_(std::move(index)),
+        table_(std::move(table)),
+        columns_(std::move(columns)),
+        include_columns_(std::move(include_columns)),
+        index_type_(index_type),
+        fill_factor_(fill_factor),
+        if_not_exists_(if_not_exists) {}
+  std::string ToString() const override {
+    return fmt::format("CreateIndexStatement: index={} table={} type={} columns={} include={} fillfactor={}\n", index_,
+                       table_, IndexTypeToString(index_type_), columns_, include_columns_, fill_factor_);
+  }
+  std::string index_;
+  std::string table_;
+  std::vector<std::string> columns_;
+  // 只存储在索引项中、不参与查找的列
+  std::vector<std::string> include_columns_;
+  IndexType index_type_;
+  // 批量构建时节点的填充百分比
+  size_t fill_factor_;
+  bool if_not_exists_;
+};
+
+}  // namespace huadb
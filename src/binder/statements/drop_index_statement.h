@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+
+#include "binder/statement.h"
+#include "fmt/format.h"
+
+namespace huadb {
+
+class DropIndexStatement : public Statement {
+ public:
+  DropIndexStatement(std::string index, bool missing_ok)
+      : Statement(StatementType::DROP_INDEX_STATEMENT), index_(std::move(index)), missing_ok_(missing_ok) {}
+  std::string ToString() const override { return fmt::format("DropIndexStatement: index={}\n", index_); }
+  std::string index_;
+  bool missing_ok_;
+};
+
+}  // namespace huadb
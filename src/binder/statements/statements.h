@@ -3,9 +3,11 @@
 #include "binder/statements/analyze_statement.h"
 #include "binder/statements/checkpoint_statement.h"
 #include "binder/statements/create_database_statement.h"
+#include "binder/statements/create_index_statement.h"
 #include "binder/statements/create_table_statement.h"
 #include "binder/statements/delete_statement.h"
 #include "binder/statements/drop_database_statement.h"
+#include "binder/statements/drop_index_statement.h"
 #include "binder/statements/drop_table_statement.h"
 #include "binder/statements/explain_statement.h"
 #include "binder/statements/insert_statement.h"
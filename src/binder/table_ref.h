@@ -9,7 +9,8 @@ namespace huadb {
 
 enum class TableRefType { BASE_TABLE, CROSS_JOIN, EMPTY, EXPRESSION_LIST, JOIN };
 
-enum class JoinType { INNER, LEFT, RIGHT, FULL };
+// SEMI 和 ANTI 由 IN/EXISTS 子查询改写得到，只输出左侧的列
+enum class JoinType { INNER, LEFT, RIGHT, FULL, SEMI, ANTI };
 
 class TableRef {
  public:
@@ -56,6 +57,12 @@ struct fmt::formatter<huadb::JoinType> : formatter<string_view> {
       case huadb::JoinType::FULL:
         name = "full";
         break;
+      case huadb::JoinType::SEMI:
+        name = "semi";
+        break;
+      case huadb::JoinType::ANTI:
+        name = "anti";
+        break;
     }
     return formatter<string_view>::format(name, ctx);
   }
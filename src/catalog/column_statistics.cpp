@@ -0,0 +1,150 @@
+#include "catalog/column_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+#include "fmt/format.h"
+
+namespace huadb {
+
+static bool IsNumeric(Type type) { return type == Type::INT || type == Type::DOUBLE; }
+
+static bool IsString(Type type) { return type == Type::CHAR || type == Type::VARCHAR; }
+
+static double ToDouble(const Value &value) {
+  return value.GetType() == Type::INT ? value.GetValue<int32_t>() : value.GetValue<double>();
+}
+
+// Haas-Stokes 的 Duj1 估计：样本中只出现一次的值越多，说明表中还有越多未被抽到的不同值
+static uint32_t EstimateDistinct(double sample_rows, double distinct, double singletons, double total_rows) {
+  if (total_rows <= sample_rows || singletons == 0) {
+    return distinct;
+  }
+  auto estimate = sample_rows * distinct / (sample_rows - singletons + singletons * sample_rows / total_rows);
+  return std::llround(std::clamp(estimate, distinct, total_rows));
+}
+
+ColumnStatistics ColumnStatistics::Build(std::vector<Value> values, double total_rows) {
+  ColumnStatistics statistics;
+  if (values.empty()) {
+    return statistics;
+  }
+  double total = values.size();
+  auto nulls = std::remove_if(values.begin(), values.end(), [](const Value &value) { return value.IsNull(); });
+  statistics.null_frac_ = (values.end() - nulls) / total;
+  values.erase(nulls, values.end());
+  if (values.empty()) {
+    return statistics;
+  }
+  auto type = values[0].GetType();
+  auto non_null_rows = total_rows * (1 - statistics.null_frac_);
+  if (!IsNumeric(type) && !IsString(type)) {
+    std::unordered_map<Value, size_t> counts;
+    for (const auto &value : values) {
+      counts[value]++;
+    }
+    auto singletons = std::count_if(counts.begin(), counts.end(), [](const auto &entry) { return entry.second == 1; });
+    statistics.n_distinct_ = EstimateDistinct(values.size(), counts.size(), singletons, non_null_rows);
+    return statistics;
+  }
+  std::sort(values.begin(), values.end(), [](const Value &lhs, const Value &rhs) { return *Compare(lhs, rhs) < 0; });
+  // 相同的值排在一起，依次得到每个不同值的出现次数
+  std::vector<std::pair<size_t, size_t>> groups;
+  for (size_t i = 0; i < values.size(); i++) {
+    if (i == 0 || *Compare(values[i - 1], values[i]) != 0) {
+      groups.emplace_back(i, 0);
+    }
+    groups.back().second++;
+  }
+  auto singletons = std::count_if(groups.begin(), groups.end(), [](const auto &group) { return group.second == 1; });
+  statistics.n_distinct_ = EstimateDistinct(values.size(), groups.size(), singletons, non_null_rows);
+
+  // 不同值的个数不超过 MCV 列表长度时全部计入，否则只计入出现次数超过平均值 1.25 倍的值
+  auto is_wide = [&values](size_t i) { return values[i].ToString().size() > STATISTIC_VALUE_MAX_SIZE; };
+  bool all_fit = groups.size() <= STATISTIC_TARGET;
+  double min_count = 1.25 * values.size() / groups.size();
+  std::vector<std::pair<size_t, size_t>> candidates;
+  for (const auto &group : groups) {
+    if (!is_wide(group.first) && (all_fit || (group.second > 1 && group.second > min_count))) {
+      candidates.push_back(group);
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto &lhs, const auto &rhs) { return lhs.second > rhs.second; });
+  if (candidates.size() > STATISTIC_TARGET) {
+    candidates.resize(STATISTIC_TARGET);
+  }
+  std::vector<bool> in_mcv(values.size(), false);
+  for (const auto &[first, count] : candidates) {
+    statistics.mcv_values_.push_back(values[first]);
+    statistics.mcv_freqs_.push_back(count / total);
+    std::fill_n(in_mcv.begin() + first, count, true);
+  }
+
+  // 其余的值按位置等距选取边界，相邻的边界相同时合并
+  std::vector<size_t> rest;
+  for (size_t i = 0; i < values.size(); i++) {
+    if (!in_mcv[i] && !is_wide(i)) {
+      rest.push_back(i);
+    }
+  }
+  if (rest.size() < 2) {
+    return statistics;
+  }
+  size_t bound_count = std::min(STATISTIC_TARGET + 1, rest.size());
+  for (size_t i = 0; i < bound_count; i++) {
+    const auto &bound = values[rest[i * (rest.size() - 1) / (bound_count - 1)]];
+    if (statistics.histogram_bounds_.empty() || *Compare(statistics.histogram_bounds_.back(), bound) != 0) {
+      statistics.histogram_bounds_.push_back(bound);
+    }
+  }
+  if (statistics.histogram_bounds_.size() < 2) {
+    statistics.histogram_bounds_.clear();
+  }
+  return statistics;
+}
+
+std::optional<int> ColumnStatistics::Compare(const Value &lhs, const Value &rhs) {
+  if (lhs.IsNull() || rhs.IsNull()) {
+    return std::nullopt;
+  }
+  if (IsNumeric(lhs.GetType()) && IsNumeric(rhs.GetType())) {
+    auto lhs_double = ToDouble(lhs);
+    auto rhs_double = ToDouble(rhs);
+    return (lhs_double > rhs_double) - (lhs_double < rhs_double);
+  }
+  if (IsString(lhs.GetType()) && IsString(rhs.GetType())) {
+    return lhs.GetValue<std::string>().compare(rhs.GetValue<std::string>());
+  }
+  return std::nullopt;
+}
+
+std::string ColumnStatistics::ValueToString(const Value &value) {
+  if (!value.IsNull() && value.GetType() == Type::DOUBLE) {
+    return fmt::format("{}", value.GetValue<double>());
+  }
+  return value.ToString();
+}
+
+Value ColumnStatistics::ValueFromString(const std::string &str, Type type) {
+  switch (type) {
+    case Type::BOOL:
+      return Value(str == "true");
+    case Type::INT:
+      return Value(static_cast<int32_t>(std::stoi(str)));
+    case Type::UINT:
+      return Value(static_cast<uint32_t>(std::stoul(str)));
+    case Type::DOUBLE:
+      return Value(std::stod(str));
+    case Type::CHAR:
+    case Type::VARCHAR:
+      return Value(str, type);
+    default:
+      throw DbException("Unknown value type in ValueFromString");
+  }
+}
+
+}  // namespace huadb
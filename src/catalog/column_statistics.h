@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/value.h"
+
+namespace huadb {
+
+// ANALYZE 收集的列统计信息
+// 最常见值（MCV）列表记录出现次数明显多于平均值的取值及其比例，其余非空值由等深直方图描述：
+// 相邻两个边界之间为一个桶，各个桶包含的记录数相同，桶内的值假定均匀分布
+// 只有整数、浮点数和字符串列有 MCV 列表和直方图，超过 STATISTIC_VALUE_MAX_SIZE 的字符串不计入两者
+struct ColumnStatistics {
+  // 由 values 计算统计信息，values 为列的全部取值或样本，可以包含空值
+  // total_rows 为表的估计行数，大于样本大小时由样本推算全表的不同值个数
+  static ColumnStatistics Build(std::vector<Value> values, double total_rows = 0);
+  // 比较两个值，整数与浮点数按数值比较，CHAR 与 VARCHAR 按字符串比较，无法比较时返回 nullopt
+  static std::optional<int> Compare(const Value &lhs, const Value &rhs);
+  // 将值保存为字符串，浮点数使用可以精确还原的最短表示，Value::ToString 只保留 6 位有效数字
+  static std::string ValueToString(const Value &value);
+  // 将 ValueToString 的结果还原为 type 类型的值
+  static Value ValueFromString(const std::string &str, Type type);
+
+  uint32_t n_distinct_ = 0;
+  // 空值占全部记录的比例
+  double null_frac_ = 0;
+  // 最常见值及其占全部记录的比例，按比例降序排列
+  std::vector<Value> mcv_values_;
+  std::vector<double> mcv_freqs_;
+  // 直方图的边界，升序排列，不包含 MCV 列表中的值
+  std::vector<Value> histogram_bounds_;
+};
+
+}  // namespace huadb
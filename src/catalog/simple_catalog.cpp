@@ -171,6 +171,25 @@ bool SimpleCatalog::TableExists(oid_t oid) { return !oid_manager_.OidExists(oid)
 
 oid_t SimpleCatalog::GetNextOid() const { return oid_manager_.GetNextOid(); }
 
+std::shared_ptr<Index> SimpleCatalog::CreateIndex(const std::string &index_name, const std::string &table_name,
+                                                  const std::vector<std::string> &column_names,
+                                                  const std::vector<std::string> &include_column_names,
+                                                  IndexType index_type) {
+  throw DbException("CreateIndex not implemented in SimpleCatalog");
+}
+
+void SimpleCatalog::DropIndex(const std::string &index_name, bool missing_ok) {
+  throw DbException("DropIndex not implemented in SimpleCatalog");
+}
+
+bool SimpleCatalog::IndexExists(const std::string &index_name) { return false; }
+
+std::shared_ptr<Index> SimpleCatalog::GetIndex(oid_t index_oid) {
+  throw DbException("GetIndex not implemented in SimpleCatalog");
+}
+
+std::vector<std::shared_ptr<Index>> SimpleCatalog::GetTableIndexes(oid_t table_oid) { return {}; }
+
 uint32_t SimpleCatalog::GetCardinality(const std::string &table_name) { return INVALID_CARDINALITY; }
 
 uint32_t SimpleCatalog::GetDistinct(const std::string &table_name, const std::string &column_name) {
@@ -179,6 +198,12 @@ uint32_t SimpleCatalog::GetDistinct(const std::string &table_name, const std::st
 
 void SimpleCatalog::SetCardinality(const std::string &table_name, uint32_t cardinality) {}
 
-void SimpleCatalog::SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct) {}
+std::shared_ptr<const ColumnStatistics> SimpleCatalog::GetColumnStatistics(const std::string &table_name,
+                                                                           const std::string &column_name) {
+  return nullptr;
+}
+
+void SimpleCatalog::SetColumnStatistics(const std::string &table_name, const std::string &column_name,
+                                        const ColumnStatistics &statistics) {}
 
 }  // namespace huadb
@@ -5,8 +5,10 @@
 #include <vector>
 
 #include "catalog/column_list.h"
+#include "catalog/column_statistics.h"
 #include "catalog/oid_manager.h"
 #include "common/constants.h"
+#include "index/index_type.h"
 
 namespace huadb {
 
@@ -14,6 +16,7 @@ class Disk;
 class BufferPool;
 class LogManager;
 class Table;
+class Index;
 
 class SimpleCatalog {
  public:
@@ -55,12 +58,30 @@ class SimpleCatalog {
   bool TableExists(oid_t oid);
   // 获取下一个 oid
   oid_t GetNextOid() const;
+
+  // 在表上创建索引
+  std::shared_ptr<Index> CreateIndex(const std::string &index_name, const std::string &table_name,
+                                     const std::vector<std::string> &column_names,
+                                     const std::vector<std::string> &include_column_names, IndexType index_type);
+  // 删除索引
+  void DropIndex(const std::string &index_name, bool missing_ok);
+  // 判断索引是否存在
+  bool IndexExists(const std::string &index_name);
+  // 根据 oid 获取索引
+  std::shared_ptr<Index> GetIndex(oid_t index_oid);
+  // 获取表上的所有索引
+  std::vector<std::shared_ptr<Index>> GetTableIndexes(oid_t table_oid);
+
   // 获取统计信息
   uint32_t GetCardinality(const std::string &table_name);
   uint32_t GetDistinct(const std::string &table_name, const std::string &column_name);
+  // 获取列的统计信息，未收集时返回 nullptr
+  std::shared_ptr<const ColumnStatistics> GetColumnStatistics(const std::string &table_name,
+                                                              const std::string &column_name);
   // 设置统计信息
   void SetCardinality(const std::string &table_name, uint32_t cardinality);
-  void SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct);
+  void SetColumnStatistics(const std::string &table_name, const std::string &column_name,
+                           const ColumnStatistics &statistics);
 
  private:
   Disk &disk_;
@@ -72,7 +93,6 @@ class SimpleCatalog {
   std::unordered_map<std::string, oid_t> name2oid_;
   std::unordered_map<oid_t, std::shared_ptr<Table>> oid2table_;
   std::unordered_map<std::string, uint32_t> table2cardinality_;
-  std::unordered_map<std::string, uint32_t> col2distinct_;
 
   oid_t current_database_oid_ = INVALID_OID;
 };
@@ -1,11 +1,14 @@
 #include "catalog/system_catalog.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "catalog/system_schema.h"
 #include "common/constants.h"
 #include "common/exceptions.h"
+#include "common/string_util.h"
 #include "common/value.h"
+#include "index/index.h"
 #include "table/record.h"
 #include "table/table.h"
 #include "table/table_scan.h"
@@ -22,6 +25,7 @@ void SystemCatalog::CreateSystemTables() {
   CreateTable(TABLE_META_NAME, table_meta_schema, TABLE_META_OID, SYSTEM_DATABASE_OID, true);
   CreateTable(DATABASE_META_NAME, database_meta_schema, DATABASE_META_OID, SYSTEM_DATABASE_OID, true);
   CreateTable(STATISTIC_META_NAME, statistic_schema, STATISTIC_META_OID, SYSTEM_DATABASE_OID, true);
+  CreateTable(INDEX_META_NAME, index_meta_schema, INDEX_META_OID, SYSTEM_DATABASE_OID, true);
   // 插入默认数据库
   CreateDatabase(SYSTEM_DATABASE_NAME, false, SYSTEM_DATABASE_OID);
   CreateDatabase(DEFAULT_DATABASE_NAME, false);
@@ -35,6 +39,7 @@ void SystemCatalog::LoadSystemTables() {
   CreateTable(TABLE_META_NAME, table_meta_schema, TABLE_META_OID, SYSTEM_DATABASE_OID, false);
   CreateTable(DATABASE_META_NAME, database_meta_schema, DATABASE_META_OID, SYSTEM_DATABASE_OID, false);
   CreateTable(STATISTIC_META_NAME, statistic_schema, STATISTIC_META_OID, SYSTEM_DATABASE_OID, false);
+  CreateTable(INDEX_META_NAME, index_meta_schema, INDEX_META_OID, SYSTEM_DATABASE_OID, false);
   // 加载数据库信息
   LoadDatabaseMeta();
 
@@ -90,6 +95,16 @@ void SystemCatalog::DropDatabase(const std::string &database_name, bool missing_
     }
   }
 
+  // IndexMeta中删除包含的索引
+  auto index_meta = GetTable(INDEX_META_OID);
+  scan = std::make_shared<TableScan>(buffer_pool_, index_meta, Rid{index_meta->GetFirstPageId(), 0});
+  db_oid_idx = index_meta_schema.GetColumnIndex("db_oid");
+  while (auto record = scan->GetNextRecord()) {
+    if (record->GetValue(db_oid_idx).GetValue<oid_t>() == db_oid) {
+      index_meta->DeleteRecord(record->GetRid(), DDL_XID, false);
+    }
+  }
+
   // Step4. DatabaseMeta中删除对应项
   bool deleted = false;
   auto db_meta = GetTable(DATABASE_META_OID);
@@ -153,6 +168,7 @@ void SystemCatalog::ChangeDatabase(const std::string &database_name) {
   // 加载切换数据库的所有表
   LoadTableMeta();
   LoadStatistics();
+  LoadIndexMeta();
 }
 
 oid_t SystemCatalog::GetDatabaseOid(oid_t table_oid) {
@@ -223,7 +239,10 @@ void SystemCatalog::DropTable(const std::string &table_name) {
     throw DbException("Table " + table_name + " does not exist.");
   }
   oid_t table_oid = oid_manager_.GetEntryOid(OidType::TABLE, table_name);
-  // Step2. 实际删除表
+  // Step2. 删除表上的索引，并实际删除表
+  for (const auto &index : GetTableIndexes(table_oid)) {
+    DropIndex(index->GetOid());
+  }
   // 磁盘中删除对应项
   disk_.RemoveFile(Disk::GetFilePath(current_database_oid_, table_oid));
   oid2table_.erase(table_oid);
@@ -245,6 +264,9 @@ void SystemCatalog::DropTable(const std::string &table_name) {
   if (!deleted) {
     throw DbException("Table " + table_name + " does not exist in table_meta.");
   }
+  // Step5: 删除统计信息
+  table2cardinality_.erase(table_name);
+  DeleteStatistics(table_name, std::nullopt);
 }
 
 std::vector<std::string> SystemCatalog::GetTableNames() {
@@ -290,6 +312,94 @@ bool SystemCatalog::TableExists(oid_t oid) { return oid_manager_.OidExists(oid);
 
 oid_t SystemCatalog::GetNextOid() const { return oid_manager_.GetNextOid(); }
 
+std::shared_ptr<Index> SystemCatalog::CreateIndex(const std::string &index_name, const std::string &table_name,
+                                                  const std::vector<std::string> &column_names,
+                                                  const std::vector<std::string> &include_column_names,
+                                                  IndexType index_type) {
+  // Step1. 约束检测
+  CheckUsingDatabase();
+  if (oid_manager_.EntryExists(OidType::INDEX, index_name)) {
+    throw DbException("Index " + index_name + " already exists.");
+  }
+  auto table_oid = GetTableOid(table_name);
+  const auto &column_list = GetTableColumnList(table_oid);
+  std::vector<size_t> key_columns;
+  for (const auto &column_name : column_names) {
+    auto col_idx = column_list.GetColumnIndex(column_name);
+    if (std::find(key_columns.begin(), key_columns.end(), col_idx) != key_columns.end()) {
+      throw DbException("Column " + column_name + " appears more than once in index");
+    }
+    key_columns.push_back(col_idx);
+  }
+  std::vector<size_t> include_columns;
+  for (const auto &column_name : include_column_names) {
+    auto col_idx = column_list.GetColumnIndex(column_name);
+    if (std::find(key_columns.begin(), key_columns.end(), col_idx) != key_columns.end() ||
+        std::find(include_columns.begin(), include_columns.end(), col_idx) != include_columns.end()) {
+      throw DbException("Column " + column_name + " appears more than once in index");
+    }
+    include_columns.push_back(col_idx);
+  }
+  // Step2. OidManager添加对应项
+  auto oid = oid_manager_.CreateEntry(OidType::INDEX, index_name);
+  // Step3. 创建索引文件
+  disk_.CreateFile(Disk::GetFilePath(current_database_oid_, oid));
+  auto index = std::make_shared<Index>(buffer_pool_, log_manager_, oid, current_database_oid_, index_name, table_oid,
+                                       index_type, column_list, key_columns, include_columns, true);
+  oid2index_[oid] = index;
+  // Step4. IndexMeta中添加对应记录
+  std::string key_column_names;
+  for (const auto &column_name : column_names) {
+    key_column_names += (key_column_names.empty() ? "" : ",") + column_name;
+  }
+  std::string include_column_names_str;
+  for (const auto &column_name : include_column_names) {
+    include_column_names_str += (include_column_names_str.empty() ? "" : ",") + column_name;
+  }
+  std::vector<Value> values;
+  values.emplace_back(oid);
+  values.emplace_back(current_database_oid_);
+  values.emplace_back(index_name);
+  values.emplace_back(table_oid);
+  values.emplace_back(key_column_names);
+  values.emplace_back(include_column_names_str);
+  values.emplace_back(IndexTypeToString(index_type));
+  GetTable(INDEX_META_OID)->InsertRecord(std::make_shared<Record>(std::move(values)), DDL_XID, DDL_CID, false);
+  return index;
+}
+
+void SystemCatalog::DropIndex(const std::string &index_name, bool missing_ok) {
+  CheckUsingDatabase();
+  if (!oid_manager_.EntryExists(OidType::INDEX, index_name)) {
+    if (missing_ok) {
+      return;
+    }
+    throw DbException("Index " + index_name + " does not exist.");
+  }
+  DropIndex(oid_manager_.GetEntryOid(OidType::INDEX, index_name));
+}
+
+bool SystemCatalog::IndexExists(const std::string &index_name) {
+  return oid_manager_.EntryExists(OidType::INDEX, index_name);
+}
+
+std::shared_ptr<Index> SystemCatalog::GetIndex(oid_t index_oid) {
+  if (oid2index_.find(index_oid) == oid2index_.end()) {
+    throw DbException("Index with oid " + std::to_string(index_oid) + " does not exist.");
+  }
+  return oid2index_[index_oid];
+}
+
+std::vector<std::shared_ptr<Index>> SystemCatalog::GetTableIndexes(oid_t table_oid) {
+  std::vector<std::shared_ptr<Index>> indexes;
+  for (const auto &[oid, index] : oid2index_) {
+    if (index->GetTableOid() == table_oid) {
+      indexes.push_back(index);
+    }
+  }
+  return indexes;
+}
+
 uint32_t SystemCatalog::GetCardinality(const std::string &table_name) {
   if (table2cardinality_.find(table_name) == table2cardinality_.end()) {
     return INVALID_CARDINALITY;
@@ -298,10 +408,20 @@ uint32_t SystemCatalog::GetCardinality(const std::string &table_name) {
 }
 
 uint32_t SystemCatalog::GetDistinct(const std::string &table_name, const std::string &column_name) {
-  if (col2distinct_.find(table_name + "." + column_name) == col2distinct_.end()) {
+  auto statistics = GetColumnStatistics(table_name, column_name);
+  if (statistics == nullptr) {
     return INVALID_DISTINCT;
   }
-  return col2distinct_.at(table_name + "." + column_name);
+  return statistics->n_distinct_;
+}
+
+std::shared_ptr<const ColumnStatistics> SystemCatalog::GetColumnStatistics(const std::string &table_name,
+                                                                           const std::string &column_name) {
+  auto it = col2statistics_.find(table_name + "." + column_name);
+  if (it == col2statistics_.end()) {
+    return nullptr;
+  }
+  return it->second;
 }
 
 void SystemCatalog::SetCardinality(const std::string &table_name, uint32_t cardinality) {
@@ -327,34 +447,52 @@ void SystemCatalog::SetCardinality(const std::string &table_name, uint32_t cardi
   }
 }
 
-void SystemCatalog::SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct) {
+void SystemCatalog::SetColumnStatistics(const std::string &table_name, const std::string &column_name,
+                                        const ColumnStatistics &statistics) {
+  // 删除旧的统计信息后重新插入
+  DeleteStatistics(table_name, column_name);
+  auto statistic = GetTable(STATISTIC_META_OID);
+  auto insert = [&](const std::string &kind, size_t seq, const Value &value, double number) {
+    std::vector<Value> values;
+    values.emplace_back(table_name);
+    values.emplace_back(current_database_oid_);
+    values.emplace_back(column_name);
+    values.emplace_back(kind);
+    values.emplace_back(static_cast<uint32_t>(seq));
+    values.emplace_back(ColumnStatistics::ValueToString(value));
+    values.emplace_back(number);
+    statistic->InsertRecord(std::make_shared<Record>(std::move(values)), DDL_XID, DDL_CID, false);
+  };
+  insert("n_distinct", 0, Value(""), statistics.n_distinct_);
+  insert("null_frac", 0, Value(""), statistics.null_frac_);
+  for (size_t i = 0; i < statistics.mcv_values_.size(); i++) {
+    insert("mcv", i, statistics.mcv_values_[i], statistics.mcv_freqs_[i]);
+  }
+  for (size_t i = 0; i < statistics.histogram_bounds_.size(); i++) {
+    insert("histogram", i, statistics.histogram_bounds_[i], 0);
+  }
+  col2statistics_[table_name + "." + column_name] = std::make_shared<const ColumnStatistics>(statistics);
+}
+
+void SystemCatalog::DeleteStatistics(const std::string &table_name, const std::optional<std::string> &column_name) {
   auto statistic = GetTable(STATISTIC_META_OID);
   auto scan = std::make_shared<TableScan>(buffer_pool_, statistic, Rid{statistic->GetFirstPageId(), 0});
   auto table_name_idx = statistic_schema.GetColumnIndex("table_name");
   auto db_oid_idx = statistic_schema.GetColumnIndex("db_oid");
   auto column_name_idx = statistic_schema.GetColumnIndex("column_name");
-  auto n_dinstinct_idx = statistic_schema.GetColumnIndex("n_distinct");
-  bool found = false;
   while (auto record = scan->GetNextRecord()) {
     if (record->GetValue(db_oid_idx).GetValue<oid_t>() == current_database_oid_ &&
         record->GetValue(table_name_idx).GetValue<std::string>() == table_name &&
-        record->GetValue(column_name_idx).GetValue<std::string>() == column_name) {
-      if (found) {
-        throw DbException(table_name + "." + column_name + " has more than one record in statistic_meta");
-      }
-      auto n_distinct = record->GetValue(n_dinstinct_idx).GetValue<uint32_t>();
-      col2distinct_[table_name + "." + column_name] = n_distinct;
-      found = true;
+        (!column_name || record->GetValue(column_name_idx).GetValue<std::string>() == *column_name)) {
+      statistic->DeleteRecord(record->GetRid(), DDL_XID, false);
     }
   }
-  if (!found) {
-    std::vector<Value> values;
-    values.emplace_back(table_name);
-    values.emplace_back(current_database_oid_);
-    values.emplace_back(column_name);
-    values.emplace_back(distinct);
-    statistic->InsertRecord(std::make_shared<Record>(std::move(values)), DDL_XID, DDL_CID, false);
-    col2distinct_[table_name + "." + column_name] = distinct;
+  if (column_name) {
+    col2statistics_.erase(table_name + "." + *column_name);
+    return;
+  }
+  for (auto it = col2statistics_.begin(); it != col2statistics_.end();) {
+    it = it->first.compare(0, table_name.size() + 1, table_name + ".") == 0 ? col2statistics_.erase(it) : ++it;
   }
 }
 
@@ -379,6 +517,10 @@ void SystemCatalog::ExitDatabase() {
     oid_manager_.DropEntry(OidType::TABLE, table_name);
     oid2table_.erase(oid);
   }
+  for (const auto &[oid, index] : oid2index_) {
+    oid_manager_.DropEntry(OidType::INDEX, index->GetName());
+  }
+  oid2index_.clear();
   // 设定数据库id为无效值
   current_database_oid_ = INVALID_OID;
 }
@@ -395,6 +537,25 @@ bool SystemCatalog::DatabaseExists(const std::string &database_name) {
 
 void SystemCatalog::DropTable(oid_t oid) { DropTable(oid_manager_.GetEntryName(oid)); }
 
+void SystemCatalog::DropIndex(oid_t oid) {
+  // Step1. 实际删除索引文件
+  disk_.RemoveFile(Disk::GetFilePath(current_database_oid_, oid));
+  oid2index_.erase(oid);
+  // Step2. OidManager删除对应项
+  oid_manager_.DropEntry(OidType::INDEX, oid_manager_.GetEntryName(oid));
+  // Step3. IndexMeta删除对应条目
+  auto index_meta = GetTable(INDEX_META_OID);
+  auto scan = std::make_shared<TableScan>(buffer_pool_, index_meta, Rid{index_meta->GetFirstPageId(), 0});
+  auto index_oid_idx = index_meta_schema.GetColumnIndex("index_oid");
+  while (auto record = scan->GetNextRecord()) {
+    if (record->GetValue(index_oid_idx).GetValue<oid_t>() == oid) {
+      index_meta->DeleteRecord(record->GetRid(), DDL_XID, false);
+      return;
+    }
+  }
+  throw DbException("Index with oid " + std::to_string(oid) + " does not exist in index_meta.");
+}
+
 void SystemCatalog::LoadDatabaseMeta() {
   assert(oid2table_.find(DATABASE_META_OID) != oid2table_.end());
   auto db_meta = GetTable(DATABASE_META_OID);
@@ -436,18 +597,81 @@ void SystemCatalog::LoadTableMeta() {
 }
 
 void SystemCatalog::LoadStatistics() {
+  col2statistics_.clear();
   auto statistic = GetTable(STATISTIC_META_OID);
   auto scan = std::make_shared<TableScan>(buffer_pool_, statistic, Rid{statistic->GetFirstPageId(), 0});
   auto table_name_idx = statistic_schema.GetColumnIndex("table_name");
   auto db_oid_idx = statistic_schema.GetColumnIndex("db_oid");
   auto column_name_idx = statistic_schema.GetColumnIndex("column_name");
-  auto n_dinstinct_idx = statistic_schema.GetColumnIndex("n_distinct");
+  auto kind_idx = statistic_schema.GetColumnIndex("kind");
+  auto seq_idx = statistic_schema.GetColumnIndex("seq");
+  auto value_idx = statistic_schema.GetColumnIndex("value");
+  auto number_idx = statistic_schema.GetColumnIndex("number");
+  std::unordered_map<std::string, ColumnStatistics> col2statistics;
+  while (auto record = scan->GetNextRecord()) {
+    if (record->GetValue(db_oid_idx).GetValue<oid_t>() != current_database_oid_) {
+      continue;
+    }
+    auto table_name = record->GetValue(table_name_idx).GetValue<std::string>();
+    auto column_name = record->GetValue(column_name_idx).GetValue<std::string>();
+    auto kind = record->GetValue(kind_idx).GetValue<std::string>();
+    auto seq = record->GetValue(seq_idx).GetValue<uint32_t>();
+    auto number = record->GetValue(number_idx).GetValue<double>();
+    auto &statistics = col2statistics[table_name + "." + column_name];
+    if (kind == "n_distinct") {
+      statistics.n_distinct_ = number;
+    } else if (kind == "null_frac") {
+      statistics.null_frac_ = number;
+    } else {
+      // 按列的类型还原保存为字符串的值
+      const auto &column_list = GetTableColumnList(table_name);
+      auto type = column_list.GetColumn(column_list.GetColumnIndex(column_name)).type_;
+      auto value = ColumnStatistics::ValueFromString(record->GetValue(value_idx).GetValue<std::string>(), type);
+      auto &values = kind == "mcv" ? statistics.mcv_values_ : statistics.histogram_bounds_;
+      values.resize(std::max<size_t>(values.size(), seq + 1));
+      values[seq] = std::move(value);
+      if (kind == "mcv") {
+        statistics.mcv_freqs_.resize(values.size());
+        statistics.mcv_freqs_[seq] = number;
+      }
+    }
+  }
+  for (auto &[key, statistics] : col2statistics) {
+    col2statistics_[key] = std::make_shared<const ColumnStatistics>(std::move(statistics));
+  }
+}
+
+void SystemCatalog::LoadIndexMeta() {
+  auto index_meta = GetTable(INDEX_META_OID);
+  auto scan = std::make_shared<TableScan>(buffer_pool_, index_meta, Rid{index_meta->GetFirstPageId(), 0});
+  auto index_oid_idx = index_meta_schema.GetColumnIndex("index_oid");
+  auto db_oid_idx = index_meta_schema.GetColumnIndex("db_oid");
+  auto index_name_idx = index_meta_schema.GetColumnIndex("index_name");
+  auto table_oid_idx = index_meta_schema.GetColumnIndex("table_oid");
+  auto key_columns_idx = index_meta_schema.GetColumnIndex("key_columns");
+  auto include_columns_idx = index_meta_schema.GetColumnIndex("include_columns");
+  auto index_type_idx = index_meta_schema.GetColumnIndex("index_type");
   while (auto record = scan->GetNextRecord()) {
     if (record->GetValue(db_oid_idx).GetValue<oid_t>() == current_database_oid_) {
-      auto table_name = record->GetValue(table_name_idx).GetValue<std::string>();
-      auto column_name = record->GetValue(column_name_idx).GetValue<std::string>();
-      auto n_distinct = record->GetValue(n_dinstinct_idx).GetValue<uint32_t>();
-      col2distinct_[table_name + "." + column_name] = n_distinct;
+      auto oid = record->GetValue(index_oid_idx).GetValue<oid_t>();
+      auto index_name = record->GetValue(index_name_idx).GetValue<std::string>();
+      auto table_oid = record->GetValue(table_oid_idx).GetValue<oid_t>();
+      const auto &column_list = GetTableColumnList(table_oid);
+      std::vector<size_t> key_columns;
+      for (const auto &column_name : StringUtil::Split(record->GetValue(key_columns_idx).GetValue<std::string>(), ',')) {
+        key_columns.push_back(column_list.GetColumnIndex(column_name));
+      }
+      std::vector<size_t> include_columns;
+      for (const auto &column_name :
+           StringUtil::Split(record->GetValue(include_columns_idx).GetValue<std::string>(), ',')) {
+        include_columns.push_back(column_list.GetColumnIndex(column_name));
+      }
+      // 添加索引
+      oid_manager_.SetEntryOid(OidType::INDEX, index_name, oid);
+      auto index_type = StringToIndexType(record->GetValue(index_type_idx).GetValue<std::string>());
+      oid2index_[oid] = std::make_shared<Index>(buffer_pool_, log_manager_, oid, current_database_oid_, index_name,
+                                                table_oid, index_type, column_list, std::move(key_columns),
+                                                std::move(include_columns), false);
     }
   }
 }
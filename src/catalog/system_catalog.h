@@ -1,11 +1,15 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "catalog/column_list.h"
+#include "catalog/column_statistics.h"
 #include "catalog/oid_manager.h"
 #include "common/constants.h"
+#include "index/index_type.h"
 
 namespace huadb {
 
@@ -13,6 +17,7 @@ class Disk;
 class BufferPool;
 class LogManager;
 class Table;
+class Index;
 
 class SystemCatalog {
  public:
@@ -55,12 +60,30 @@ class SystemCatalog {
   bool TableExists(oid_t oid);
   // 获取下一个 oid
   oid_t GetNextOid() const;
+
+  // 在表上创建索引，只创建空的索引，已有记录的索引项由调用方插入
+  std::shared_ptr<Index> CreateIndex(const std::string &index_name, const std::string &table_name,
+                                     const std::vector<std::string> &column_names,
+                                     const std::vector<std::string> &include_column_names, IndexType index_type);
+  // 删除索引
+  void DropIndex(const std::string &index_name, bool missing_ok);
+  // 判断索引是否存在
+  bool IndexExists(const std::string &index_name);
+  // 根据 oid 获取索引
+  std::shared_ptr<Index> GetIndex(oid_t index_oid);
+  // 获取表上的所有索引，按创建顺序排列
+  std::vector<std::shared_ptr<Index>> GetTableIndexes(oid_t table_oid);
+
   // 获取统计信息
   uint32_t GetCardinality(const std::string &table_name);
   uint32_t GetDistinct(const std::string &table_name, const std::string &column_name);
+  // 获取列的统计信息，未收集时返回 nullptr
+  std::shared_ptr<const ColumnStatistics> GetColumnStatistics(const std::string &table_name,
+                                                              const std::string &column_name);
   // 设置统计信息
   void SetCardinality(const std::string &table_name, uint32_t cardinality);
-  void SetDistinct(const std::string &table_name, const std::string &column_name, uint32_t distinct);
+  void SetColumnStatistics(const std::string &table_name, const std::string &column_name,
+                           const ColumnStatistics &statistics);
 
  private:
   // 退出数据库
@@ -71,11 +94,16 @@ class SystemCatalog {
   bool DatabaseExists(const std::string &database_name);
   // 根据 oid 删除表
   void DropTable(oid_t oid);
+  // 根据 oid 删除索引
+  void DropIndex(oid_t oid);
 
   // 加载系统表
   void LoadDatabaseMeta();
   void LoadTableMeta();
   void LoadStatistics();
+  void LoadIndexMeta();
+  // 删除表的全部统计信息，column_name 不为空时只删除该列的统计信息
+  void DeleteStatistics(const std::string &table_name, const std::optional<std::string> &column_name);
 
   Disk &disk_;
   BufferPool &buffer_pool_;
@@ -86,7 +114,10 @@ class SystemCatalog {
   std::unordered_map<std::string, oid_t> name2oid_;
   std::unordered_map<oid_t, std::shared_ptr<Table>> oid2table_;
   std::unordered_map<std::string, uint32_t> table2cardinality_;
-  std::unordered_map<std::string, uint32_t> col2distinct_;
+  // 键为 表名.列名
+  std::unordered_map<std::string, std::shared_ptr<const ColumnStatistics>> col2statistics_;
+  // 按 oid 排序，使同一张表上的索引按创建顺序排列
+  std::map<oid_t, std::shared_ptr<Index>> oid2index_;
 
   oid_t current_database_oid_ = INVALID_OID;
 };
@@ -1,4 +1,5 @@
 #include "catalog/column_list.h"
+#include "common/constants.h"
 
 namespace huadb {
 
@@ -10,10 +11,23 @@ ColumnList table_meta_schema({ColumnDefinition("table_oid", Type::UINT),
                               ColumnDefinition("cardinality", Type::UINT)});
 ColumnList database_meta_schema({ColumnDefinition("db_oid", Type::UINT),
                                  ColumnDefinition("db_name", Type::VARCHAR, 32)});
+// 每列的统计信息由多条记录组成，kind 为 n_distinct、null_frac、mcv 或 histogram
+// 前两种记录的取值为 number；mcv 记录的 value 和 number 为第 seq 个最常见值及其比例
+// histogram 记录的 value 为直方图的第 seq 个边界。值以字符串保存，加载时按列的类型还原
 ColumnList statistic_schema({ColumnDefinition("table_name", Type::VARCHAR, 32),
                              ColumnDefinition("db_oid", Type::UINT),
                              ColumnDefinition("column_name", Type::VARCHAR, 32),
-                             ColumnDefinition("n_distinct", Type::UINT)});
+                             ColumnDefinition("kind", Type::VARCHAR, 16),
+                             ColumnDefinition("seq", Type::UINT),
+                             ColumnDefinition("value", Type::VARCHAR, STATISTIC_VALUE_MAX_SIZE),
+                             ColumnDefinition("number", Type::DOUBLE)});
+ColumnList index_meta_schema({ColumnDefinition("index_oid", Type::UINT),
+                              ColumnDefinition("db_oid", Type::UINT),
+                              ColumnDefinition("index_name", Type::VARCHAR, 32),
+                              ColumnDefinition("table_oid", Type::UINT),
+                              ColumnDefinition("key_columns", Type::VARCHAR, 128),
+                              ColumnDefinition("include_columns", Type::VARCHAR, 128),
+                              ColumnDefinition("index_type", Type::VARCHAR, 8)});
 // clang-format on
 
 }  // namespace huadb
@@ -26,7 +26,19 @@ static constexpr const char *MASTER_RECORD_NAME = "master_record";
 static constexpr size_t LOG_SEGMENT_SIZE = (1 << 20);
 static constexpr size_t DB_PAGE_SIZE = (1 << 8);
 static constexpr size_t MAX_RECORD_SIZE = 230;
+// 索引项的最大字节数，保证 B+ 树节点分裂后的两半都能放入一个页面
+static constexpr size_t MAX_INDEX_KEY_SIZE = DB_PAGE_SIZE / 4;
+// 批量构建索引时节点的默认填充百分比，为之后的插入预留空间
+static constexpr size_t DEFAULT_INDEX_FILL_FACTOR = 90;
+static constexpr size_t MIN_INDEX_FILL_FACTOR = 10;
+// 区域映射中每段摘要覆盖的页面数
+static constexpr size_t ZONE_MAP_PAGES = 4;
 static constexpr size_t BUFFER_SIZE = 5;
+// 单个执行器可使用的内存上限（KB），超出后将中间结果溢出到临时文件
+static constexpr size_t DEFAULT_WORK_MEM = 4096;
+// 每个 Gather 使用的工作线程数，为 0 时不生成并行计划
+static constexpr size_t DEFAULT_MAX_PARALLEL_WORKERS = 0;
+static constexpr size_t MAX_PARALLEL_WORKERS = 64;
 
 static constexpr lsn_t FIRST_LSN = 1;
 static constexpr lsn_t NULL_LSN = -1;
@@ -50,15 +62,23 @@ static constexpr oid_t TEMP_DATABASE_OID = 2;
 static constexpr oid_t TABLE_META_OID = 501;
 static constexpr oid_t DATABASE_META_OID = 502;
 static constexpr oid_t STATISTIC_META_OID = 503;
+static constexpr oid_t INDEX_META_OID = 504;
 
 static constexpr uint32_t INVALID_CARDINALITY = -1;
 static constexpr uint32_t INVALID_DISTINCT = -1;
+// 每列 MCV 列表的最大长度和直方图的最大桶数
+static constexpr size_t STATISTIC_TARGET = 10;
+// 统计信息中保存的值转换为字符串后的最大字节数，保证统计信息的记录能放入一个页面
+static constexpr size_t STATISTIC_VALUE_MAX_SIZE = 32;
+// ANALYZE 默认抽样的页面数和记录数
+static constexpr size_t DEFAULT_ANALYZE_SAMPLE_SIZE = 300 * STATISTIC_TARGET;
 
 static constexpr const char *SYSTEM_DATABASE_NAME = "system";
 
 static constexpr const char *TABLE_META_NAME = "huadb_table";
 static constexpr const char *DATABASE_META_NAME = "huadb_database";
 static constexpr const char *STATISTIC_META_NAME = "huadb_statistic";
+static constexpr const char *INDEX_META_NAME = "huadb_index";
 
 static constexpr const char *DEFAULT_DATABASE_NAME = "huadb";
 
@@ -0,0 +1,70 @@
+#include "common/hyper_log_log.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+HyperLogLog::HyperLogLog(size_t precision) : precision_(precision), registers_(size_t(1) << precision, '\0') {
+  if (precision_ < 4 || precision_ > 18) {
+    throw DbException("HyperLogLog precision out of range");
+  }
+}
+
+HyperLogLog::HyperLogLog(std::string registers) : precision_(0), registers_(std::move(registers)) {
+  while ((size_t(1) << precision_) < registers_.size()) {
+    precision_++;
+  }
+  if ((size_t(1) << precision_) != registers_.size()) {
+    throw DbException("Invalid HyperLogLog registers");
+  }
+}
+
+void HyperLogLog::Add(uint64_t hash) {
+  auto index = hash >> (64 - precision_);
+  auto rest = hash << precision_;
+  // 剩余位全为 0 时取最大值
+  uint8_t rank = rest == 0 ? 64 - precision_ + 1 : __builtin_clzll(rest) + 1;
+  if (rank > static_cast<uint8_t>(registers_[index])) {
+    registers_[index] = static_cast<char>(rank);
+  }
+}
+
+void HyperLogLog::Merge(const HyperLogLog &other) {
+  if (other.registers_.size() != registers_.size()) {
+    throw DbException("HyperLogLog precision mismatch");
+  }
+  for (size_t i = 0; i < registers_.size(); i++) {
+    auto lhs = static_cast<uint8_t>(registers_[i]);
+    auto rhs = static_cast<uint8_t>(other.registers_[i]);
+    registers_[i] = static_cast<char>(std::max(lhs, rhs));
+  }
+}
+
+uint64_t HyperLogLog::Estimate() const {
+  auto m = static_cast<double>(registers_.size());
+  double sum = 0;
+  size_t zeros = 0;
+  for (auto reg : registers_) {
+    auto rank = static_cast<uint8_t>(reg);
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) {
+      zeros++;
+    }
+  }
+  auto alpha = 0.7213 / (1 + 1.079 / m);
+  auto estimate = alpha * m * m / sum;
+  // 估计值较小时使用线性计数修正
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return static_cast<uint64_t>(std::llround(estimate));
+}
+
+const std::string &HyperLogLog::GetRegisters() const { return registers_; }
+
+size_t HyperLogLog::MemorySize() const { return sizeof(HyperLogLog) + registers_.size(); }
+
+}  // namespace huadb
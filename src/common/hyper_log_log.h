@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace huadb {
+
+// HyperLogLog 基数估计，使用 2^precision 个 1 字节的寄存器，标准误差约为 1.04 / sqrt(2^precision)
+// 输入为 64 位哈希值，哈希值的高 precision 位选择寄存器，其余位中首个 1 的位置更新寄存器
+class HyperLogLog {
+ public:
+  static constexpr size_t DEFAULT_PRECISION = 12;
+
+  explicit HyperLogLog(size_t precision = DEFAULT_PRECISION);
+  // 从 GetRegisters 的结果恢复
+  explicit HyperLogLog(std::string registers);
+
+  void Add(uint64_t hash);
+  // 合并另一个精度相同的 HyperLogLog
+  void Merge(const HyperLogLog &other);
+  uint64_t Estimate() const;
+
+  const std::string &GetRegisters() const;
+  // 占用的字节数
+  size_t MemorySize() const;
+
+ private:
+  size_t precision_;
+  std::string registers_;
+};
+
+}  // namespace huadb
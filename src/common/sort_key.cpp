@@ -0,0 +1,123 @@
+#include "common/sort_key.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+static void AppendBigEndian(uint64_t bits, size_t bytes, std::string &key) {
+  for (size_t i = bytes; i-- > 0;) {
+    key.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+  }
+}
+
+void SortKey::Append(const Value &value, bool descending, std::string &key) {
+  auto begin = key.size();
+  // 首字节标记是否为 NULL，非 NULL 值排在前面
+  if (value.IsNull()) {
+    key.push_back(static_cast<char>(1));
+  } else {
+    key.push_back(static_cast<char>(0));
+    switch (value.GetType()) {
+      case Type::BOOL:
+        key.push_back(static_cast<char>(value.GetValue<bool>()));
+        break;
+      case Type::INT:
+        // 翻转符号位，使负数排在正数之前
+        AppendBigEndian(static_cast<uint32_t>(value.GetValue<int32_t>()) ^ 0x80000000U, 4, key);
+        break;
+      case Type::UINT:
+        AppendBigEndian(value.GetValue<uint32_t>(), 4, key);
+        break;
+      case Type::DOUBLE: {
+        auto val = value.GetValue<double>();
+        if (val == 0) {
+          val = 0;
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &val, sizeof(bits));
+        // 负数翻转所有位，非负数翻转符号位
+        bits = (bits & 0x8000000000000000ULL) != 0 ? ~bits : bits ^ 0x8000000000000000ULL;
+        AppendBigEndian(bits, 8, key);
+        break;
+      }
+      case Type::CHAR:
+      case Type::VARCHAR: {
+        // 0x00 转义为 0x00 0xFF，以 0x00 0x00 结尾，保证较短的前缀排在前面
+        for (char c : value.GetValue<std::string>()) {
+          key.push_back(c);
+          if (c == '\0') {
+            key.push_back(static_cast<char>(0xFF));
+          }
+        }
+        key.push_back('\0');
+        key.push_back('\0');
+        break;
+      }
+      default:
+        throw DbException("Type unsupported for sort key");
+    }
+  }
+  // 降序时翻转该列编码的所有位
+  if (descending) {
+    for (auto i = begin; i < key.size(); i++) {
+      key[i] = static_cast<char>(~key[i]);
+    }
+  }
+}
+
+static uint64_t ReadBigEndian(const std::string &key, size_t &offset, size_t bytes) {
+  uint64_t bits = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    bits = (bits << 8) | static_cast<uint8_t>(key[offset++]);
+  }
+  return bits;
+}
+
+Value SortKey::Decode(const std::string &key, size_t &offset, Type type) {
+  if (key[offset++] != 0) {
+    return Value(type, 0);
+  }
+  switch (type) {
+    case Type::BOOL:
+      return Value(key[offset++] != 0);
+    case Type::INT:
+      return Value(static_cast<int32_t>(static_cast<uint32_t>(ReadBigEndian(key, offset, 4)) ^ 0x80000000U));
+    case Type::UINT:
+      return Value(static_cast<uint32_t>(ReadBigEndian(key, offset, 4)));
+    case Type::DOUBLE: {
+      auto bits = ReadBigEndian(key, offset, 8);
+      bits = (bits & 0x8000000000000000ULL) != 0 ? bits ^ 0x8000000000000000ULL : ~bits;
+      double val;
+      std::memcpy(&val, &bits, sizeof(val));
+      return Value(val);
+    }
+    case Type::CHAR:
+    case Type::VARCHAR: {
+      std::string str;
+      while (!(key[offset] == '\0' && key[offset + 1] == '\0')) {
+        str.push_back(key[offset]);
+        // 0x00 0xFF 为转义的 0x00
+        offset += key[offset] == '\0' ? 2 : 1;
+      }
+      offset += 2;
+      return Value(std::move(str), type);
+    }
+    default:
+      throw DbException("Type unsupported for sort key");
+  }
+}
+
+int SortKey::Compare(const std::string &lhs, const std::string &rhs) {
+  auto length = std::min(lhs.size(), rhs.size());
+  auto result = std::memcmp(lhs.data(), rhs.data(), length);
+  if (result != 0) {
+    return result;
+  }
+  return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+}
+
+}  // namespace huadb
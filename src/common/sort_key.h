@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+#include "common/value.h"
+
+namespace huadb {
+
+// 将排序键编码为字节串，使得按 memcmp 比较字节串的结果与按值比较的结果一致
+// 升序时 NULL 排在最后，降序时 NULL 排在最前
+class SortKey {
+ public:
+  // 将 value 的编码追加到 key 末尾，多列排序键依次追加即可
+  static void Append(const Value &value, bool descending, std::string &key);
+  // 从 key 的 offset 处解码一个类型为 type 的升序编码，offset 前进到下一列的编码
+  static Value Decode(const std::string &key, size_t &offset, Type type);
+  static int Compare(const std::string &lhs, const std::string &rhs);
+};
+
+}  // namespace huadb
@@ -5,6 +5,11 @@
 
 namespace huadb {
 
+void StringUtil::LTrim(std::string &str) {
+  str.erase(str.begin(),
+            std::find_if(str.begin(), str.end(), [](int character) { return std::isspace(character) == 0; }));
+}
+
 void StringUtil::RTrim(std::string &str) {
   str.erase(std::find_if(str.rbegin(), str.rend(), [](int character) { return std::isspace(character) == 0; }).base(),
             str.end());
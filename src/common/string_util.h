@@ -7,6 +7,7 @@ namespace huadb {
 
 class StringUtil {
  public:
+  static void LTrim(std::string &str);
   static void RTrim(std::string &str);
   static std::vector<std::string> Split(const std::string &str, char delim = '\n');
   static std::string Lower(const std::string &str);
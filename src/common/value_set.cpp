@@ -0,0 +1,79 @@
+#include "common/value_set.h"
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+ValueSet::ValueSet(Type type) : type_(type) {
+  if (!Supports(type)) {
+    throw DbException("Type unsupported for ValueSet: " + TypeUtil::Type2String(type));
+  }
+}
+
+bool ValueSet::Supports(Type type) { return type == Type::INT || type == Type::DOUBLE || TypeUtil::IsString(type); }
+
+bool ValueSet::Insert(const Value &value) {
+  switch (type_) {
+    case Type::INT:
+      return ints_.Insert(value.GetValue<int32_t>());
+    case Type::DOUBLE:
+      return doubles_.Insert(value.GetValue<double>());
+    default:
+      return strings_.Insert(value.GetValue<std::string>());
+  }
+}
+
+bool ValueSet::Contains(const Value &value) const {
+  switch (type_) {
+    case Type::INT:
+      return ints_.Contains(value.GetValue<int32_t>());
+    case Type::DOUBLE:
+      return doubles_.Contains(value.GetValue<double>());
+    default:
+      return strings_.Contains(value.GetValue<std::string>());
+  }
+}
+
+void ValueSet::ContainsBatch(const std::vector<Value> &values, std::vector<bool> &results) const {
+  results.resize(values.size());
+  // 类型分派移出循环，循环内只做查找
+  switch (type_) {
+    case Type::INT:
+      for (size_t i = 0; i < values.size(); i++) {
+        results[i] = !values[i].IsNull() && ints_.Contains(values[i].GetValue<int32_t>());
+      }
+      break;
+    case Type::DOUBLE:
+      for (size_t i = 0; i < values.size(); i++) {
+        results[i] = !values[i].IsNull() && doubles_.Contains(values[i].GetValue<double>());
+      }
+      break;
+    default:
+      for (size_t i = 0; i < values.size(); i++) {
+        results[i] = !values[i].IsNull() && strings_.Contains(values[i].GetValue<std::string>());
+      }
+      break;
+  }
+}
+
+bool ValueSet::Matches(const Value &value) const {
+  if (TypeUtil::IsString(type_)) {
+    return TypeUtil::IsString(value.GetType());
+  }
+  return value.GetType() == type_;
+}
+
+size_t ValueSet::Size() const {
+  switch (type_) {
+    case Type::INT:
+      return ints_.Size();
+    case Type::DOUBLE:
+      return doubles_.Size();
+    default:
+      return strings_.Size();
+  }
+}
+
+Type ValueSet::GetType() const { return type_; }
+
+}  // namespace huadb
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/exceptions.h"
+#include "common/value.h"
+
+namespace huadb {
+
+// 元素数目不超过该值时使用有序数组，超过后转为开放寻址哈希表
+static constexpr size_t SMALL_SET_SIZE = 16;
+
+class HashUtil {
+ public:
+  static uint64_t Hash(int32_t key) { return Mix(static_cast<uint64_t>(static_cast<uint32_t>(key))); }
+  static uint64_t Hash(double key) {
+    // +0.0 与 -0.0 相等，需映射到同一个哈希值
+    if (key == 0) {
+      key = 0;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return Mix(bits);
+  }
+  static uint64_t Hash(const std::string &key) { return Mix(std::hash<std::string>()(key)); }
+  // CHAR 与 VARCHAR 的哈希值相同，NULL 的哈希值为 0
+  static uint64_t Hash(const Value &value) {
+    if (value.IsNull()) {
+      return 0;
+    }
+    switch (value.GetType()) {
+      case Type::BOOL:
+        return Hash(static_cast<int32_t>(value.GetValue<bool>()));
+      case Type::INT:
+        return Hash(value.GetValue<int32_t>());
+      case Type::UINT:
+        return Hash(static_cast<int32_t>(value.GetValue<uint32_t>()));
+      case Type::DOUBLE:
+        return Hash(value.GetValue<double>());
+      case Type::CHAR:
+      case Type::VARCHAR:
+        return Hash(value.GetValue<std::string>());
+      default:
+        throw DbException("Type unsupported for hash");
+    }
+  }
+  // 组合多个哈希值，用于多列键
+  static uint64_t Combine(uint64_t seed, uint64_t hash) {
+    return seed ^ (hash + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  }
+
+ private:
+  // murmur3 finalizer，避免整数键在线性探测下聚集
+  static uint64_t Mix(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+  }
+};
+
+// 单一类型的集合，小集合使用有序数组二分查找，大集合使用线性探测的开放寻址哈希表
+template <typename T>
+class TypedSet {
+ public:
+  // 插入成功返回 true，元素已存在返回 false
+  bool Insert(const T &key) {
+    if (slots_.empty()) {
+      auto it = std::lower_bound(sorted_.begin(), sorted_.end(), key);
+      if (it != sorted_.end() && *it == key) {
+        return false;
+      }
+      sorted_.insert(it, key);
+      if (sorted_.size() > SMALL_SET_SIZE) {
+        Rehash(SMALL_SET_SIZE * 4);
+        for (const auto &element : sorted_) {
+          InsertIntoSlots(element);
+        }
+        sorted_.clear();
+        sorted_.shrink_to_fit();
+      }
+      return true;
+    }
+    if ((size_ + 1) * 2 > slots_.size()) {
+      Rehash(slots_.size() * 2);
+    }
+    return InsertIntoSlots(key);
+  }
+
+  bool Contains(const T &key) const {
+    if (slots_.empty()) {
+      return std::binary_search(sorted_.begin(), sorted_.end(), key);
+    }
+    size_t mask = slots_.size() - 1;
+    for (size_t pos = HashUtil::Hash(key) & mask; used_[pos]; pos = (pos + 1) & mask) {
+      if (slots_[pos] == key) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t Size() const { return slots_.empty() ? sorted_.size() : size_; }
+
+ private:
+  bool InsertIntoSlots(const T &key) {
+    size_t mask = slots_.size() - 1;
+    size_t pos = HashUtil::Hash(key) & mask;
+    for (; used_[pos]; pos = (pos + 1) & mask) {
+      if (slots_[pos] == key) {
+        return false;
+      }
+    }
+    slots_[pos] = key;
+    used_[pos] = true;
+    size_++;
+    return true;
+  }
+
+  void Rehash(size_t capacity) {
+    std::vector<T> old_slots = std::move(slots_);
+    std::vector<bool> old_used = std::move(used_);
+    slots_.assign(capacity, T());
+    used_.assign(capacity, false);
+    size_ = 0;
+    for (size_t i = 0; i < old_slots.size(); i++) {
+      if (old_used[i]) {
+        InsertIntoSlots(old_slots[i]);
+      }
+    }
+  }
+
+  std::vector<T> sorted_;
+  std::vector<T> slots_;
+  std::vector<bool> used_;
+  size_t size_ = 0;
+};
+
+// Value 集合，按类型选择对应的 TypedSet
+// 仅支持 INT、DOUBLE、CHAR 和 VARCHAR，CHAR 与 VARCHAR 视为同一类型
+class ValueSet {
+ public:
+  explicit ValueSet(Type type);
+
+  // 类型是否可以使用 ValueSet
+  static bool Supports(Type type);
+
+  bool Insert(const Value &value);
+  bool Contains(const Value &value) const;
+  // 批量判断 values 中的每个值是否在集合中，结果写入 results
+  void ContainsBatch(const std::vector<Value> &values, std::vector<bool> &results) const;
+  // value 的类型是否与集合的类型一致
+  bool Matches(const Value &value) const;
+  size_t Size() const;
+  Type GetType() const;
+
+ private:
+  Type type_;
+  TypedSet<int32_t> ints_;
+  TypedSet<double> doubles_;
+  TypedSet<std::string> strings_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace huadb {
+
+// 数据库引擎持有的工作线程池，用于查询内并行
+// 任务按提交顺序执行，调用者不能假设任务一定被执行：线程全部繁忙时任务可能一直排队，需由调用者自行兜底
+class WorkerPool {
+ public:
+  explicit WorkerPool(size_t thread_count);
+  ~WorkerPool();
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  void Submit(std::function<void()> task);
+  size_t GetThreadCount() const;
+
+ private:
+  void WorkerLoop();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  bool stopped_ = false;
+};
+
+}  // namespace huadb
@@ -1,6 +1,9 @@
 #include "database/database_engine.h"
 
 #include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
 
 #include "binder/binder.h"
 #include "binder/statements/statements.h"
@@ -8,12 +11,18 @@
 #include "common/exceptions.h"
 #include "common/result_writer.h"
 #include "common/string_util.h"
+#include "common/value_set.h"
 #include "database/connection.h"
 #include "executors/executor_context.h"
 #include "executors/executor_factory.h"
+#include "index/index.h"
+#include "index/index_builder.h"
 #include "operators/expressions/column_value.h"
 #include "postgres_parser.hpp"
 #include "table/record.h"
+#include "table/table.h"
+#include "table/table_page.h"
+#include "table/table_scan.h"
 
 namespace huadb {
 
@@ -151,6 +160,11 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, Co
         CreateDatabase(create_database_statement.database_, false, writer);
         break;
       }
+      case StatementType::CREATE_INDEX_STATEMENT: {
+        const auto &create_index_statement = dynamic_cast<CreateIndexStatement &>(*statement);
+        CreateIndex(xids_[&connection], create_index_statement, writer);
+        break;
+      }
       case StatementType::CREATE_TABLE_STATEMENT: {
         const auto &create_table_statement = dynamic_cast<CreateTableStatement &>(*statement);
         CreateTable(create_table_statement.table_, ColumnList(create_table_statement.columns_), writer);
@@ -161,6 +175,11 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, Co
         DropDatabase(drop_database_statement.database_, drop_database_statement.missing_ok_, writer);
         break;
       }
+      case StatementType::DROP_INDEX_STATEMENT: {
+        const auto &drop_index_statement = dynamic_cast<DropIndexStatement &>(*statement);
+        DropIndex(drop_index_statement.index_, drop_index_statement.missing_ok_, writer);
+        break;
+      }
       case StatementType::DROP_TABLE_STATEMENT: {
         const auto &drop_table_statement = dynamic_cast<DropTableStatement &>(*statement);
         DropTable(drop_table_statement.table_, writer);
@@ -208,7 +227,8 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, Co
 
           if (enable_optimizer_) {
             // 查询计划优化
-            Optimizer optimizer(*catalog_, join_order_algorithm_);
+            Optimizer optimizer(*catalog_, *buffer_pool_, join_order_algorithm_, force_join_, work_mem_ * 1024,
+                                max_parallel_workers_);
             plan = optimizer.Optimize(plan);
           }
 
@@ -228,7 +248,8 @@ void DatabaseEngine::ExecuteSql(const std::string &sql, ResultWriter &writer, Co
           }
           auto executor_context = std::make_unique<ExecutorContext>(
               *buffer_pool_, *catalog_, *transaction_manager_, *lock_manager_, xids_[&connection], isolation_level,
-              transaction_manager_->GetCidAndIncrement(xids_[&connection]), is_modification_sql);
+              transaction_manager_->GetCidAndIncrement(xids_[&connection]), is_modification_sql, work_mem_,
+              enable_runtime_filter_, worker_pool_.get());
 
           // 根据查询上下文和查询计划，生成执行器
           auto executor = ExecutorFactory::CreateExecutor(*executor_context, plan);
@@ -375,6 +396,36 @@ void DatabaseEngine::DropTable(const std::string &table_name, ResultWriter &writ
   WriteOneCell("DROP TABLE", writer);
 }
 
+void DatabaseEngine::CreateIndex(xid_t xid, const CreateIndexStatement &stmt, ResultWriter &writer) {
+  if (stmt.if_not_exists_ && catalog_->IndexExists(stmt.index_)) {
+    WriteOneCell("CREATE INDEX", writer);
+    return;
+  }
+  // 构建期间阻止其他事务修改表，构建时未提交的修改提交后会缺少索引项
+  if (!lock_manager_->LockTable(xid, LockType::S, catalog_->GetTableOid(stmt.table_))) {
+    throw DbException("Cannot acquire lock");
+  }
+  auto index = catalog_->CreateIndex(stmt.index_, stmt.table_, stmt.columns_, stmt.include_columns_,
+                                     stmt.index_type_);
+  // 扫描表中已有的记录，排序后自底向上批量构建索引
+  auto table = catalog_->GetTable(index->GetTableOid());
+  IndexBuilder builder(*buffer_pool_, table, index, work_mem_ * 1024, worker_pool_.get(),
+                       worker_pool_ == nullptr ? 0 : max_parallel_workers_);
+  try {
+    builder.Build(stmt.fill_factor_);
+  } catch (...) {
+    // 构建失败时删除已登记的索引，避免之后的插入和查询使用不完整的索引
+    catalog_->DropIndex(stmt.index_, false);
+    throw;
+  }
+  WriteOneCell("CREATE INDEX", writer);
+}
+
+void DatabaseEngine::DropIndex(const std::string &index_name, bool missing_ok, ResultWriter &writer) {
+  catalog_->DropIndex(index_name, missing_ok);
+  WriteOneCell("DROP INDEX", writer);
+}
+
 void DatabaseEngine::Begin(Connection &connection) {
   if (xids_.find(&connection) != xids_.end()) {
     throw DbException("There is already a transaction in progress");
@@ -440,7 +491,8 @@ void DatabaseEngine::Explain(const ExplainStatement &stmt, ResultWriter &writer)
   }
 
   if (enable_optimizer_) {
-    Optimizer optimizer(*catalog_, join_order_algorithm_);
+    Optimizer optimizer(*catalog_, *buffer_pool_, join_order_algorithm_, force_join_, work_mem_ * 1024,
+                                max_parallel_workers_);
     plan = optimizer.Optimize(plan);
   }
 
@@ -463,6 +515,17 @@ void DatabaseEngine::VariableSet(const Connection &connection, const VariableSet
     enable_optimizer_ = String2Bool(stmt.value_);
   } else if (stmt.variable_ == "deadlock") {
     lock_manager_->SetDeadLockType(String2DeadlockType(stmt.value_));
+  } else if (stmt.variable_ == "work_mem") {
+    work_mem_ = String2WorkMem(stmt.value_);
+  } else if (stmt.variable_ == "enable_runtime_filter") {
+    enable_runtime_filter_ = String2Bool(stmt.value_);
+  } else if (stmt.variable_ == "max_parallel_workers") {
+    max_parallel_workers_ = String2MaxParallelWorkers(stmt.value_);
+    if (max_parallel_workers_ > 0 && worker_pool_ == nullptr) {
+      worker_pool_ = std::make_unique<WorkerPool>(std::max(std::thread::hardware_concurrency(), 1U));
+    }
+  } else if (stmt.variable_ == "analyze_sample_size") {
+    analyze_sample_size_ = String2AnalyzeSampleSize(stmt.value_);
   }
   client_variables_[&connection][stmt.variable_] = stmt.value_;
   WriteOneCell("SET", writer);
@@ -510,7 +573,7 @@ void DatabaseEngine::Analyze(const AnalyzeStatement &stmt, ResultWriter &writer)
     if (!stmt.columns_.empty()) {
       for (const auto &column : stmt.columns_) {
         auto column_list = catalog_->GetTableColumnList(stmt.table_->table_);
-        auto col_idx = column_list.GetColumnIndex(column->col_name_[0]);
+        auto col_idx = column_list.GetColumnIndex(column->col_name_.back());
         auto col_type = column_list.GetColumn(col_idx).type_;
         auto col_name = column_list.GetColumn(col_idx).name_;
         auto col_size = column_list.GetColumn(col_idx).GetMaxSize();
@@ -522,7 +585,7 @@ void DatabaseEngine::Analyze(const AnalyzeStatement &stmt, ResultWriter &writer)
     auto oid = catalog_->GetTableOid(table_name);
     auto table = catalog_->GetTable(oid);
     if (stmt.columns_.empty()) {
-      auto column_list = catalog_->GetTableColumnList(stmt.table_->table_);
+      auto column_list = catalog_->GetTableColumnList(table_name);
       columns.clear();
       for (size_t i = 0; i < column_list.Length(); i++) {
         auto col_type = column_list.GetColumn(i).type_;
@@ -531,29 +594,152 @@ void DatabaseEngine::Analyze(const AnalyzeStatement &stmt, ResultWriter &writer)
         columns.emplace_back(i, col_type, col_name, col_size, true);
       }
     }
-    auto scan = std::make_unique<TableScan>(*buffer_pool_, table, Rid{table->GetFirstPageId(), 0});
-    uint32_t record_count = 0;
-    std::vector<std::unordered_set<Value>> value_set;
-    value_set.resize(columns.size());
-    while (auto record = scan->GetNextRecord()) {
-      for (size_t i = 0; i < columns.size(); i++) {
-        value_set[i].insert(record->GetValue(i));
-      }
-      record_count++;
+    std::vector<size_t> col_idxs;
+    for (const auto &column : columns) {
+      col_idxs.push_back(column.GetColumnIndex());
+    }
+    auto sample = SampleTable(table, col_idxs);
+    // 按读取的页面中平均每页的记录数推算全表的行数
+    double record_count = sample.row_count_;
+    if (sample.sampled_pages_ < sample.page_count_) {
+      record_count = std::round(sample.row_count_ / sample.sampled_pages_ * sample.page_count_);
     }
-    catalog_->SetCardinality(table_name, record_count);
+    catalog_->SetCardinality(table_name, static_cast<uint32_t>(record_count));
     for (size_t i = 0; i < columns.size(); i++) {
-      catalog_->SetDistinct(table_name, columns[i].name_, value_set[i].size());
+      auto sample_size = sample.values_[i].size();
+      auto statistics = ColumnStatistics::Build(std::move(sample.values_[i]), record_count);
+      if (sample.row_count_ > sample_size) {
+        // 读取了全部页面时 HyperLogLog 覆盖全表，否则只是读取的页面中的不同值个数，作为推算结果的下限
+        double distinct = sample.sketches_[i].Estimate();
+        if (sample.sampled_pages_ < sample.page_count_) {
+          distinct = std::max<double>(distinct, statistics.n_distinct_);
+        }
+        statistics.n_distinct_ = std::min(distinct, std::round(record_count * (1 - statistics.null_frac_)));
+      }
+      catalog_->SetColumnStatistics(table_name, columns[i].name_, statistics);
     }
   }
   WriteOneCell("Analyze", writer);
 }
 
+DatabaseEngine::TableSample DatabaseEngine::SampleTable(std::shared_ptr<Table> table,
+                                                       const std::vector<size_t> &col_idxs) {
+  TableSample sample;
+  sample.values_.resize(col_idxs.size());
+  sample.sketches_.resize(col_idxs.size());
+  sample.page_count_ = buffer_pool_->GetPageCount(table->GetDbOid(), table->GetOid());
+  // 固定随机种子，同一个表的抽样结果可以复现
+  std::mt19937_64 random(table->GetOid());
+  // Floyd 算法从全部页面中等概率选取 sampled_pages_ 个不同的页面，按页面号顺序读取
+  sample.sampled_pages_ = std::min<pageid_t>(sample.page_count_, analyze_sample_size_);
+  std::set<pageid_t> page_ids;
+  for (auto i = sample.page_count_ - sample.sampled_pages_; i < sample.page_count_; i++) {
+    auto page_id = std::uniform_int_distribution<pageid_t>(0, i)(random);
+    if (!page_ids.insert(page_id).second) {
+      page_ids.insert(i);
+    }
+  }
+  size_t row_count = 0;
+  for (auto page_id : page_ids) {
+    // 表扫描沿页面链表前进，读到其他页面的记录时说明当前页面已读完
+    TableScan scan(*buffer_pool_, table, Rid{page_id, 0});
+    while (auto record = scan.GetNextRecord()) {
+      if (record->GetRid().page_id_ != page_id) {
+        break;
+      }
+      row_count++;
+      for (size_t i = 0; i < col_idxs.size(); i++) {
+        const auto &value = record->GetValue(col_idxs[i]);
+        if (!value.IsNull()) {
+          sample.sketches_[i].Add(HashUtil::Hash(value));
+        }
+      }
+      // 蓄水池抽样：第 row_count 条记录以 sample_size / row_count 的概率替换样本中随机的一条
+      size_t slot = row_count - 1;
+      if (row_count > analyze_sample_size_) {
+        slot = std::uniform_int_distribution<size_t>(0, row_count - 1)(random);
+        if (slot >= analyze_sample_size_) {
+          continue;
+        }
+      }
+      for (size_t i = 0; i < col_idxs.size(); i++) {
+        auto value = record->GetValue(col_idxs[i]);
+        if (slot < sample.values_[i].size()) {
+          sample.values_[i][slot] = std::move(value);
+        } else {
+          sample.values_[i].push_back(std::move(value));
+        }
+      }
+    }
+  }
+  sample.row_count_ = row_count;
+  return sample;
+}
+
 void DatabaseEngine::Vacuum(const VacuumStatement &stmt, ResultWriter &writer) {
+  // 更新可见性映射并重新计算区域映射，未指定表时处理当前数据库的所有表
+  std::vector<std::shared_ptr<Table>> tables;
+  if (stmt.table_ != nullptr) {
+    tables.push_back(catalog_->GetTable(stmt.table_->oid_));
+  } else {
+    for (const auto &table_name : catalog_->GetTableNames()) {
+      tables.push_back(catalog_->GetTable(catalog_->GetTableOid(table_name)));
+    }
+  }
+  auto oldest_xmin = transaction_manager_->GetOldestXmin();
+  for (const auto &table : tables) {
+    UpdateVisibilityMap(*table, oldest_xmin);
+    RebuildZoneMap(*table);
+  }
   // LAB 1 ADVANCED BEGIN
   WriteOneCell("Vacuum", writer);
 }
 
+void DatabaseEngine::UpdateVisibilityMap(Table &table, xid_t oldest_xmin) {
+  // 页面中的记录都没有被删除或正在被删除，且插入记录的事务早于所有正在运行的事务的快照时，页面对所有事务都可见
+  auto all_visible = [&table, oldest_xmin](TablePage &table_page) {
+    for (slotid_t slot_id = 0; slot_id < table_page.GetRecordCount(); slot_id++) {
+      auto record = table_page.GetRecord(slot_id, table.GetColumnList());
+      if (record->IsDeleted() || record->GetXmax() != NULL_XID || record->GetXmin() >= oldest_xmin) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto &visibility_map = table.GetVisibilityMap();
+  auto page_id = table.GetFirstPageId();
+  while (page_id != NULL_PAGE_ID) {
+    auto table_page =
+        std::make_unique<TablePage>(buffer_pool_->GetPage(table.GetDbOid(), table.GetOid(), page_id));
+    if (all_visible(*table_page)) {
+      // 写者修改页面后才清除标记，在映射的锁内重新检查页面，避免覆盖检查期间的修改
+      visibility_map.SetAllVisible(page_id, [&] {
+        TablePage current_page(buffer_pool_->GetPage(table.GetDbOid(), table.GetOid(), page_id));
+        return all_visible(current_page);
+      });
+    } else {
+      visibility_map.ClearAllVisible(page_id);
+    }
+    page_id = table_page->GetNextPageId();
+  }
+}
+
+void DatabaseEngine::RebuildZoneMap(Table &table) {
+  // 已删除的记录可能对仍在运行的事务可见，同样计入摘要
+  auto &zone_map = table.GetZoneMap();
+  zone_map.Reset();
+  auto page_id = table.GetFirstPageId();
+  while (page_id != NULL_PAGE_ID) {
+    auto table_page =
+        std::make_unique<TablePage>(buffer_pool_->GetPage(table.GetDbOid(), table.GetOid(), page_id));
+    for (slotid_t slot_id = 0; slot_id < table_page->GetRecordCount(); slot_id++) {
+      auto record = table_page->GetRecord(slot_id, table.GetColumnList());
+      zone_map.Update(Rid{page_id, slot_id}, *record);
+    }
+    page_id = table_page->GetNextPageId();
+  }
+}
+
 void DatabaseEngine::WriteOneCell(const std::string &str, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -577,6 +763,8 @@ IsolationLevel DatabaseEngine::String2IsolationLevel(const std::string &str) {
 ForceJoin DatabaseEngine::String2ForceJoin(const std::string &str) {
   if (str == "none") {
     return ForceJoin::NONE;
+  } else if (str == "nestloop") {
+    return ForceJoin::NESTLOOP;
   } else if (str == "hash") {
     return ForceJoin::HASH;
   } else if (str == "merge") {
@@ -619,4 +807,47 @@ bool DatabaseEngine::String2Bool(const std::string &str) {
   throw DbException("Unknown boolean value " + str);
 }
 
+size_t DatabaseEngine::String2WorkMem(const std::string &str) {
+  // 单位为 KB
+  size_t pos = 0;
+  long long work_mem = 0;
+  try {
+    work_mem = std::stoll(str, &pos);
+  } catch (std::exception &) {
+    throw DbException("Invalid work_mem " + str);
+  }
+  if (pos != str.size() || work_mem <= 0) {
+    throw DbException("Invalid work_mem " + str);
+  }
+  return work_mem;
+}
+
+size_t DatabaseEngine::String2MaxParallelWorkers(const std::string &str) {
+  size_t pos = 0;
+  long long worker_count = 0;
+  try {
+    worker_count = std::stoll(str, &pos);
+  } catch (std::exception &) {
+    throw DbException("Invalid max_parallel_workers " + str);
+  }
+  if (pos != str.size() || worker_count < 0 || worker_count > static_cast<long long>(MAX_PARALLEL_WORKERS)) {
+    throw DbException("Invalid max_parallel_workers " + str);
+  }
+  return worker_count;
+}
+
+size_t DatabaseEngine::String2AnalyzeSampleSize(const std::string &str) {
+  size_t pos = 0;
+  long long sample_size = 0;
+  try {
+    sample_size = std::stoll(str, &pos);
+  } catch (std::exception &) {
+    throw DbException("Invalid analyze_sample_size " + str);
+  }
+  if (pos != str.size() || sample_size <= 0) {
+    throw DbException("Invalid analyze_sample_size " + str);
+  }
+  return sample_size;
+}
+
 }  // namespace huadb
@@ -7,7 +7,9 @@
 
 #include "catalog/catalog.h"
 #include "catalog/column_definition.h"
+#include "common/hyper_log_log.h"
 #include "common/typedefs.h"
+#include "common/worker_pool.h"
 #include "log/log_manager.h"
 #include "optimizer/optimizer.h"
 #include "planner/planner.h"
@@ -26,6 +28,8 @@ class VariableSetStatement;
 class VariableShowStatement;
 class AnalyzeStatement;
 class VacuumStatement;
+class CreateIndexStatement;
+class Table;
 
 class DatabaseEngine {
  public:
@@ -51,6 +55,9 @@ class DatabaseEngine {
   void ShowTables(ResultWriter &writer);
   void DropTable(const std::string &table_name, ResultWriter &writer);
 
+  void CreateIndex(xid_t xid, const CreateIndexStatement &stmt, ResultWriter &writer);
+  void DropIndex(const std::string &index_name, bool missing_ok, ResultWriter &writer);
+
   void Begin(Connection &connection);
   void Commit(Connection &connection);
   void Rollback(Connection &connection);
@@ -65,7 +72,24 @@ class DatabaseEngine {
   void VariableShow(const Connection &connection, const VariableShowStatement &stmt, ResultWriter &writer);
 
   void Analyze(const AnalyzeStatement &stmt, ResultWriter &writer);
+  // ANALYZE 对一个表的抽样结果
+  struct TableSample {
+    // 每列的样本，各列的第 i 个值来自同一条记录
+    std::vector<std::vector<Value>> values_;
+    // 每列在读取的页面中全部非空值的 HyperLogLog
+    std::vector<HyperLogLog> sketches_;
+    // 读取的页面中的记录数
+    double row_count_ = 0;
+    pageid_t sampled_pages_ = 0;
+    pageid_t page_count_ = 0;
+  };
+  // 随机选取最多 analyze_sample_size_ 个页面，对其中的记录做蓄水池抽样，保留最多 analyze_sample_size_ 条记录
+  TableSample SampleTable(std::shared_ptr<Table> table, const std::vector<size_t> &col_idxs);
   void Vacuum(const VacuumStatement &stmt, ResultWriter &writer);
+  // 将表中对所有事务都可见的页面标记到可见性映射中
+  void UpdateVisibilityMap(Table &table, xid_t oldest_xmin);
+  // 按页面顺序扫描表中的全部记录，重新计算区域映射
+  void RebuildZoneMap(Table &table);
 
   void WriteOneCell(const std::string &str, ResultWriter &writer);
 
@@ -74,6 +98,9 @@ class DatabaseEngine {
   static JoinOrderAlgorithm String2JoinOrderAlgorithm(const std::string &str);
   static DeadlockType String2DeadlockType(const std::string &str);
   static bool String2Bool(const std::string &str);
+  static size_t String2WorkMem(const std::string &str);
+  static size_t String2MaxParallelWorkers(const std::string &str);
+  static size_t String2AnalyzeSampleSize(const std::string &str);
 
   std::string current_db_;
 
@@ -83,6 +110,8 @@ class DatabaseEngine {
   std::unique_ptr<TransactionManager> transaction_manager_;
   std::unique_ptr<LogManager> log_manager_;
   std::unique_ptr<LockManager> lock_manager_;
+  // 首次设置 max_parallel_workers 时创建
+  std::unique_ptr<WorkerPool> worker_pool_;
 
   std::unordered_map<const Connection *, std::unordered_map<std::string, std::string>> client_variables_;
   std::unordered_map<Connection *, xid_t> xids_;
@@ -92,6 +121,10 @@ class DatabaseEngine {
   ForceJoin force_join_ = ForceJoin::NONE;
   JoinOrderAlgorithm join_order_algorithm_ = DEFAULT_JOIN_ORDER_ALGORITHM;
   bool enable_optimizer_ = true;
+  size_t work_mem_ = DEFAULT_WORK_MEM;
+  bool enable_runtime_filter_ = true;
+  size_t max_parallel_workers_ = DEFAULT_MAX_PARALLEL_WORKERS;
+  size_t analyze_sample_size_ = DEFAULT_ANALYZE_SAMPLE_SIZE;
 
   bool crashed_ = false;
 };
@@ -0,0 +1,164 @@
+#include "executors/aggregate_accumulator.h"
+
+#include <limits>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+AggregateAccumulator::AggregateAccumulator(AggregateType aggregate_type, Type input_type, bool is_distinct)
+    : aggregate_type_(aggregate_type),
+      input_type_(input_type),
+      // MIN/MAX 不受重复值影响
+      is_distinct_(is_distinct && aggregate_type != AggregateType::MIN && aggregate_type != AggregateType::MAX) {
+  if ((aggregate_type_ == AggregateType::SUM || aggregate_type_ == AggregateType::AVG) && input_type_ != Type::INT &&
+      input_type_ != Type::DOUBLE) {
+    throw DbException("Type unsupported for sum and avg");
+  }
+  if (is_distinct_ && !ValueSet::Supports(input_type_)) {
+    throw DbException("Type unsupported for distinct aggregate");
+  }
+}
+
+size_t AggregateAccumulator::Update(AggregateState &state, const Value &value) const {
+  if (aggregate_type_ == AggregateType::COUNT_STAR) {
+    state.count_++;
+    return 0;
+  }
+  if (value.IsNull()) {
+    return 0;
+  }
+  if (aggregate_type_ == AggregateType::APPROX_COUNT_DISTINCT) {
+    size_t size = 0;
+    if (state.hll_ == nullptr) {
+      state.hll_ = std::make_shared<HyperLogLog>();
+      size = state.hll_->MemorySize();
+    }
+    state.hll_->Add(HashUtil::Hash(value));
+    return size;
+  }
+  size_t size = 0;
+  if (is_distinct_) {
+    if (state.distinct_ == nullptr) {
+      state.distinct_ = std::make_shared<ValueSet>(input_type_);
+      size += sizeof(ValueSet);
+    }
+    if (!state.distinct_->Insert(value)) {
+      return size;
+    }
+    // 哈希表的装载因子不超过一半，按两倍估计
+    size += 2 * (TypeUtil::IsString(input_type_) ? sizeof(std::string) + value.GetSize() : sizeof(double));
+  }
+  state.count_++;
+  switch (aggregate_type_) {
+    case AggregateType::SUM:
+      if (input_type_ == Type::INT) {
+        state.int_sum_ += value.GetValue<int32_t>();
+      } else {
+        state.double_sum_ += value.GetValue<double>();
+      }
+      break;
+    case AggregateType::AVG:
+      state.double_sum_ += input_type_ == Type::INT ? value.GetValue<int32_t>() : value.GetValue<double>();
+      break;
+    case AggregateType::MIN:
+      if (state.count_ == 1 || value.Less(state.value_)) {
+        state.value_ = value;
+      }
+      break;
+    case AggregateType::MAX:
+      if (state.count_ == 1 || value.Greater(state.value_)) {
+        state.value_ = value;
+      }
+      break;
+    default:
+      break;
+  }
+  return size;
+}
+
+void AggregateAccumulator::Combine(AggregateState &state, const Value *partial) const {
+  if (is_distinct_) {
+    throw DbException("DISTINCT aggregate is not supported in partial aggregation");
+  }
+  switch (aggregate_type_) {
+    case AggregateType::COUNT_STAR:
+    case AggregateType::COUNT:
+      state.count_ += partial[0].GetValue<int32_t>();
+      break;
+    case AggregateType::AVG:
+      if (!partial[0].IsNull()) {
+        state.double_sum_ += partial[0].GetValue<double>();
+        state.count_ += partial[1].GetValue<int32_t>();
+      }
+      break;
+    case AggregateType::APPROX_COUNT_DISTINCT: {
+      if (state.hll_ == nullptr) {
+        state.hll_ = std::make_shared<HyperLogLog>();
+      }
+      state.hll_->Merge(HyperLogLog(partial[0].GetValue<std::string>()));
+      break;
+    }
+    default:
+      // SUM、MIN 和 MAX 的中间状态与最终结果相同
+      Update(state, partial[0]);
+      break;
+  }
+}
+
+void AggregateAccumulator::Partial(const AggregateState &state, std::vector<Value> &values) const {
+  if (is_distinct_) {
+    throw DbException("DISTINCT aggregate is not supported in partial aggregation");
+  }
+  if (aggregate_type_ == AggregateType::APPROX_COUNT_DISTINCT) {
+    // 寄存器序列化为字符串
+    values.emplace_back(state.hll_ == nullptr ? HyperLogLog().GetRegisters() : state.hll_->GetRegisters());
+    return;
+  }
+  if (aggregate_type_ == AggregateType::AVG) {
+    values.push_back(state.count_ == 0 ? Value(Type::DOUBLE, 0) : Value(state.double_sum_));
+    values.emplace_back(static_cast<int32_t>(state.count_));
+    return;
+  }
+  values.push_back(Finalize(state));
+}
+
+Value AggregateAccumulator::Finalize(const AggregateState &state) const {
+  switch (aggregate_type_) {
+    case AggregateType::COUNT_STAR:
+    case AggregateType::COUNT:
+      return Value(static_cast<int32_t>(state.count_));
+    case AggregateType::SUM:
+      if (state.count_ == 0) {
+        return Value(input_type_, 0);
+      }
+      if (input_type_ == Type::INT) {
+        // 没有更宽的整数类型，超出 INT 范围时报错
+        if (state.int_sum_ < std::numeric_limits<int32_t>::min() ||
+            state.int_sum_ > std::numeric_limits<int32_t>::max()) {
+          throw DbException("Integer out of range in SUM");
+        }
+        return Value(static_cast<int32_t>(state.int_sum_));
+      }
+      return Value(state.double_sum_);
+    case AggregateType::AVG:
+      if (state.count_ == 0) {
+        return Value(Type::DOUBLE, 0);
+      }
+      return Value(state.double_sum_ / state.count_);
+    case AggregateType::MIN:
+    case AggregateType::MAX:
+      if (state.count_ == 0) {
+        return Value(input_type_, 0);
+      }
+      return state.value_;
+    case AggregateType::APPROX_COUNT_DISTINCT:
+      return Value(static_cast<int32_t>(state.hll_ == nullptr ? 0 : state.hll_->Estimate()));
+    default:
+      throw DbException("Unknown aggregate type");
+  }
+}
+
+size_t AggregateAccumulator::PartialWidth() const { return aggregate_type_ == AggregateType::AVG ? 2 : 1; }
+
+}  // namespace huadb
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/hyper_log_log.h"
+#include "common/value.h"
+#include "common/value_set.h"
+#include "operators/aggregate_operator.h"
+
+namespace huadb {
+
+// 一个分组上一个聚集函数的中间状态
+struct AggregateState {
+  // 参与聚集的非空值个数，COUNT(*) 为行数
+  int64_t count_ = 0;
+  int64_t int_sum_ = 0;
+  double double_sum_ = 0;
+  // MIN/MAX 的当前结果
+  Value value_;
+  // DISTINCT 聚集已出现过的值
+  std::shared_ptr<ValueSet> distinct_;
+  // APPROX_COUNT_DISTINCT 的基数估计
+  std::shared_ptr<HyperLogLog> hll_;
+};
+
+// 聚集函数的实现，生成执行器时根据聚集类型和参数类型确定，执行时只更新 AggregateState
+// 部分聚集输出中间状态，最终聚集合并中间状态，用于两阶段聚集
+class AggregateAccumulator {
+ public:
+  AggregateAccumulator(AggregateType aggregate_type, Type input_type, bool is_distinct = false);
+
+  // 累加一个输入值，返回中间状态新占用的字节数
+  size_t Update(AggregateState &state, const Value &value) const;
+  // 合并部分聚集输出的中间状态，partial 指向 PartialWidth() 个值
+  void Combine(AggregateState &state, const Value *partial) const;
+  // 输出中间状态
+  void Partial(const AggregateState &state, std::vector<Value> &values) const;
+  Value Finalize(const AggregateState &state) const;
+  // 中间状态占用的列数，AVG 为和与个数两列，其余为一列
+  size_t PartialWidth() const;
+
+ private:
+  AggregateType aggregate_type_;
+  Type input_type_;
+  bool is_distinct_;
+};
+
+}  // namespace huadb
@@ -1,20 +1,210 @@
 #include "executors/aggregate_executor.h"
 
+#include "common/sort_key.h"
+#include "common/value_set.h"
+#include "executors/pipeline_executor.h"
+
 namespace huadb {
 
+// 溢出时按哈希值的 RADIX_BITS 位划分分区，每一轮使用不同的位
+static constexpr size_t RADIX_BITS = 4;
+static constexpr size_t PARTITION_COUNT = 1 << RADIX_BITS;
+// 超过该轮次后不再溢出，避免哈希冲突严重时无限划分
+static constexpr size_t MAX_SPILL_LEVEL = 4;
+static constexpr uint32_t INVALID_GROUP = UINT32_MAX;
+
 AggregateExecutor::AggregateExecutor(ExecutorContext &context, std::shared_ptr<const AggregateOperator> plan,
                                      std::shared_ptr<Executor> child)
     : Executor(context, {std::move(child)}), plan_(std::move(plan)) {
-  // LAB 4 ADVANCED BEGIN
+  group_count_ = plan_->group_bys_.size();
+  size_t offset = group_count_;
+  for (size_t i = 0; i < plan_->aggregates_.size(); i++) {
+    accumulators_.emplace_back(plan_->aggregate_types_[i], plan_->aggregates_[i]->GetValueType(),
+                               plan_->is_distincts_[i]);
+    input_offsets_.push_back(offset);
+    offset += plan_->mode_ == AggregateMode::FINAL ? accumulators_.back().PartialWidth() : 1;
+  }
 }
 
 void AggregateExecutor::Init() {
-  // LAB 4 ADVANCED BEGIN
+  children_[0]->Init();
+  tasks_.clear();
+  StartTask({nullptr, 0});
+  // 没有分组列时，即使输入为空也输出一行
+  if (group_count_ == 0 && keys_.empty()) {
+    FindGroup("", HashUtil::Hash(std::string()), {}, true);
+  }
 }
 
 std::shared_ptr<Record> AggregateExecutor::Next() {
-  // LAB 4 ADVANCED BEGIN
-  return nullptr;
+  while (true) {
+    if (output_index_ < keys_.size()) {
+      return OutputGroup(output_index_++);
+    }
+    if (tasks_.empty()) {
+      return nullptr;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    StartTask(std::move(task));
+  }
+}
+
+void AggregateExecutor::StartTask(AggregateTask task) {
+  current_task_ = std::move(task);
+  if (current_task_.file_ != nullptr) {
+    current_task_.file_->Rewind();
+  }
+  keys_.clear();
+  hashes_.clear();
+  group_values_.clear();
+  states_.clear();
+  slots_.assign(16, INVALID_GROUP);
+  memory_size_ = 0;
+  output_index_ = 0;
+  spilling_ = false;
+  spill_files_.clear();
+
+  std::vector<Value> values;
+  auto *pipeline =
+      current_task_.file_ == nullptr ? dynamic_cast<PipelineExecutor *>(children_[0].get()) : nullptr;
+  if (pipeline != nullptr) {
+    // 子执行器为流水线时聚集作为流水线的终点，由扫描推送的记录直接累加，不经过 Next
+    pipeline->Produce([this, &values](const std::shared_ptr<Record> &record) {
+      EvaluateInput(record, values);
+      Accumulate(values);
+    });
+  } else {
+    while (NextInput(values)) {
+      Accumulate(values);
+    }
+  }
+  // 溢出的分区作为新的任务，在当前分组输出完成后处理
+  for (auto &file : spill_files_) {
+    if (file != nullptr) {
+      tasks_.push_back({std::move(file), current_task_.level_ + 1});
+    }
+  }
+  spill_files_.clear();
+  // 输入已读完，释放当前任务的临时文件
+  current_task_.file_ = nullptr;
+}
+
+bool AggregateExecutor::NextInput(std::vector<Value> &values) {
+  if (current_task_.file_ != nullptr) {
+    return current_task_.file_->Read(values);
+  }
+  auto record = children_[0]->Next();
+  if (record == nullptr) {
+    return false;
+  }
+  EvaluateInput(record, values);
+  return true;
+}
+
+void AggregateExecutor::EvaluateInput(const std::shared_ptr<Record> &record, std::vector<Value> &values) const {
+  if (plan_->mode_ == AggregateMode::FINAL) {
+    values = record->GetValues();
+    return;
+  }
+  values.clear();
+  for (const auto &group_by : plan_->group_bys_) {
+    values.push_back(group_by->Evaluate(record));
+  }
+  for (const auto &aggregate : plan_->aggregates_) {
+    values.push_back(aggregate->Evaluate(record));
+  }
+}
+
+void AggregateExecutor::Accumulate(const std::vector<Value> &values) {
+  // 分组键使用排序键的编码，值相等的分组编码相同，NULL 与 NULL 属于同一分组
+  std::string key;
+  for (size_t i = 0; i < group_count_; i++) {
+    SortKey::Append(values[i], false, key);
+  }
+  auto hash = HashUtil::Hash(key);
+  auto group = FindGroup(key, hash, values, !spilling_);
+  if (group == INVALID_GROUP) {
+    auto shift = 64 - RADIX_BITS * (current_task_.level_ + 1);
+    auto &file = spill_files_[(hash >> shift) & (PARTITION_COUNT - 1)];
+    if (file == nullptr) {
+      file = std::make_shared<SpillFile>();
+    }
+    file->Append(values);
+    return;
+  }
+  auto *states = &states_[group * accumulators_.size()];
+  for (size_t i = 0; i < accumulators_.size(); i++) {
+    if (plan_->mode_ == AggregateMode::FINAL) {
+      accumulators_[i].Combine(states[i], &values[input_offsets_[i]]);
+    } else {
+      // DISTINCT 集合等中间状态的增长同样计入内存
+      memory_size_ += accumulators_[i].Update(states[i], values[input_offsets_[i]]);
+    }
+  }
+  CheckMemory();
+}
+
+uint32_t AggregateExecutor::FindGroup(const std::string &key, uint64_t hash, const std::vector<Value> &values,
+                                      bool insert) {
+  size_t mask = slots_.size() - 1;
+  auto pos = hash & mask;
+  for (; slots_[pos] != INVALID_GROUP; pos = (pos + 1) & mask) {
+    auto group = slots_[pos];
+    if (hashes_[group] == hash && keys_[group] == key) {
+      return group;
+    }
+  }
+  if (!insert) {
+    return INVALID_GROUP;
+  }
+  auto group = static_cast<uint32_t>(keys_.size());
+  slots_[pos] = group;
+  keys_.push_back(key);
+  hashes_.push_back(hash);
+  group_values_.insert(group_values_.end(), values.begin(), values.begin() + group_count_);
+  states_.resize(states_.size() + accumulators_.size());
+  memory_size_ += sizeof(std::string) + key.size() + sizeof(uint64_t) + sizeof(uint32_t) * 2 +
+                  sizeof(AggregateState) * accumulators_.size() +
+                  SpillFile::MemorySize({values.begin(), values.begin() + group_count_});
+  if (keys_.size() * 2 > slots_.size()) {
+    Grow();
+  }
+  return group;
+}
+
+void AggregateExecutor::CheckMemory() {
+  // 超出内存上限后，之后属于新分组的行溢出到临时文件，已有分组的状态仍在内存中更新
+  if (!spilling_ && memory_size_ > context_.GetWorkMem() && current_task_.level_ < MAX_SPILL_LEVEL) {
+    spilling_ = true;
+    spill_files_.resize(PARTITION_COUNT);
+  }
+}
+
+void AggregateExecutor::Grow() {
+  slots_.assign(slots_.size() * 2, INVALID_GROUP);
+  size_t mask = slots_.size() - 1;
+  for (uint32_t group = 0; group < keys_.size(); group++) {
+    auto pos = hashes_[group] & mask;
+    while (slots_[pos] != INVALID_GROUP) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos] = group;
+  }
+}
+
+std::shared_ptr<Record> AggregateExecutor::OutputGroup(uint32_t group) const {
+  std::vector<Value> values(group_values_.begin() + group * group_count_,
+                            group_values_.begin() + (group + 1) * group_count_);
+  const auto *states = &states_[group * accumulators_.size()];
+  for (size_t i = 0; i < accumulators_.size(); i++) {
+    if (plan_->mode_ == AggregateMode::PARTIAL) {
+      accumulators_[i].Partial(states[i], values);
+    } else {
+      values.push_back(accumulators_[i].Finalize(states[i]));
+    }
+  }
+  return std::make_shared<Record>(std::move(values));
 }
 
 }  // namespace huadb
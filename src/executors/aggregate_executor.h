@@ -1,10 +1,19 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executors/aggregate_accumulator.h"
 #include "executors/executor.h"
 #include "operators/aggregate_operator.h"
+#include "storage/spill_file.h"
 
 namespace huadb {
 
+// 哈希聚集，分组键规范化为字节串后保存在开放寻址哈希表中，各分组的聚集状态连续存放
+// 分组占用的内存超出 work_mem 后不再创建新分组，属于新分组的行按哈希值划分后写入临时文件，之后逐个分区重新聚集
 class AggregateExecutor : public Executor {
  public:
   AggregateExecutor(ExecutorContext &context, std::shared_ptr<const AggregateOperator> plan,
@@ -13,7 +22,44 @@ class AggregateExecutor : public Executor {
   std::shared_ptr<Record> Next() override;
 
  private:
+  // 一轮聚集的输入，第 0 轮来自子执行器，之后来自溢出分区的临时文件
+  struct AggregateTask {
+    std::shared_ptr<SpillFile> file_;
+    size_t level_;
+  };
+
+  void StartTask(AggregateTask task);
+  // 读取一行输入，依次为各分组列的值和各聚集函数的输入
+  bool NextInput(std::vector<Value> &values);
+  // 计算子执行器输出的一条记录对应的输入行
+  void EvaluateInput(const std::shared_ptr<Record> &record, std::vector<Value> &values) const;
+  void Accumulate(const std::vector<Value> &values);
+  // 查找分组，分组不存在且 insert 为 true 时创建新分组
+  uint32_t FindGroup(const std::string &key, uint64_t hash, const std::vector<Value> &values, bool insert);
+  void Grow();
+  void CheckMemory();
+  std::shared_ptr<Record> OutputGroup(uint32_t group) const;
+
   std::shared_ptr<const AggregateOperator> plan_;
+  std::vector<AggregateAccumulator> accumulators_;
+  // 各聚集函数的输入在输入行中的位置
+  std::vector<size_t> input_offsets_;
+  size_t group_count_;
+
+  std::deque<AggregateTask> tasks_;
+  AggregateTask current_task_;
+  std::vector<std::shared_ptr<SpillFile>> spill_files_;
+  bool spilling_ = false;
+
+  // 哈希表，第 i 个分组的分组列为 group_values_[i * group_count_ ...]，聚集状态为 states_[i * accumulators_.size() ...]
+  std::vector<std::string> keys_;
+  std::vector<uint64_t> hashes_;
+  std::vector<Value> group_values_;
+  std::vector<AggregateState> states_;
+  std::vector<uint32_t> slots_;
+  size_t memory_size_ = 0;
+  // 下一个输出的分组
+  uint32_t output_index_ = 0;
 };
 
 }  // namespace huadb
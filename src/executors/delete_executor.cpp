@@ -19,6 +19,8 @@ std::shared_ptr<Record> DeleteExecutor::Next() {
     // 获取正确的锁，加锁失败时抛出异常
     // LAB 3 BEGIN
     table_->DeleteRecord(record->GetRid(), context_.GetXid());
+    // 修改页面后清除可见性映射，VACUUM 设置标记前会重新检查页面
+    table_->GetVisibilityMap().ClearAllVisible(record->GetRid().page_id_);
     count++;
   }
   finished_ = true;
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <memory>
+
 #include "catalog/catalog.h"
+#include "common/constants.h"
+#include "common/worker_pool.h"
 #include "transaction/lock_manager.h"
 #include "transaction/transaction_manager.h"
 
 namespace huadb {
 
+class MorselSource;
+class SharedHashTables;
+
 class ExecutorContext {
  public:
   ExecutorContext(BufferPool &buffer_pool, Catalog &catalog, TransactionManager &transaction_manager,
                   LockManager &lock_manager, xid_t xid, IsolationLevel isolation_level, cid_t cid,
-                  bool is_modification_sql)
+                  bool is_modification_sql, size_t work_mem = DEFAULT_WORK_MEM,
+                  bool enable_runtime_filter = true, WorkerPool *worker_pool = nullptr)
       : buffer_pool_(buffer_pool),
         catalog_(catalog),
         transaction_manager_(transaction_manager),
@@ -18,7 +26,10 @@ class ExecutorContext {
         xid_(xid),
         isolation_level_(isolation_level),
         cid_(cid),
-        is_modification_sql_(is_modification_sql) {}
+        is_modification_sql_(is_modification_sql),
+        work_mem_(work_mem),
+        enable_runtime_filter_(enable_runtime_filter),
+        worker_pool_(worker_pool) {}
 
   BufferPool &GetBufferPool() const { return buffer_pool_; }
   Catalog &GetCatalog() const { return catalog_; }
@@ -28,6 +39,20 @@ class ExecutorContext {
   IsolationLevel GetIsolationLevel() const { return isolation_level_; }
   cid_t GetCid() const { return cid_; }
   bool IsModificationSql() const { return is_modification_sql_; }
+  // 内存上限（字节）
+  size_t GetWorkMem() const { return work_mem_ * 1024; }
+  // 哈希连接是否向探测侧下推运行时过滤器
+  bool EnableRuntimeFilter() const { return enable_runtime_filter_; }
+  // 执行 Gather 子计划的工作线程池，为空时子计划只由执行查询的线程执行
+  WorkerPool *GetWorkerPool() const { return worker_pool_; }
+  // Gather 为各份子计划复制上下文，并设置并行扫描共享的页面分发器
+  const std::shared_ptr<MorselSource> &GetMorselSource() const { return morsel_source_; }
+  void SetMorselSource(std::shared_ptr<MorselSource> morsel_source) { morsel_source_ = std::move(morsel_source); }
+  // 各份子计划中的哈希连接共享构建结果，为空时各自构建
+  const std::shared_ptr<SharedHashTables> &GetSharedHashTables() const { return shared_hash_tables_; }
+  void SetSharedHashTables(std::shared_ptr<SharedHashTables> shared_hash_tables) {
+    shared_hash_tables_ = std::move(shared_hash_tables);
+  }
 
  private:
   BufferPool &buffer_pool_;
@@ -38,6 +63,11 @@ class ExecutorContext {
   IsolationLevel isolation_level_;
   cid_t cid_;
   bool is_modification_sql_;
+  size_t work_mem_;
+  bool enable_runtime_filter_;
+  WorkerPool *worker_pool_;
+  std::shared_ptr<MorselSource> morsel_source_;
+  std::shared_ptr<SharedHashTables> shared_hash_tables_;
 };
 
 }  // namespace huadb
@@ -8,27 +8,42 @@
 #include "executors/executor_context.h"
 #include "executors/executor_factory.h"
 #include "executors/filter_executor.h"
+#include "executors/gather_executor.h"
 #include "executors/hash_join_executor.h"
+#include "executors/index_nested_loop_join_executor.h"
+#include "executors/index_scan_executor.h"
 #include "executors/insert_executor.h"
 #include "executors/limit_executor.h"
 #include "executors/lock_rows_executor.h"
 #include "executors/merge_join_executor.h"
 #include "executors/nested_loop_join_executor.h"
 #include "executors/orderby_executor.h"
+#include "executors/pipeline_executor.h"
 #include "executors/projection_executor.h"
+#include "executors/runtime_filter.h"
 #include "executors/seqscan_executor.h"
+#include "executors/stream_aggregate_executor.h"
+#include "executors/topn_executor.h"
 #include "executors/update_executor.h"
 #include "executors/values_executor.h"
+#include "operators/expressions/column_value.h"
 
 namespace huadb {
 
 class ExecutorFactory {
  public:
-  static std::unique_ptr<Executor> CreateExecutor(ExecutorContext &context, std::shared_ptr<const Operator> plan) {
+  // runtime_filters 为上层哈希连接下推到 plan 的运行时过滤器，只穿过不改变列值的流式算子和哈希连接的探测侧，
+  // 到达顺序扫描时生效，其余情况直接丢弃
+  static std::unique_ptr<Executor> CreateExecutor(ExecutorContext &context, std::shared_ptr<const Operator> plan,
+                                                  RuntimeFilterList runtime_filters = {}) {
     switch (plan->GetType()) {
       case OperatorType::SEQSCAN: {
         auto seqscan_operator = std::dynamic_pointer_cast<const SeqScanOperator>(plan);
-        return std::make_unique<SeqScanExecutor>(context, std::move(seqscan_operator));
+        return std::make_unique<SeqScanExecutor>(context, std::move(seqscan_operator), std::move(runtime_filters));
+      }
+      case OperatorType::INDEXSCAN: {
+        auto index_scan_operator = std::dynamic_pointer_cast<const IndexScanOperator>(plan);
+        return std::make_unique<IndexScanExecutor>(context, std::move(index_scan_operator));
       }
       case OperatorType::INSERT: {
         auto insert_operator = std::dynamic_pointer_cast<const InsertOperator>(plan);
@@ -47,7 +62,18 @@ class ExecutorFactory {
       }
       case OperatorType::PROJECTION: {
         auto projection_operator = std::dynamic_pointer_cast<const ProjectionOperator>(plan);
-        auto child = CreateExecutor(context, plan->GetChildren()[0]);
+        RuntimeFilterList child_filters;
+        for (auto &[col_idx, filter] : runtime_filters) {
+          const auto &expr = projection_operator->exprs_[col_idx];
+          if (expr->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
+            child_filters.emplace_back(std::dynamic_pointer_cast<ColumnValue>(expr)->GetColumnIndex(),
+                                       std::move(filter));
+          }
+        }
+        auto child = CreateExecutor(context, plan->GetChildren()[0], std::move(child_filters));
+        if (auto pipeline = Fuse(context, plan, child)) {
+          return pipeline;
+        }
         return std::make_unique<ProjectionExecutor>(context, std::move(projection_operator), std::move(child));
       }
       case OperatorType::VALUES: {
@@ -70,14 +96,45 @@ class ExecutorFactory {
       }
       case OperatorType::HASHJOIN: {
         auto hash_join_operator = std::dynamic_pointer_cast<const HashJoinOperator>(plan);
-        auto left = CreateExecutor(context, plan->GetChildren()[0]);
+        // 构建侧在 Init 时读完，只有探测侧可以使用运行时过滤器
+        auto left_column_count = plan->GetChildren()[0]->OutputColumns().Length();
+        RuntimeFilterList left_filters;
+        for (auto &[col_idx, filter] : runtime_filters) {
+          if (col_idx < left_column_count) {
+            left_filters.emplace_back(col_idx, std::move(filter));
+          }
+        }
+        // 探测侧未匹配的记录不需要输出时，由构建侧的连接键生成运行时过滤器
+        std::vector<std::shared_ptr<RuntimeFilter>> join_filters;
+        if (context.EnableRuntimeFilter() && (hash_join_operator->join_type_ == JoinType::INNER ||
+                                              hash_join_operator->join_type_ == JoinType::RIGHT ||
+                                              hash_join_operator->join_type_ == JoinType::SEMI)) {
+          for (const auto &key : hash_join_operator->left_keys_) {
+            std::shared_ptr<RuntimeFilter> filter;
+            if (key->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
+              filter = std::make_shared<RuntimeFilter>();
+              left_filters.emplace_back(std::dynamic_pointer_cast<ColumnValue>(key)->GetColumnIndex(), filter);
+            }
+            join_filters.push_back(std::move(filter));
+          }
+        }
+        auto left = CreateExecutor(context, plan->GetChildren()[0], std::move(left_filters));
         auto right = CreateExecutor(context, plan->GetChildren()[1]);
         return std::make_unique<HashJoinExecutor>(context, std::move(hash_join_operator), std::move(left),
-                                                  std::move(right));
+                                                  std::move(right), std::move(join_filters));
+      }
+      case OperatorType::INDEXNESTEDLOOP: {
+        // 内表由连接直接查找索引，不创建执行器
+        auto index_join_operator = std::dynamic_pointer_cast<const IndexNestedLoopJoinOperator>(plan);
+        auto left = CreateExecutor(context, plan->GetChildren()[0]);
+        return std::make_unique<IndexNestedLoopJoinExecutor>(context, std::move(index_join_operator), std::move(left));
       }
       case OperatorType::FILTER: {
         auto filter_operator = std::dynamic_pointer_cast<const FilterOperator>(plan);
-        auto child = CreateExecutor(context, plan->GetChildren()[0]);
+        auto child = CreateExecutor(context, plan->GetChildren()[0], std::move(runtime_filters));
+        if (auto pipeline = Fuse(context, plan, child)) {
+          return pipeline;
+        }
         return std::make_unique<FilterExecutor>(context, std::move(filter_operator), std::move(child));
       }
       case OperatorType::LIMIT: {
@@ -90,6 +147,11 @@ class ExecutorFactory {
         auto child = CreateExecutor(context, plan->GetChildren()[0]);
         return std::make_unique<OrderByExecutor>(context, std::move(orderby_operator), std::move(child));
       }
+      case OperatorType::TOPN: {
+        auto topn_operator = std::dynamic_pointer_cast<const TopNOperator>(plan);
+        auto child = CreateExecutor(context, plan->GetChildren()[0]);
+        return std::make_unique<TopNExecutor>(context, std::move(topn_operator), std::move(child));
+      }
       case OperatorType::LOCK_ROWS: {
         auto lock_rows_operator = std::dynamic_pointer_cast<const LockRowsOperator>(plan);
         auto child = CreateExecutor(context, plan->GetChildren()[0]);
@@ -98,12 +160,40 @@ class ExecutorFactory {
       case OperatorType::AGGREGATE: {
         auto aggregate_operator = std::dynamic_pointer_cast<const AggregateOperator>(plan);
         auto child = CreateExecutor(context, plan->GetChildren()[0]);
+        if (aggregate_operator->algorithm_ == AggregateAlgorithm::SORT) {
+          return std::make_unique<StreamAggregateExecutor>(context, std::move(aggregate_operator), std::move(child));
+        }
         return std::make_unique<AggregateExecutor>(context, std::move(aggregate_operator), std::move(child));
       }
+      case OperatorType::GATHER: {
+        // 运行时过滤器不是线程安全的，不下推到并行执行的子计划
+        auto gather_operator = std::dynamic_pointer_cast<const GatherOperator>(plan);
+        return std::make_unique<GatherExecutor>(context, std::move(gather_operator));
+      }
       default:
         throw DbException("Unknown operator type");
     }
   }
+
+ private:
+  // 过滤或投影的孩子为流水线或顺序扫描时，将其作为一个阶段融合进流水线，否则返回空
+  // 加锁的扫描不融合，避免批量读取时提前锁定上层用不到的记录
+  static std::unique_ptr<Executor> Fuse(ExecutorContext &context, const std::shared_ptr<const Operator> &plan,
+                                        std::unique_ptr<Executor> &child) {
+    if (auto *pipeline = dynamic_cast<PipelineExecutor *>(child.get())) {
+      pipeline->AddStage(plan);
+      return std::move(child);
+    }
+    const auto &child_plan = plan->GetChildren()[0];
+    if (child_plan->GetType() != OperatorType::SEQSCAN ||
+        std::dynamic_pointer_cast<const SeqScanOperator>(child_plan)->HasLock()) {
+      return nullptr;
+    }
+    auto source = std::shared_ptr<SeqScanExecutor>(static_cast<SeqScanExecutor *>(child.release()));
+    auto pipeline = std::make_unique<PipelineExecutor>(context, std::move(source));
+    pipeline->AddStage(plan);
+    return pipeline;
+  }
 };
 
 }  // namespace huadb
@@ -0,0 +1,147 @@
+#include "executors/gather_executor.h"
+
+#include "executors/executor_factory.h"
+#include "executors/morsel_source.h"
+#include "executors/shared_hash_table.h"
+
+namespace huadb {
+
+// 队列中最多缓存的记录数，队列满时 worker 等待 leader 取走记录
+static constexpr size_t GATHER_QUEUE_SIZE = 1024;
+
+// 找到子计划中标记为并行的顺序扫描，优化器只在连接的左侧路径上标记一个
+static std::shared_ptr<const SeqScanOperator> FindParallelScan(const std::shared_ptr<const Operator> &plan) {
+  if (plan->GetType() == OperatorType::SEQSCAN) {
+    auto seqscan = std::dynamic_pointer_cast<const SeqScanOperator>(plan);
+    return seqscan->parallel_ ? seqscan : nullptr;
+  }
+  for (const auto &child : plan->GetChildren()) {
+    if (auto seqscan = FindParallelScan(child)) {
+      return seqscan;
+    }
+  }
+  return nullptr;
+}
+
+GatherExecutor::GatherExecutor(ExecutorContext &context, std::shared_ptr<const GatherOperator> plan)
+    : Executor(context, {}), plan_(std::move(plan)) {}
+
+GatherExecutor::~GatherExecutor() { Shutdown(); }
+
+void GatherExecutor::Init() {
+  Shutdown();
+  state_ = std::make_shared<SharedState>();
+  state_->context_ = std::make_unique<ExecutorContext>(context_);
+  const auto &child = plan_->GetChildren()[0];
+  if (auto seqscan = FindParallelScan(child)) {
+    auto table = context_.GetCatalog().GetTable(seqscan->GetTableOid());
+    state_->context_->SetMorselSource(std::make_shared<MorselSource>(context_.GetBufferPool(), std::move(table)));
+  }
+  // 执行器在 leader 中创建，Init 和 Next 在 worker 线程中调用
+  auto *worker_pool = context_.GetWorkerPool();
+  size_t worker_count = worker_pool == nullptr ? 0 : plan_->worker_count_;
+  state_->context_->SetSharedHashTables(std::make_shared<SharedHashTables>(worker_count + 1));
+  for (size_t i = 0; i < worker_count; i++) {
+    state_->workers_.push_back(ExecutorFactory::CreateExecutor(*state_->context_, child));
+  }
+  state_->worker_states_.assign(worker_count, WorkerState::PENDING);
+  for (size_t i = 0; i < worker_count; i++) {
+    worker_pool->Submit([state = state_, i] { RunWorker(state, i); });
+  }
+  leader_ = ExecutorFactory::CreateExecutor(*state_->context_, child);
+  leader_->Init();
+  leader_done_ = false;
+}
+
+std::shared_ptr<Record> GatherExecutor::Next() {
+  while (true) {
+    {
+      std::unique_lock lock(state_->mutex_);
+      if (state_->error_ != nullptr) {
+        std::rethrow_exception(state_->error_);
+      }
+      if (!state_->queue_.empty()) {
+        auto record = std::move(state_->queue_.front());
+        state_->queue_.pop_front();
+        state_->producer_cv_.notify_one();
+        return record;
+      }
+      if (leader_done_) {
+        // 所有 morsel 都已被领取，尚未开始的 worker 即使执行也没有输入
+        SkipPendingWorkers(*state_);
+        if (state_->running_count_ == 0) {
+          return nullptr;
+        }
+        state_->consumer_cv_.wait(lock, [this] {
+          return !state_->queue_.empty() || state_->running_count_ == 0 || state_->error_ != nullptr;
+        });
+        continue;
+      }
+    }
+    if (auto record = leader_->Next()) {
+      return record;
+    }
+    leader_done_ = true;
+  }
+}
+
+void GatherExecutor::RunWorker(const std::shared_ptr<SharedState> &state, size_t worker_index) {
+  {
+    std::lock_guard lock(state->mutex_);
+    if (state->worker_states_[worker_index] != WorkerState::PENDING) {
+      return;
+    }
+    state->worker_states_[worker_index] = WorkerState::RUNNING;
+    state->running_count_++;
+  }
+  try {
+    auto &executor = state->workers_[worker_index];
+    executor->Init();
+    while (auto record = executor->Next()) {
+      std::unique_lock lock(state->mutex_);
+      state->producer_cv_.wait(lock, [&state] {
+        return state->cancelled_ || state->queue_.size() < GATHER_QUEUE_SIZE;
+      });
+      if (state->cancelled_) {
+        break;
+      }
+      state->queue_.push_back(std::move(record));
+      state->consumer_cv_.notify_one();
+    }
+  } catch (...) {
+    std::lock_guard lock(state->mutex_);
+    if (state->error_ == nullptr) {
+      state->error_ = std::current_exception();
+    }
+    state->cancelled_ = true;
+    state->producer_cv_.notify_all();
+  }
+  std::lock_guard lock(state->mutex_);
+  state->worker_states_[worker_index] = WorkerState::DONE;
+  state->running_count_--;
+  state->consumer_cv_.notify_all();
+}
+
+void GatherExecutor::SkipPendingWorkers(SharedState &state) {
+  for (auto &worker_state : state.worker_states_) {
+    if (worker_state == WorkerState::PENDING) {
+      worker_state = WorkerState::DONE;
+    }
+  }
+}
+
+void GatherExecutor::Shutdown() {
+  if (state_ == nullptr) {
+    return;
+  }
+  std::unique_lock lock(state_->mutex_);
+  state_->cancelled_ = true;
+  SkipPendingWorkers(*state_);
+  state_->producer_cv_.notify_all();
+  state_->consumer_cv_.wait(lock, [this] { return state_->running_count_ == 0; });
+  lock.unlock();
+  leader_ = nullptr;
+  state_ = nullptr;
+}
+
+}  // namespace huadb
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "executors/executor.h"
+#include "operators/gather_operator.h"
+
+namespace huadb {
+
+// 子计划复制为 worker_count_ + 1 份，worker 在工作线程池中执行各自的一份，将结果放入共享队列
+// 执行查询的线程（leader）优先从队列取结果，队列为空时执行自己的一份子计划
+// 线程池繁忙时 worker 可能迟迟不能开始，leader 的子计划读完全部 morsel 后，尚未开始的 worker 不再执行
+// 子计划中哈希连接的构建侧只由其中一份执行器构建一次，各份执行器共享只读的哈希表
+class GatherExecutor : public Executor {
+ public:
+  GatherExecutor(ExecutorContext &context, std::shared_ptr<const GatherOperator> plan);
+  ~GatherExecutor() override;
+
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+
+ private:
+  enum class WorkerState { PENDING, RUNNING, DONE };
+
+  // leader 与 worker 共享的状态，由 mutex_ 保护
+  struct SharedState {
+    std::mutex mutex_;
+    // 队列非空、worker 结束或出错时通知 leader
+    std::condition_variable consumer_cv_;
+    // 队列有空位或查询取消时通知 worker
+    std::condition_variable producer_cv_;
+    std::deque<std::shared_ptr<Record>> queue_;
+    std::vector<WorkerState> worker_states_;
+    size_t running_count_ = 0;
+    bool cancelled_ = false;
+    std::exception_ptr error_;
+    // worker 的上下文和执行器，worker 结束前保持有效
+    std::unique_ptr<ExecutorContext> context_;
+    std::vector<std::shared_ptr<Executor>> workers_;
+  };
+
+  static void RunWorker(const std::shared_ptr<SharedState> &state, size_t worker_index);
+  // 将尚未开始的 worker 标记为结束，调用时需持有锁
+  static void SkipPendingWorkers(SharedState &state);
+  // 取消执行并等待所有 worker 结束
+  void Shutdown();
+
+  std::shared_ptr<const GatherOperator> plan_;
+  std::shared_ptr<SharedState> state_;
+  std::shared_ptr<Executor> leader_;
+  bool leader_done_ = false;
+};
+
+}  // namespace huadb
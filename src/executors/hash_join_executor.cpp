@@ -1,20 +1,459 @@
 #include "executors/hash_join_executor.h"
 
+#include "common/value_set.h"
+
 namespace huadb {
 
+// 每轮按哈希值的 RADIX_BITS 位划分分区，每一轮使用不同的位
+static constexpr size_t RADIX_BITS = 4;
+static constexpr size_t PARTITION_COUNT = 1 << RADIX_BITS;
+// 超过该轮次后不再溢出，避免大量重复键时无限划分
+static constexpr size_t MAX_SPILL_LEVEL = 4;
+static constexpr uint32_t INVALID_ROW = UINT32_MAX;
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext &context, std::shared_ptr<const HashJoinOperator> plan,
-                                   std::shared_ptr<Executor> left, std::shared_ptr<Executor> right)
-    : Executor(context, {std::move(left), std::move(right)}), plan_(std::move(plan)) {}
+                                   std::shared_ptr<Executor> left, std::shared_ptr<Executor> right,
+                                   std::vector<std::shared_ptr<RuntimeFilter>> runtime_filters)
+    : Executor(context, {std::move(left), std::move(right)}),
+      plan_(std::move(plan)),
+      runtime_filters_(std::move(runtime_filters)) {}
 
 void HashJoinExecutor::Init() {
   children_[0]->Init();
   children_[1]->Init();
-  // LAB 4 ADVANCED BEGIN
+
+  key_count_ = plan_->left_keys_.size();
+  cast_to_double_.assign(key_count_, false);
+  for (size_t i = 0; i < key_count_; i++) {
+    auto left_type = plan_->left_keys_[i]->GetValueType();
+    auto right_type = plan_->right_keys_[i]->GetValueType();
+    if (left_type == right_type || (TypeUtil::IsString(left_type) && TypeUtil::IsString(right_type))) {
+      continue;
+    }
+    if ((left_type == Type::INT || left_type == Type::DOUBLE) &&
+        (right_type == Type::INT || right_type == Type::DOUBLE)) {
+      cast_to_double_[i] = true;
+      continue;
+    }
+    throw DbException("Type mismatch in hash join keys");
+  }
+  emit_unmatched_probe_ = plan_->join_type_ == JoinType::LEFT || plan_->join_type_ == JoinType::FULL ||
+                          plan_->join_type_ == JoinType::ANTI;
+  left_only_ = plan_->join_type_ == JoinType::SEMI || plan_->join_type_ == JoinType::ANTI;
+  emit_unmatched_build_ = plan_->join_type_ == JoinType::RIGHT || plan_->join_type_ == JoinType::FULL;
+  left_column_count_ = plan_->GetChildren()[0]->OutputColumns().Length();
+  right_column_count_ = plan_->GetChildren()[1]->OutputColumns().Length();
+
+  tasks_.clear();
+  // 右外连接和全外连接需要标记构建侧的记录是否被匹配，不共享构建结果
+  const auto &shared_hash_tables = context_.GetSharedHashTables();
+  shared_ = shared_hash_tables != nullptr && !emit_unmatched_build_ ? shared_hash_tables->Get(plan_.get()) : nullptr;
+  memory_limit_ = context_.GetWorkMem();
+  if (shared_ != nullptr) {
+    memory_limit_ *= shared_hash_tables->GetParticipantCount();
+  }
+  StartTask({nullptr, nullptr, 0});
 }
 
 std::shared_ptr<Record> HashJoinExecutor::Next() {
-  // LAB 4 ADVANCED BEGIN
-  return nullptr;
+  while (true) {
+    // 输出当前探测记录的下一条匹配记录
+    if (match_ != INVALID_ROW) {
+      auto &partition = (*partitions_)[probe_partition_];
+      auto row = match_;
+      match_ = partition.next_[row];
+      // 共享的哈希表只读，只有需要输出构建侧未匹配记录的连接才标记
+      if (emit_unmatched_build_) {
+        partition.matched_[row] = true;
+      }
+      return JoinRecords(probe_record_, partition.records_[row]);
+    }
+
+    if (!probe_done_) {
+      probe_record_ = NextProbeRecord();
+      if (probe_record_ == nullptr) {
+        probe_done_ = true;
+        unmatched_partition_ = 0;
+        unmatched_index_ = 0;
+        continue;
+      }
+      std::vector<Value> keys;
+      uint64_t hash;
+      if (!ComputeKeys(probe_record_, false, keys, hash)) {
+        // NOT IN 的左侧为 NULL 时，仅在子查询结果为空时成立
+        if (emit_unmatched_probe_ && !(plan_->null_aware_ && build_row_count_ > 0)) {
+          return JoinRecords(probe_record_, nullptr);
+        }
+        continue;
+      }
+      probe_partition_ = GetPartitionIndex(hash);
+      auto &partition = (*partitions_)[probe_partition_];
+      if (partition.spilled_) {
+        partition.probe_file_->Append(probe_record_->GetValues());
+        continue;
+      }
+      match_ = Lookup(partition, keys, hash);
+      // 半连接和反连接只需判断是否存在匹配，找到第一条匹配记录即停止
+      if (left_only_) {
+        bool matched = match_ != INVALID_ROW;
+        match_ = INVALID_ROW;
+        if (matched == (plan_->join_type_ == JoinType::SEMI)) {
+          return probe_record_;
+        }
+        continue;
+      }
+      if (match_ == INVALID_ROW && emit_unmatched_probe_) {
+        return JoinRecords(probe_record_, nullptr);
+      }
+      continue;
+    }
+
+    // 探测结束后输出构建侧未匹配的记录
+    if (emit_unmatched_build_) {
+      while (unmatched_partition_ < partitions_->size()) {
+        auto &partition = (*partitions_)[unmatched_partition_];
+        while (unmatched_index_ < partition.records_.size()) {
+          auto row = unmatched_index_++;
+          if (!partition.matched_[row]) {
+            return JoinRecords(nullptr, partition.records_[row]);
+          }
+        }
+        unmatched_partition_++;
+        unmatched_index_ = 0;
+      }
+      if (!null_key_records_.empty()) {
+        auto record = std::move(null_key_records_.back());
+        null_key_records_.pop_back();
+        return JoinRecords(nullptr, record);
+      }
+    }
+
+    // 本轮结束，溢出的分区作为新的任务逐个处理
+    for (auto &partition : *partitions_) {
+      if (!partition.spilled_) {
+        continue;
+      }
+      bool has_build = partition.build_file_->Size() > 0;
+      bool has_probe = partition.probe_file_->Size() > 0;
+      if ((has_build && has_probe) || (has_build && emit_unmatched_build_) || (has_probe && emit_unmatched_probe_)) {
+        tasks_.push_back({partition.build_file_, partition.probe_file_, current_task_.level_ + 1});
+      }
+    }
+    partitions_ = nullptr;
+    if (tasks_.empty()) {
+      return nullptr;
+    }
+    auto task = std::move(tasks_.front());
+    tasks_.pop_front();
+    StartTask(std::move(task));
+  }
+}
+
+void HashJoinExecutor::StartTask(JoinTask task) {
+  current_task_ = std::move(task);
+  if (current_task_.build_file_ != nullptr) {
+    current_task_.build_file_->Rewind();
+    current_task_.probe_file_->Rewind();
+  }
+  probe_done_ = false;
+  probe_record_ = nullptr;
+  match_ = INVALID_ROW;
+  Build();
+  // NOT IN 的子查询结果含有 NULL 时，任何记录都不满足条件
+  if (plan_->null_aware_ && build_has_null_) {
+    probe_done_ = true;
+  }
+}
+
+void HashJoinExecutor::Build() {
+  // 第 0 轮读取全部构建侧记录，据此生成运行时过滤器，之后各轮只处理其中的一部分
+  bool build_filters = current_task_.build_file_ == nullptr;
+  if (build_filters && shared_ != nullptr && AcquireSharedBuild()) {
+    return;
+  }
+  partitions_ = std::make_shared<std::vector<Partition>>(PARTITION_COUNT);
+  memory_size_ = 0;
+  null_key_records_.clear();
+  if (build_filters) {
+    build_row_count_ = 0;
+    build_has_null_ = false;
+    for (const auto &filter : runtime_filters_) {
+      if (filter != nullptr) {
+        filter->Reset();
+      }
+    }
+  }
+  try {
+    while (auto record = NextBuildRecord()) {
+      AddBuildRecord(std::move(record), build_filters);
+    }
+  } catch (...) {
+    // 构建出错时不能让等待的执行器一直阻塞
+    if (building_shared_) {
+      ReleaseSharedBuild(false);
+    }
+    throw;
+  }
+  if (build_filters) {
+    for (const auto &filter : runtime_filters_) {
+      if (filter != nullptr) {
+        filter->Finish();
+      }
+    }
+  }
+  for (auto &partition : *partitions_) {
+    if (!partition.spilled_) {
+      BuildHashTable(partition);
+    }
+  }
+  if (building_shared_) {
+    ReleaseSharedBuild(true);
+  }
+}
+
+bool HashJoinExecutor::AcquireSharedBuild() {
+  std::unique_lock lock(shared_->mutex_);
+  if (shared_->state_ == SharedHashTable::State::EMPTY) {
+    shared_->state_ = SharedHashTable::State::BUILDING;
+    building_shared_ = true;
+    return false;
+  }
+  shared_->cv_.wait(lock, [this] { return shared_->state_ != SharedHashTable::State::BUILDING; });
+  if (shared_->state_ == SharedHashTable::State::PRIVATE) {
+    lock.unlock();
+    shared_ = nullptr;
+    memory_limit_ = context_.GetWorkMem();
+    return false;
+  }
+  partitions_ = shared_->partitions_;
+  build_row_count_ = shared_->build_row_count_;
+  build_has_null_ = shared_->build_has_null_;
+  lock.unlock();
+  // 各份执行器有各自的运行时过滤器，由共享的连接键填充
+  for (size_t i = 0; i < runtime_filters_.size(); i++) {
+    const auto &filter = runtime_filters_[i];
+    if (filter == nullptr) {
+      continue;
+    }
+    filter->Reset();
+    for (const auto &partition : *partitions_) {
+      for (size_t row = 0; row < partition.records_.size(); row++) {
+        filter->Insert(partition.keys_[row * key_count_ + i]);
+      }
+    }
+    filter->Finish();
+  }
+  return true;
+}
+
+void HashJoinExecutor::ReleaseSharedBuild(bool ready) {
+  {
+    std::lock_guard lock(shared_->mutex_);
+    if (ready) {
+      shared_->state_ = SharedHashTable::State::READY;
+      shared_->partitions_ = partitions_;
+      shared_->build_row_count_ = build_row_count_;
+      shared_->build_has_null_ = build_has_null_;
+    } else {
+      shared_->state_ = SharedHashTable::State::PRIVATE;
+    }
+    shared_->cv_.notify_all();
+  }
+  building_shared_ = false;
+  if (!ready) {
+    shared_ = nullptr;
+    memory_limit_ = context_.GetWorkMem();
+  }
+}
+
+void HashJoinExecutor::AddBuildRecord(std::shared_ptr<Record> record, bool build_filters) {
+  std::vector<Value> keys;
+  uint64_t hash;
+  if (build_filters) {
+    build_row_count_++;
+  }
+  if (!ComputeKeys(record, true, keys, hash)) {
+    build_has_null_ = true;
+    if (emit_unmatched_build_) {
+      null_key_records_.push_back(std::move(record));
+    }
+    return;
+  }
+  if (build_filters) {
+    for (size_t i = 0; i < runtime_filters_.size(); i++) {
+      if (runtime_filters_[i] != nullptr) {
+        runtime_filters_[i]->Insert(keys[i]);
+      }
+    }
+  }
+  auto &partition = (*partitions_)[GetPartitionIndex(hash)];
+  if (partition.spilled_) {
+    partition.build_file_->Append(record->GetValues());
+    return;
+  }
+  auto size = SpillFile::MemorySize(record->GetValues()) + SpillFile::MemorySize(keys);
+  partition.records_.push_back(std::move(record));
+  partition.keys_.insert(partition.keys_.end(), keys.begin(), keys.end());
+  partition.hashes_.push_back(hash);
+  partition.memory_size_ += size;
+  memory_size_ += size;
+
+  // 超出内存上限时，依次溢出内存中最大的分区
+  if (current_task_.level_ >= MAX_SPILL_LEVEL) {
+    return;
+  }
+  if (memory_size_ > memory_limit_ && building_shared_) {
+    // 放弃共享，本执行器继续按自己的内存上限构建
+    ReleaseSharedBuild(false);
+  }
+  while (memory_size_ > memory_limit_) {
+    Partition *largest = nullptr;
+    for (auto &candidate : *partitions_) {
+      if (!candidate.spilled_ && (largest == nullptr || candidate.memory_size_ > largest->memory_size_)) {
+        largest = &candidate;
+      }
+    }
+    if (largest == nullptr) {
+      break;
+    }
+    SpillPartition(*largest);
+  }
+}
+
+void HashJoinExecutor::SpillPartition(Partition &partition) {
+  partition.build_file_ = std::make_shared<SpillFile>();
+  partition.probe_file_ = std::make_shared<SpillFile>();
+  for (const auto &record : partition.records_) {
+    partition.build_file_->Append(record->GetValues());
+  }
+  memory_size_ -= partition.memory_size_;
+  partition.memory_size_ = 0;
+  partition.spilled_ = true;
+  std::vector<std::shared_ptr<Record>>().swap(partition.records_);
+  std::vector<Value>().swap(partition.keys_);
+  std::vector<uint64_t>().swap(partition.hashes_);
+}
+
+void HashJoinExecutor::BuildHashTable(Partition &partition) {
+  auto count = partition.records_.size();
+  size_t capacity = 16;
+  while (capacity < count * 2) {
+    capacity *= 2;
+  }
+  size_t mask = capacity - 1;
+  partition.slots_.assign(capacity, INVALID_ROW);
+  partition.next_.assign(count, INVALID_ROW);
+  partition.matched_.assign(count, false);
+  // 逆序插入，使链表中记录的顺序与输入顺序一致
+  for (size_t i = count; i-- > 0;) {
+    auto row = static_cast<uint32_t>(i);
+    auto hash = partition.hashes_[row];
+    auto pos = hash & mask;
+    while (partition.slots_[pos] != INVALID_ROW) {
+      auto head = partition.slots_[pos];
+      if (partition.hashes_[head] == hash &&
+          KeysEqual(&partition.keys_[head * key_count_], &partition.keys_[row * key_count_])) {
+        break;
+      }
+      pos = (pos + 1) & mask;
+    }
+    partition.next_[row] = partition.slots_[pos];
+    partition.slots_[pos] = row;
+  }
+}
+
+std::shared_ptr<Record> HashJoinExecutor::NextBuildRecord() {
+  if (current_task_.build_file_ == nullptr) {
+    return children_[1]->Next();
+  }
+  std::vector<Value> values;
+  if (!current_task_.build_file_->Read(values)) {
+    return nullptr;
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+std::shared_ptr<Record> HashJoinExecutor::NextProbeRecord() {
+  if (current_task_.probe_file_ == nullptr) {
+    return children_[0]->Next();
+  }
+  std::vector<Value> values;
+  if (!current_task_.probe_file_->Read(values)) {
+    return nullptr;
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+bool HashJoinExecutor::ComputeKeys(const std::shared_ptr<Record> &record, bool is_build, std::vector<Value> &keys,
+                                   uint64_t &hash) const {
+  const auto &exprs = is_build ? plan_->right_keys_ : plan_->left_keys_;
+  keys.clear();
+  hash = 0;
+  for (size_t i = 0; i < key_count_; i++) {
+    auto key = exprs[i]->Evaluate(record);
+    if (key.IsNull()) {
+      return false;
+    }
+    if (cast_to_double_[i] && key.GetType() == Type::INT) {
+      key = Value(static_cast<double>(key.GetValue<int32_t>()));
+    }
+    hash = HashUtil::Combine(hash, HashUtil::Hash(key));
+    keys.push_back(std::move(key));
+  }
+  return true;
+}
+
+bool HashJoinExecutor::KeysEqual(const Value *lhs, const Value *rhs) const {
+  for (size_t i = 0; i < key_count_; i++) {
+    if (TypeUtil::IsString(lhs[i].GetType()) && TypeUtil::IsString(rhs[i].GetType())) {
+      if (lhs[i].GetValue<std::string>() != rhs[i].GetValue<std::string>()) {
+        return false;
+      }
+    } else if (!lhs[i].Equal(rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t HashJoinExecutor::GetPartitionIndex(uint64_t hash) const {
+  // 使用哈希值的高位划分分区，低位用于分区内的哈希表
+  auto shift = 64 - RADIX_BITS * (current_task_.level_ + 1);
+  return (hash >> shift) & (PARTITION_COUNT - 1);
+}
+
+uint32_t HashJoinExecutor::Lookup(const Partition &partition, const std::vector<Value> &keys, uint64_t hash) const {
+  if (partition.slots_.empty()) {
+    return INVALID_ROW;
+  }
+  size_t mask = partition.slots_.size() - 1;
+  for (auto pos = hash & mask; partition.slots_[pos] != INVALID_ROW; pos = (pos + 1) & mask) {
+    auto head = partition.slots_[pos];
+    if (partition.hashes_[head] == hash && KeysEqual(&partition.keys_[head * key_count_], keys.data())) {
+      return head;
+    }
+  }
+  return INVALID_ROW;
+}
+
+std::shared_ptr<Record> HashJoinExecutor::JoinRecords(const std::shared_ptr<Record> &left,
+                                                      const std::shared_ptr<Record> &right) const {
+  if (left_only_) {
+    return left;
+  }
+  std::vector<Value> values;
+  values.reserve(left_column_count_ + right_column_count_);
+  if (left != nullptr) {
+    values.insert(values.end(), left->GetValues().begin(), left->GetValues().end());
+  } else {
+    values.resize(left_column_count_);
+  }
+  if (right != nullptr) {
+    values.insert(values.end(), right->GetValues().begin(), right->GetValues().end());
+  } else {
+    values.resize(left_column_count_ + right_column_count_);
+  }
+  return std::make_shared<Record>(std::move(values));
 }
 
 }  // namespace huadb
@@ -1,22 +1,97 @@
 #pragma once
 
-#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <vector>
 
 #include "executors/executor.h"
+#include "executors/runtime_filter.h"
+#include "executors/shared_hash_table.h"
 #include "operators/hash_join_operator.h"
+#include "storage/spill_file.h"
 
 namespace huadb {
 
+// 基数分区的哈希连接，右孩子为构建侧，左孩子为探测侧
+// 构建侧超出内存上限时，按 Grace 哈希连接的方式将分区溢出到临时文件，之后逐个分区处理
+// runtime_filters[i] 不为空时，构建过程中将第 i 个连接键加入该运行时过滤器
+// 在 Gather 的子计划中时，各份执行器通过 SharedHashTable 共享同一次构建的结果
 class HashJoinExecutor : public Executor {
  public:
   HashJoinExecutor(ExecutorContext &context, std::shared_ptr<const HashJoinOperator> plan,
-                   std::shared_ptr<Executor> left, std::shared_ptr<Executor> right);
+                   std::shared_ptr<Executor> left, std::shared_ptr<Executor> right,
+                   std::vector<std::shared_ptr<RuntimeFilter>> runtime_filters = {});
 
   void Init() override;
   std::shared_ptr<Record> Next() override;
 
  private:
+  using Partition = HashJoinPartition;
+
+  // 一轮连接的输入，第 0 轮来自子执行器，之后来自溢出分区的临时文件
+  struct JoinTask {
+    std::shared_ptr<SpillFile> build_file_;
+    std::shared_ptr<SpillFile> probe_file_;
+    size_t level_;
+  };
+
+  void StartTask(JoinTask task);
+  void Build();
+  // 使用其他执行器共享的构建结果时返回 true，需要自己构建时返回 false
+  bool AcquireSharedBuild();
+  // 结束共享构建，ready 为 false 时放弃共享，其余执行器各自构建
+  void ReleaseSharedBuild(bool ready);
+  void AddBuildRecord(std::shared_ptr<Record> record, bool build_filters);
+  void SpillPartition(Partition &partition);
+  void BuildHashTable(Partition &partition);
+  std::shared_ptr<Record> NextBuildRecord();
+  std::shared_ptr<Record> NextProbeRecord();
+
+  // 计算连接键，键中含有 NULL 时返回 false
+  bool ComputeKeys(const std::shared_ptr<Record> &record, bool is_build, std::vector<Value> &keys,
+                   uint64_t &hash) const;
+  bool KeysEqual(const Value *lhs, const Value *rhs) const;
+  size_t GetPartitionIndex(uint64_t hash) const;
+  // 在分区中查找连接键，返回记录链表的表头下标
+  uint32_t Lookup(const Partition &partition, const std::vector<Value> &keys, uint64_t hash) const;
+
+  std::shared_ptr<Record> JoinRecords(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+
   std::shared_ptr<const HashJoinOperator> plan_;
+  std::vector<std::shared_ptr<RuntimeFilter>> runtime_filters_;
+  size_t key_count_;
+  // 连接键一侧为 INT、另一侧为 DOUBLE 时统一转换为 DOUBLE 比较
+  std::vector<bool> cast_to_double_;
+  bool emit_unmatched_probe_;
+  bool emit_unmatched_build_;
+  // 半连接和反连接只输出探测侧的记录
+  bool left_only_;
+  size_t left_column_count_;
+  size_t right_column_count_;
+
+  std::deque<JoinTask> tasks_;
+  JoinTask current_task_;
+  std::shared_ptr<std::vector<Partition>> partitions_;
+  size_t memory_size_ = 0;
+  // 内存上限，共享构建时为各份执行器的内存上限之和
+  size_t memory_limit_ = 0;
+  std::shared_ptr<SharedHashTable> shared_;
+  // 本执行器正在为其他执行器构建共享的哈希表
+  bool building_shared_ = false;
+  // 连接键含有 NULL 的构建侧记录，不会被匹配
+  std::vector<std::shared_ptr<Record>> null_key_records_;
+  // 第 0 轮统计的构建侧记录数，以及是否有连接键含 NULL 的记录，用于 NOT IN
+  size_t build_row_count_ = 0;
+  bool build_has_null_ = false;
+
+  // 探测状态
+  bool probe_done_ = true;
+  std::shared_ptr<Record> probe_record_;
+  size_t probe_partition_ = 0;
+  uint32_t match_;
+  // 输出构建侧未匹配记录的位置
+  size_t unmatched_partition_ = 0;
+  size_t unmatched_index_ = 0;
 };
 
 }  // namespace huadb
@@ -0,0 +1,204 @@
+#include "executors/index_nested_loop_join_executor.h"
+
+#include "common/sort_key.h"
+#include "operators/filter_operator.h"
+#include "operators/index_scan_operator.h"
+#include "operators/projection_operator.h"
+#include "storage/spill_file.h"
+
+namespace huadb {
+
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(ExecutorContext &context,
+                                                         std::shared_ptr<const IndexNestedLoopJoinOperator> plan,
+                                                         std::shared_ptr<Executor> left)
+    : Executor(context, {std::move(left)}), plan_(std::move(plan)) {}
+
+void IndexNestedLoopJoinExecutor::Init() {
+  children_[0]->Init();
+  const auto *inner = plan_->GetChildren()[1].get();
+  inner_exprs_.clear();
+  if (inner->GetType() == OperatorType::PROJECTION) {
+    inner_exprs_ = dynamic_cast<const ProjectionOperator &>(*inner).exprs_;
+    inner = inner->GetChildren()[0].get();
+  }
+  inner_predicate_ = nullptr;
+  if (inner->GetType() == OperatorType::FILTER) {
+    inner_predicate_ = dynamic_cast<const FilterOperator &>(*inner).predicate_;
+    inner = inner->GetChildren()[0].get();
+  }
+  const auto &index_scan = dynamic_cast<const IndexScanOperator &>(*inner);
+  table_ = context_.GetCatalog().GetTable(index_scan.GetTableOid());
+  index_ = context_.GetCatalog().GetIndex(index_scan.GetIndexOid());
+  auto &transaction_manager = context_.GetTransactionManager();
+  active_xids_ = context_.GetIsolationLevel() == IsolationLevel::READ_COMMITTED
+                     ? transaction_manager.GetActiveTransactions()
+                     : transaction_manager.GetSnapshot(context_.GetXid());
+  emit_unmatched_outer_ = plan_->join_type_ == JoinType::LEFT || plan_->join_type_ == JoinType::ANTI;
+  left_only_ = plan_->join_type_ == JoinType::SEMI || plan_->join_type_ == JoinType::ANTI;
+  left_column_count_ = plan_->GetChildren()[0]->OutputColumns().Length();
+  right_column_count_ = plan_->GetChildren()[1]->OutputColumns().Length();
+
+  batch_.clear();
+  batch_probes_.clear();
+  probes_.clear();
+  batch_index_ = 0;
+  match_index_ = 0;
+  outer_matched_ = false;
+}
+
+std::shared_ptr<Record> IndexNestedLoopJoinExecutor::Next() {
+  while (true) {
+    while (batch_index_ < batch_.size()) {
+      const auto &outer = batch_[batch_index_];
+      if (const auto *probe = batch_probes_[batch_index_]) {
+        size_t match_count = probe->cached_ ? probe->matches_.size() : probe->rids_.size();
+        while (match_index_ < match_count) {
+          auto inner = probe->cached_ ? probe->matches_[match_index_] : FetchInner(probe->rids_[match_index_]);
+          match_index_++;
+          if (inner == nullptr || !Matches(outer, inner)) {
+            continue;
+          }
+          outer_matched_ = true;
+          // 半连接和反连接找到一条匹配即可
+          if (left_only_) {
+            break;
+          }
+          return JoinRecords(outer, inner);
+        }
+      }
+      batch_index_++;
+      match_index_ = 0;
+      bool matched = outer_matched_;
+      outer_matched_ = false;
+      if (plan_->join_type_ == JoinType::SEMI ? matched : emit_unmatched_outer_ && !matched) {
+        return JoinRecords(outer, nullptr);
+      }
+    }
+    if (!LoadBatch()) {
+      return nullptr;
+    }
+  }
+}
+
+bool IndexNestedLoopJoinExecutor::LoadBatch() {
+  batch_.clear();
+  batch_probes_.clear();
+  probes_.clear();
+  batch_index_ = 0;
+  match_index_ = 0;
+  outer_matched_ = false;
+  std::vector<std::optional<std::string>> keys;
+  size_t memory_size = 0;
+  // 外表记录占用 work_mem 的一半，其余用于缓存内表记录；每批至少包含一条记录
+  while (batch_.empty() || memory_size <= context_.GetWorkMem() / 2) {
+    auto record = children_[0]->Next();
+    if (record == nullptr) {
+      break;
+    }
+    memory_size += SpillFile::MemorySize(record->GetValues());
+    // 连接键含有 NULL 的记录不会匹配，不查找索引
+    std::vector<Value> key_values;
+    std::string key;
+    for (size_t i = 0; i < plan_->probe_key_count_; i++) {
+      auto value = plan_->left_keys_[i]->Evaluate(record);
+      if (value.IsNull()) {
+        break;
+      }
+      SortKey::Append(value, false, key);
+      key_values.push_back(std::move(value));
+    }
+    if (key_values.size() == plan_->probe_key_count_) {
+      probes_.try_emplace(key, Probe{std::move(key_values)});
+      keys.emplace_back(std::move(key));
+    } else {
+      keys.emplace_back(std::nullopt);
+    }
+    batch_.push_back(std::move(record));
+  }
+  for (auto &[key, probe] : probes_) {
+    ProbeIndex(probe, memory_size);
+  }
+  for (const auto &key : keys) {
+    batch_probes_.push_back(key ? &probes_.at(*key) : nullptr);
+  }
+  return !batch_.empty();
+}
+
+void IndexNestedLoopJoinExecutor::ProbeIndex(Probe &probe, size_t &memory_size) {
+  IndexRange range;
+  range.equal_values_ = probe.key_values_;
+  probe.rids_ = index_->ScanRange(range);
+  // 超过 work_mem 后不再缓存内表记录，一个键的匹配记录要么全部缓存，要么全部在输出时回表
+  probe.cached_ = memory_size <= context_.GetWorkMem();
+  if (!probe.cached_) {
+    return;
+  }
+  for (const auto &rid : probe.rids_) {
+    auto record = FetchInner(rid);
+    if (record == nullptr) {
+      continue;
+    }
+    memory_size += SpillFile::MemorySize(record->GetValues());
+    if (memory_size > context_.GetWorkMem()) {
+      probe.cached_ = false;
+      probe.matches_ = {};
+      return;
+    }
+    probe.matches_.push_back(std::move(record));
+  }
+  probe.rids_ = {};
+}
+
+std::shared_ptr<Record> IndexNestedLoopJoinExecutor::FetchInner(const Rid &rid) const {
+  // 删除和更新时不删除旧版本的索引项，回表时跳过对当前事务不可见的版本
+  auto record =
+      table_->GetRecord(rid, context_.GetXid(), context_.GetIsolationLevel(), context_.GetCid(), active_xids_);
+  if (record == nullptr) {
+    return nullptr;
+  }
+  if (inner_predicate_ != nullptr) {
+    auto value = inner_predicate_->Evaluate(record);
+    if (value.IsNull() || !value.GetValue<bool>()) {
+      return nullptr;
+    }
+  }
+  if (!inner_exprs_.empty()) {
+    std::vector<Value> values;
+    values.reserve(inner_exprs_.size());
+    for (const auto &expr : inner_exprs_) {
+      values.push_back(expr->Evaluate(record));
+    }
+    record = std::make_shared<Record>(std::move(values));
+  }
+  return record;
+}
+
+bool IndexNestedLoopJoinExecutor::Matches(const std::shared_ptr<Record> &left,
+                                          const std::shared_ptr<Record> &right) const {
+  for (size_t i = plan_->probe_key_count_; i < plan_->left_keys_.size(); i++) {
+    auto left_value = plan_->left_keys_[i]->Evaluate(left);
+    auto right_value = plan_->right_keys_[i]->Evaluate(right);
+    if (left_value.IsNull() || right_value.IsNull() || !left_value.Equal(right_value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<Record> IndexNestedLoopJoinExecutor::JoinRecords(const std::shared_ptr<Record> &left,
+                                                                 const std::shared_ptr<Record> &right) const {
+  if (left_only_) {
+    return left;
+  }
+  std::vector<Value> values;
+  values.reserve(left_column_count_ + right_column_count_);
+  values.insert(values.end(), left->GetValues().begin(), left->GetValues().end());
+  if (right != nullptr) {
+    values.insert(values.end(), right->GetValues().begin(), right->GetValues().end());
+  } else {
+    values.resize(left_column_count_ + right_column_count_);
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+}  // namespace huadb
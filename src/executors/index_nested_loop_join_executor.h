@@ -0,0 +1,72 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
+#include "executors/executor.h"
+#include "index/index.h"
+#include "operators/index_nested_loop_join_operator.h"
+#include "table/table.h"
+
+namespace huadb {
+
+// 索引嵌套循环连接，左孩子为外表，右孩子描述内表上的索引、过滤条件和投影，只执行左孩子
+// 外表每次读入约 work_mem 一半的一批记录，连接键按索引顺序排序去重后依次在索引中查找，
+// 相同的键只查找一次，相邻的查找落在相同或相邻的叶结点上；输出仍按外表记录的顺序
+class IndexNestedLoopJoinExecutor : public Executor {
+ public:
+  IndexNestedLoopJoinExecutor(ExecutorContext &context, std::shared_ptr<const IndexNestedLoopJoinOperator> plan,
+                              std::shared_ptr<Executor> left);
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+
+ private:
+  // 一个连接键的查找结果
+  struct Probe {
+    std::vector<Value> key_values_;
+    // 本批的内存未超过 work_mem 时为 true，matches_ 缓存对当前事务可见且满足内表过滤条件的记录；
+    // 否则只保留索引项 rids_，输出时再逐条回表
+    bool cached_ = false;
+    std::vector<std::shared_ptr<Record>> matches_;
+    std::vector<Rid> rids_;
+  };
+
+  // 读取下一批外表记录并查找它们的连接键，外表读完时返回 false
+  bool LoadBatch();
+  // memory_size 为本批已占用的内存，缓存的内表记录计入其中
+  void ProbeIndex(Probe &probe, size_t &memory_size);
+  // 回表取出内表记录，不可见或不满足内表过滤条件时返回空
+  std::shared_ptr<Record> FetchInner(const Rid &rid) const;
+  // 比较不用于查找索引的其余连接键
+  bool Matches(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+  std::shared_ptr<Record> JoinRecords(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+
+  std::shared_ptr<const IndexNestedLoopJoinOperator> plan_;
+  std::shared_ptr<Table> table_;
+  std::shared_ptr<Index> index_;
+  // 内表上的过滤条件，没有时为空
+  std::shared_ptr<OperatorExpression> inner_predicate_;
+  // 内表上只选取列的投影，没有时为空
+  std::vector<std::shared_ptr<OperatorExpression>> inner_exprs_;
+  // 回表时判断可见性使用的活跃事务集合
+  std::unordered_set<xid_t> active_xids_;
+  bool emit_unmatched_outer_;
+  // 半连接和反连接只输出外表的记录
+  bool left_only_;
+  size_t left_column_count_;
+  size_t right_column_count_;
+
+  // 当前批的外表记录，及其连接键的查找结果，连接键含有 NULL 时为空
+  std::vector<std::shared_ptr<Record>> batch_;
+  std::vector<const Probe *> batch_probes_;
+  // 按编码后的连接键排序，编码的字节序与索引中键的顺序一致
+  std::map<std::string, Probe> probes_;
+  size_t batch_index_ = 0;
+  size_t match_index_ = 0;
+  bool outer_matched_ = false;
+};
+
+}  // namespace huadb
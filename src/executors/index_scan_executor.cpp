@@ -0,0 +1,58 @@
+#include "executors/index_scan_executor.h"
+
+namespace huadb {
+
+IndexScanExecutor::IndexScanExecutor(ExecutorContext &context, std::shared_ptr<const IndexScanOperator> plan)
+    : Executor(context, {}), plan_(std::move(plan)) {}
+
+void IndexScanExecutor::Init() {
+  table_ = context_.GetCatalog().GetTable(plan_->GetTableOid());
+  auto index = context_.GetCatalog().GetIndex(plan_->GetIndexOid());
+  entries_.clear();
+  if (plan_->index_only_) {
+    for (const auto &range : plan_->GetRanges()) {
+      auto entries = index->ScanEntries(range);
+      entries_.insert(entries_.end(), std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()));
+    }
+    value_columns_ = index->GetKeyColumns();
+    const auto &include_columns = index->GetIncludeColumns();
+    value_columns_.insert(value_columns_.end(), include_columns.begin(), include_columns.end());
+  } else {
+    for (const auto &range : plan_->GetRanges()) {
+      for (const auto &rid : index->ScanRange(range)) {
+        entries_.push_back({rid, {}});
+      }
+    }
+  }
+  position_ = 0;
+  auto &transaction_manager = context_.GetTransactionManager();
+  active_xids_ = context_.GetIsolationLevel() == IsolationLevel::READ_COMMITTED
+                     ? transaction_manager.GetActiveTransactions()
+                     : transaction_manager.GetSnapshot(context_.GetXid());
+}
+
+std::shared_ptr<Record> IndexScanExecutor::Next() {
+  while (position_ < entries_.size()) {
+    const auto &entry = entries_[position_++];
+    // 全部可见的页面上没有被删除的记录，索引项对应的记录一定存在，直接用索引项中的值构造记录
+    // 索引之外的列不会被上层算子用到，置为 NULL
+    if (plan_->index_only_ && table_->GetVisibilityMap().IsAllVisible(entry.rid_.page_id_)) {
+      std::vector<Value> values(table_->GetColumnList().Length());
+      for (size_t i = 0; i < value_columns_.size(); i++) {
+        values[value_columns_[i]] = entry.values_[i];
+      }
+      auto record = std::make_shared<Record>(std::move(values));
+      record->SetRid(entry.rid_);
+      return record;
+    }
+    // 删除和更新时不删除旧版本的索引项，回表时跳过对当前事务不可见的版本
+    auto record = table_->GetRecord(entry.rid_, context_.GetXid(), context_.GetIsolationLevel(), context_.GetCid(),
+                                    active_xids_);
+    if (record != nullptr) {
+      return record;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace huadb
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <unordered_set>
+
+#include "executors/executor.h"
+#include "operators/index_scan_operator.h"
+#include "table/table.h"
+
+namespace huadb {
+
+class IndexScanExecutor : public Executor {
+ public:
+  IndexScanExecutor(ExecutorContext &context, std::shared_ptr<const IndexScanOperator> plan);
+
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+
+ private:
+  std::shared_ptr<const IndexScanOperator> plan_;
+  std::shared_ptr<Table> table_;
+  // Init 时一次性取出范围内的全部索引项，避免扫描过程中插入的索引项被再次读到
+  // 仅索引扫描时索引项中带有键列和包含列的值，否则只有 rid
+  std::vector<IndexEntry> entries_;
+  // 索引项中各个值对应的表中列的下标
+  std::vector<size_t> value_columns_;
+  size_t position_ = 0;
+  // 回表时判断可见性使用的活跃事务集合
+  std::unordered_set<xid_t> active_xids_;
+};
+
+}  // namespace huadb
@@ -9,6 +9,7 @@ InsertExecutor::InsertExecutor(ExecutorContext &context, std::shared_ptr<const I
 void InsertExecutor::Init() {
   children_[0]->Init();
   table_ = context_.GetCatalog().GetTable(plan_->GetTableOid());
+  indexes_ = context_.GetCatalog().GetTableIndexes(plan_->GetTableOid());
   column_list_ = context_.GetCatalog().GetTableColumnList(plan_->GetTableOid());
 }
 
@@ -27,7 +28,13 @@ std::shared_ptr<Record> InsertExecutor::Next() {
     auto table_record = std::make_shared<Record>(std::move(values));
     // 获取正确的锁，加锁失败时抛出异常
     // LAB 3 BEGIN
-    auto rid = table_->InsertRecord(std::move(table_record), context_.GetXid(), context_.GetCid());
+    auto rid = table_->InsertRecord(table_record, context_.GetXid(), context_.GetCid());
+    // 先清除可见性映射再插入索引项，仅索引扫描读到新索引项时一定会回表
+    table_->GetVisibilityMap().ClearAllVisible(rid.page_id_);
+    table_->GetZoneMap().Update(rid, *table_record);
+    for (const auto &index : indexes_) {
+      index->InsertRecord(*table_record, rid);
+    }
     // 获取正确的锁，加锁失败时抛出异常
     // LAB 3 BEGIN
     count++;
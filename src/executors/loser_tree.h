@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace huadb {
+
+// 败者树，用于多路归并
+// less(i, j) 表示第 i 路的当前元素应排在第 j 路之前，已读完的路应视为最大
+// 两路元素相等时编号较小的路胜出，保证归并是稳定的
+template <typename Less>
+class LoserTree {
+ public:
+  LoserTree(size_t size, Less less) : size_(size), less_(std::move(less)), tree_(size, size) {
+    // 编号 size_ 表示初始化时使用的虚拟最小元素
+    for (size_t i = size; i-- > 0;) {
+      Adjust(i);
+    }
+  }
+
+  // 当前胜者所在的路
+  size_t Winner() const { return tree_[0]; }
+  // 胜者所在的路前进一个元素后，重新调整
+  void Replay() { Adjust(tree_[0]); }
+
+ private:
+  void Adjust(size_t leaf) {
+    auto winner = leaf;
+    for (auto node = (leaf + size_) / 2; node > 0; node /= 2) {
+      if (Beats(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+  bool Beats(size_t lhs, size_t rhs) {
+    if (lhs == size_ || rhs == size_) {
+      return lhs == size_;
+    }
+    if (less_(lhs, rhs)) {
+      return true;
+    }
+    return !less_(rhs, lhs) && lhs < rhs;
+  }
+
+  size_t size_;
+  Less less_;
+  // tree_[0] 为胜者，其余节点为对应比较的败者
+  std::vector<size_t> tree_;
+};
+
+}  // namespace huadb
@@ -1,5 +1,7 @@
 #include "executors/merge_join_executor.h"
 
+#include "common/sort_key.h"
+
 namespace huadb {
 
 MergeJoinExecutor::MergeJoinExecutor(ExecutorContext &context, std::shared_ptr<const MergeJoinOperator> plan,
@@ -9,11 +11,178 @@ MergeJoinExecutor::MergeJoinExecutor(ExecutorContext &context, std::shared_ptr<c
 void MergeJoinExecutor::Init() {
   children_[0]->Init();
   children_[1]->Init();
+
+  auto key_count = plan_->left_keys_.size();
+  cast_to_double_.assign(key_count, false);
+  for (size_t i = 0; i < key_count; i++) {
+    auto left_type = plan_->left_keys_[i]->GetValueType();
+    auto right_type = plan_->right_keys_[i]->GetValueType();
+    if (left_type == right_type || (TypeUtil::IsString(left_type) && TypeUtil::IsString(right_type))) {
+      continue;
+    }
+    if ((left_type == Type::INT || left_type == Type::DOUBLE) &&
+        (right_type == Type::INT || right_type == Type::DOUBLE)) {
+      cast_to_double_[i] = true;
+      continue;
+    }
+    throw DbException("Type mismatch in merge join keys");
+  }
+  emit_unmatched_left_ = plan_->join_type_ == JoinType::LEFT || plan_->join_type_ == JoinType::FULL ||
+                         plan_->join_type_ == JoinType::ANTI;
+  left_only_ = plan_->join_type_ == JoinType::SEMI || plan_->join_type_ == JoinType::ANTI;
+  emit_unmatched_right_ = plan_->join_type_ == JoinType::RIGHT || plan_->join_type_ == JoinType::FULL;
+  left_column_count_ = plan_->GetChildren()[0]->OutputColumns().Length();
+  right_column_count_ = plan_->GetChildren()[1]->OutputColumns().Length();
+
+  in_run_ = false;
+  run_records_.clear();
+  run_file_ = nullptr;
+  Advance(0, left_);
+  Advance(1, right_);
 }
 
 std::shared_ptr<Record> MergeJoinExecutor::Next() {
-  // LAB 4 BEGIN
-  return nullptr;
+  while (true) {
+    if (in_run_) {
+      // 当前左侧记录与 run 中的记录依次连接
+      if (auto right = NextRunRecord()) {
+        return JoinRecords(left_.record_, right);
+      }
+      Advance(0, left_);
+      if (left_.record_ != nullptr && !left_.has_null_ && left_.key_ == run_key_) {
+        RewindRun();
+        continue;
+      }
+      // run 中的右侧记录均已匹配
+      in_run_ = false;
+      run_records_.clear();
+      run_file_ = nullptr;
+    }
+
+    // 左侧读完后，右侧剩余的记录只在需要输出未匹配记录时处理
+    if (left_.record_ == nullptr && (right_.record_ == nullptr || !emit_unmatched_right_)) {
+      return nullptr;
+    }
+    // 连接键含有 NULL 或小于另一侧当前连接键的记录没有匹配
+    bool left_unmatched = left_.record_ != nullptr &&
+                          (left_.has_null_ || right_.record_ == nullptr ||
+                           (!right_.has_null_ && SortKey::Compare(left_.key_, right_.key_) < 0));
+    if (left_unmatched) {
+      auto record = std::move(left_.record_);
+      Advance(0, left_);
+      if (emit_unmatched_left_) {
+        return JoinRecords(record, nullptr);
+      }
+      continue;
+    }
+    bool right_unmatched = right_.record_ != nullptr &&
+                           (right_.has_null_ || left_.record_ == nullptr ||
+                            SortKey::Compare(right_.key_, left_.key_) < 0);
+    if (right_unmatched) {
+      auto record = std::move(right_.record_);
+      Advance(1, right_);
+      if (emit_unmatched_right_) {
+        return JoinRecords(nullptr, record);
+      }
+      continue;
+    }
+    if (left_only_) {
+      // 半连接和反连接不需要缓存 run，右侧保持不动，与连接键相同的后续左侧记录继续比较
+      auto record = std::move(left_.record_);
+      Advance(0, left_);
+      if (plan_->join_type_ == JoinType::SEMI) {
+        return record;
+      }
+      continue;
+    }
+    LoadRun();
+    in_run_ = true;
+  }
+}
+
+void MergeJoinExecutor::Advance(size_t child, Cursor &cursor) {
+  cursor.record_ = children_[child]->Next();
+  cursor.key_.clear();
+  cursor.has_null_ = false;
+  if (cursor.record_ == nullptr) {
+    return;
+  }
+  const auto &keys = child == 0 ? plan_->left_keys_ : plan_->right_keys_;
+  for (size_t i = 0; i < keys.size(); i++) {
+    auto key = keys[i]->Evaluate(cursor.record_);
+    if (key.IsNull()) {
+      cursor.has_null_ = true;
+      return;
+    }
+    if (cast_to_double_[i] && key.GetType() == Type::INT) {
+      key = Value(static_cast<double>(key.GetValue<int32_t>()));
+    }
+    SortKey::Append(key, false, cursor.key_);
+  }
+}
+
+void MergeJoinExecutor::LoadRun() {
+  run_key_ = right_.key_;
+  size_t memory_size = 0;
+  while (right_.record_ != nullptr && !right_.has_null_ && right_.key_ == run_key_) {
+    if (run_file_ != nullptr) {
+      run_file_->Append(right_.record_->GetValues());
+    } else {
+      memory_size += SpillFile::MemorySize(right_.record_->GetValues());
+      run_records_.push_back(std::move(right_.record_));
+      // 重复的连接键过多时，run 写入临时文件
+      if (memory_size > context_.GetWorkMem()) {
+        run_file_ = std::make_shared<SpillFile>();
+        for (const auto &record : run_records_) {
+          run_file_->Append(record->GetValues());
+        }
+        std::vector<std::shared_ptr<Record>>().swap(run_records_);
+      }
+    }
+    Advance(1, right_);
+  }
+  RewindRun();
+}
+
+void MergeJoinExecutor::RewindRun() {
+  run_index_ = 0;
+  if (run_file_ != nullptr) {
+    run_file_->Rewind();
+  }
+}
+
+std::shared_ptr<Record> MergeJoinExecutor::NextRunRecord() {
+  if (run_file_ == nullptr) {
+    if (run_index_ < run_records_.size()) {
+      return run_records_[run_index_++];
+    }
+    return nullptr;
+  }
+  std::vector<Value> values;
+  if (!run_file_->Read(values)) {
+    return nullptr;
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+std::shared_ptr<Record> MergeJoinExecutor::JoinRecords(const std::shared_ptr<Record> &left,
+                                                       const std::shared_ptr<Record> &right) const {
+  if (left_only_) {
+    return left;
+  }
+  std::vector<Value> values;
+  values.reserve(left_column_count_ + right_column_count_);
+  if (left != nullptr) {
+    values.insert(values.end(), left->GetValues().begin(), left->GetValues().end());
+  } else {
+    values.resize(left_column_count_);
+  }
+  if (right != nullptr) {
+    values.insert(values.end(), right->GetValues().begin(), right->GetValues().end());
+  } else {
+    values.resize(left_column_count_ + right_column_count_);
+  }
+  return std::make_shared<Record>(std::move(values));
 }
 
 }  // namespace huadb
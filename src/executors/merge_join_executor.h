@@ -1,10 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "executors/executor.h"
 #include "operators/merge_join_operator.h"
+#include "storage/spill_file.h"
 
 namespace huadb {
 
+// 归并连接，两侧输入均按连接键升序排列，连接键编码为可按字节比较的字节串
+// 右侧连接键相同的一段记录缓存在 run 中，与左侧连接键相同的每条记录依次连接，run 超出 work_mem 时写入临时文件
 class MergeJoinExecutor : public Executor {
  public:
   MergeJoinExecutor(ExecutorContext &context, std::shared_ptr<const MergeJoinOperator> plan,
@@ -13,7 +20,40 @@ class MergeJoinExecutor : public Executor {
   std::shared_ptr<Record> Next() override;
 
  private:
+  // 一侧输入的当前记录及其连接键
+  struct Cursor {
+    std::shared_ptr<Record> record_;
+    std::string key_;
+    // 连接键中含有 NULL，不与任何记录匹配
+    bool has_null_ = false;
+  };
+
+  void Advance(size_t child, Cursor &cursor);
+  // 读取右侧连接键与当前右侧记录相同的全部记录
+  void LoadRun();
+  void RewindRun();
+  std::shared_ptr<Record> NextRunRecord();
+  std::shared_ptr<Record> JoinRecords(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+
   std::shared_ptr<const MergeJoinOperator> plan_;
+  // 连接键一侧为 INT、另一侧为 DOUBLE 时统一转换为 DOUBLE 比较
+  std::vector<bool> cast_to_double_;
+  bool emit_unmatched_left_;
+  bool emit_unmatched_right_;
+  // 半连接和反连接只输出左侧的记录
+  bool left_only_;
+  size_t left_column_count_;
+  size_t right_column_count_;
+
+  Cursor left_;
+  Cursor right_;
+
+  // 与当前左侧记录连接的右侧记录
+  bool in_run_ = false;
+  std::string run_key_;
+  std::vector<std::shared_ptr<Record>> run_records_;
+  std::shared_ptr<SpillFile> run_file_;
+  size_t run_index_ = 0;
 };
 
 }  // namespace huadb
@@ -0,0 +1,28 @@
+#include "executors/morsel_source.h"
+
+#include "common/constants.h"
+#include "table/table_page.h"
+
+namespace huadb {
+
+// 每个 morsel 包含的页面数
+static constexpr size_t MORSEL_PAGES = 16;
+
+MorselSource::MorselSource(BufferPool &buffer_pool, std::shared_ptr<Table> table)
+    : buffer_pool_(buffer_pool), table_(std::move(table)), next_page_id_(table_->GetFirstPageId()) {}
+
+bool MorselSource::Next(std::vector<pageid_t> &page_ids) {
+  std::lock_guard lock(mutex_);
+  if (next_page_id_ == NULL_PAGE_ID) {
+    return false;
+  }
+  page_ids.clear();
+  while (page_ids.size() < MORSEL_PAGES && next_page_id_ != NULL_PAGE_ID) {
+    page_ids.push_back(next_page_id_);
+    TablePage table_page(buffer_pool_.GetPage(table_->GetDbOid(), table_->GetOid(), next_page_id_));
+    next_page_id_ = table_page.GetNextPageId();
+  }
+  return true;
+}
+
+}  // namespace huadb
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/typedefs.h"
+#include "storage/buffer_pool.h"
+#include "table/table.h"
+
+namespace huadb {
+
+// 并行扫描的页面分发器，沿表的页面链表依次划出若干连续页面（morsel），由各 worker 的扫描执行器领取
+class MorselSource {
+ public:
+  MorselSource(BufferPool &buffer_pool, std::shared_ptr<Table> table);
+
+  // 领取下一个 morsel，按页面链表的顺序输出其中的页面号，表扫描完时返回 false
+  bool Next(std::vector<pageid_t> &page_ids);
+
+ private:
+  BufferPool &buffer_pool_;
+  std::shared_ptr<Table> table_;
+  std::mutex mutex_;
+  pageid_t next_page_id_;
+};
+
+}  // namespace huadb
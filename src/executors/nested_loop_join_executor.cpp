@@ -10,14 +10,182 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext &context,
 void NestedLoopJoinExecutor::Init() {
   children_[0]->Init();
   children_[1]->Init();
+  emit_unmatched_outer_ = plan_->join_type_ == JoinType::LEFT || plan_->join_type_ == JoinType::FULL ||
+                          plan_->join_type_ == JoinType::ANTI;
+  left_only_ = plan_->join_type_ == JoinType::SEMI || plan_->join_type_ == JoinType::ANTI;
+  emit_unmatched_inner_ = plan_->join_type_ == JoinType::RIGHT || plan_->join_type_ == JoinType::FULL;
+  left_column_count_ = plan_->GetChildren()[0]->OutputColumns().Length();
+  right_column_count_ = plan_->GetChildren()[1]->OutputColumns().Length();
+
+  MaterializeInner();
+  if (LoadBlock()) {
+    RewindInner();
+    inner_record_ = NextInner();
+    state_ = JoinState::PROBE;
+  } else {
+    RewindInner();
+    state_ = JoinState::INNER_UNMATCHED;
+  }
 }
 
 std::shared_ptr<Record> NestedLoopJoinExecutor::Next() {
-  // 从 NestedLoopJoinOperator 中获取连接条件
-  // 使用 OperatorExpression 的 EvaluateJoin 函数判断是否满足 join 条件
-  // 使用 Record 的 Append 函数进行记录的连接
-  // LAB 4 BEGIN
-  return nullptr;
+  while (true) {
+    switch (state_) {
+      case JoinState::PROBE: {
+        while (inner_record_ != nullptr) {
+          while (block_index_ < block_.size()) {
+            auto index = block_index_++;
+            // 半连接和反连接中已匹配的外表记录不再比较
+            if (left_only_ && block_matched_[index]) {
+              continue;
+            }
+            if (Matches(block_[index], inner_record_)) {
+              block_matched_[index] = true;
+              inner_matched_[inner_index_ - 1] = true;
+              if (left_only_) {
+                block_match_count_++;
+                if (plan_->join_type_ == JoinType::SEMI) {
+                  return block_[index];
+                }
+                continue;
+              }
+              return JoinRecords(block_[index], inner_record_);
+            }
+          }
+          // 整块外表记录均已匹配时，不再扫描剩余的内表记录
+          if (left_only_ && block_match_count_ == block_.size()) {
+            break;
+          }
+          inner_record_ = NextInner();
+          block_index_ = 0;
+        }
+        state_ = JoinState::OUTER_UNMATCHED;
+        block_index_ = 0;
+        break;
+      }
+      case JoinState::OUTER_UNMATCHED: {
+        if (emit_unmatched_outer_) {
+          while (block_index_ < block_.size()) {
+            auto index = block_index_++;
+            if (!block_matched_[index]) {
+              return JoinRecords(block_[index], nullptr);
+            }
+          }
+        }
+        RewindInner();
+        if (LoadBlock()) {
+          inner_record_ = NextInner();
+          state_ = JoinState::PROBE;
+        } else {
+          state_ = JoinState::INNER_UNMATCHED;
+        }
+        break;
+      }
+      case JoinState::INNER_UNMATCHED: {
+        if (emit_unmatched_inner_) {
+          while (auto record = NextInner()) {
+            if (!inner_matched_[inner_index_ - 1]) {
+              return JoinRecords(nullptr, record);
+            }
+          }
+        }
+        state_ = JoinState::DONE;
+        break;
+      }
+      case JoinState::DONE:
+        return nullptr;
+    }
+  }
+}
+
+void NestedLoopJoinExecutor::MaterializeInner() {
+  inner_records_.clear();
+  inner_file_ = nullptr;
+  size_t memory_size = 0;
+  size_t count = 0;
+  while (auto record = children_[1]->Next()) {
+    count++;
+    if (inner_file_ != nullptr) {
+      inner_file_->Append(record->GetValues());
+      continue;
+    }
+    memory_size += SpillFile::MemorySize(record->GetValues());
+    inner_records_.push_back(std::move(record));
+    // 超出内存上限时，将内表全部写入临时文件
+    if (memory_size > context_.GetWorkMem()) {
+      inner_file_ = std::make_shared<SpillFile>();
+      for (const auto &inner_record : inner_records_) {
+        inner_file_->Append(inner_record->GetValues());
+      }
+      std::vector<std::shared_ptr<Record>>().swap(inner_records_);
+    }
+  }
+  inner_matched_.assign(count, false);
+}
+
+bool NestedLoopJoinExecutor::LoadBlock() {
+  block_.clear();
+  block_index_ = 0;
+  size_t memory_size = 0;
+  // 每块至少包含一条记录
+  while (block_.empty() || memory_size <= context_.GetWorkMem()) {
+    auto record = children_[0]->Next();
+    if (record == nullptr) {
+      break;
+    }
+    memory_size += SpillFile::MemorySize(record->GetValues());
+    block_.push_back(std::move(record));
+  }
+  block_matched_.assign(block_.size(), false);
+  block_match_count_ = 0;
+  return !block_.empty();
+}
+
+void NestedLoopJoinExecutor::RewindInner() {
+  inner_index_ = 0;
+  if (inner_file_ != nullptr) {
+    inner_file_->Rewind();
+  }
+}
+
+std::shared_ptr<Record> NestedLoopJoinExecutor::NextInner() {
+  if (inner_file_ == nullptr) {
+    if (inner_index_ < inner_records_.size()) {
+      return inner_records_[inner_index_++];
+    }
+    return nullptr;
+  }
+  std::vector<Value> values;
+  if (!inner_file_->Read(values)) {
+    return nullptr;
+  }
+  inner_index_++;
+  return std::make_shared<Record>(std::move(values));
+}
+
+bool NestedLoopJoinExecutor::Matches(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const {
+  auto value = plan_->join_condition_->EvaluateJoin(left, right);
+  return !value.IsNull() && value.GetValue<bool>();
+}
+
+std::shared_ptr<Record> NestedLoopJoinExecutor::JoinRecords(const std::shared_ptr<Record> &left,
+                                                            const std::shared_ptr<Record> &right) const {
+  if (left_only_) {
+    return left;
+  }
+  std::vector<Value> values;
+  values.reserve(left_column_count_ + right_column_count_);
+  if (left != nullptr) {
+    values.insert(values.end(), left->GetValues().begin(), left->GetValues().end());
+  } else {
+    values.resize(left_column_count_);
+  }
+  if (right != nullptr) {
+    values.insert(values.end(), right->GetValues().begin(), right->GetValues().end());
+  } else {
+    values.resize(left_column_count_ + right_column_count_);
+  }
+  return std::make_shared<Record>(std::move(values));
 }
 
 }  // namespace huadb
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "executors/executor.h"
 #include "operators/nested_loop_join_operator.h"
+#include "storage/spill_file.h"
 
 namespace huadb {
 
+// 块嵌套循环连接，右孩子为内表，左孩子为外表
+// 内表只读取一次并物化，超出 work_mem 时写入临时文件；外表每次读入不超过 work_mem 的一块记录，
+// 内表的每条记录与整块外表记录比较，内表的扫描次数由外表行数降为外表块数
 class NestedLoopJoinExecutor : public Executor {
  public:
   NestedLoopJoinExecutor(ExecutorContext &context, std::shared_ptr<const NestedLoopJoinOperator> plan,
@@ -13,7 +20,46 @@ class NestedLoopJoinExecutor : public Executor {
   std::shared_ptr<Record> Next() override;
 
  private:
+  enum class JoinState {
+    // 当前外表块与内表逐条比较
+    PROBE,
+    // 输出当前外表块中未匹配的记录
+    OUTER_UNMATCHED,
+    // 全部外表块处理完后，输出内表中未匹配的记录
+    INNER_UNMATCHED,
+    DONE,
+  };
+
+  void MaterializeInner();
+  // 读取下一块外表记录，外表读完时返回 false
+  bool LoadBlock();
+  void RewindInner();
+  std::shared_ptr<Record> NextInner();
+  bool Matches(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+  std::shared_ptr<Record> JoinRecords(const std::shared_ptr<Record> &left, const std::shared_ptr<Record> &right) const;
+
   std::shared_ptr<const NestedLoopJoinOperator> plan_;
+  bool emit_unmatched_outer_;
+  bool emit_unmatched_inner_;
+  // 半连接和反连接只输出外表的记录
+  bool left_only_;
+  size_t left_column_count_;
+  size_t right_column_count_;
+
+  // 内表记录保存在 inner_records_ 或 inner_file_ 中
+  std::vector<std::shared_ptr<Record>> inner_records_;
+  std::shared_ptr<SpillFile> inner_file_;
+  std::vector<bool> inner_matched_;
+  std::shared_ptr<Record> inner_record_;
+  // 下一条内表记录的编号
+  size_t inner_index_ = 0;
+
+  std::vector<std::shared_ptr<Record>> block_;
+  std::vector<bool> block_matched_;
+  size_t block_match_count_ = 0;
+  size_t block_index_ = 0;
+
+  JoinState state_;
 };
 
 }  // namespace huadb
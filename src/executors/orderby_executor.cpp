@@ -1,19 +1,160 @@
 #include "executors/orderby_executor.h"
 
+#include <algorithm>
+
+#include "common/sort_key.h"
+
 namespace huadb {
 
+// 一次归并的最大路数
+static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
 OrderByExecutor::OrderByExecutor(ExecutorContext &context, std::shared_ptr<const OrderByOperator> plan,
                                  std::shared_ptr<Executor> child)
     : Executor(context, {std::move(child)}), plan_(std::move(plan)) {}
 
-void OrderByExecutor::Init() { children_[0]->Init(); }
+void OrderByExecutor::Init() {
+  children_[0]->Init();
+  entries_.clear();
+  index_ = 0;
+  memory_size_ = 0;
+  runs_.clear();
+  tree_ = nullptr;
+
+  while (auto record = children_[0]->Next()) {
+    auto key = MakeSortKey(record);
+    memory_size_ += sizeof(SortEntry) + key.size() + SpillFile::MemorySize(record->GetValues());
+    entries_.push_back({std::move(key), std::move(record)});
+    if (memory_size_ > context_.GetWorkMem()) {
+      SpillRun();
+    }
+  }
+  SortEntries(entries_);
+  if (runs_.empty()) {
+    return;
+  }
+  // 最后一个归并段留在内存中
+  if (!entries_.empty()) {
+    SortedRun run;
+    run.entries_ = std::move(entries_);
+    runs_.push_back(std::move(run));
+    entries_.clear();
+  }
+  ReduceRuns();
+  for (auto &run : runs_) {
+    Advance(run);
+  }
+  tree_ = MakeTree(runs_);
+}
 
 std::shared_ptr<Record> OrderByExecutor::Next() {
-  // 可以使用 STL 的 sort 函数
-  // 通过 OperatorExpression 的 Evaluate 函数获取 Value 的值
-  // 通过 Value 的 Less, Equal, Greater 函数比较 Value 的值
-  // LAB 4 BEGIN
-  return children_[0]->Next();
+  if (tree_ == nullptr) {
+    if (index_ < entries_.size()) {
+      return std::move(entries_[index_++].record_);
+    }
+    return nullptr;
+  }
+  auto &run = runs_[tree_->Winner()];
+  if (run.exhausted_) {
+    return nullptr;
+  }
+  auto record = std::move(run.head_.record_);
+  Advance(run);
+  tree_->Replay();
+  return record;
+}
+
+std::string OrderByExecutor::MakeSortKey(const std::shared_ptr<Record> &record) const {
+  std::string key;
+  for (const auto &[order_by_type, expr] : plan_->order_bys_) {
+    SortKey::Append(expr->Evaluate(record), order_by_type == OrderByType::DESC, key);
+  }
+  return key;
+}
+
+void OrderByExecutor::SortEntries(std::vector<SortEntry> &entries) {
+  // 稳定排序，排序键相同的记录保持输入顺序
+  std::stable_sort(entries.begin(), entries.end(), [](const SortEntry &lhs, const SortEntry &rhs) {
+    return SortKey::Compare(lhs.key_, rhs.key_) < 0;
+  });
+}
+
+void OrderByExecutor::SpillRun() {
+  SortEntries(entries_);
+  SortedRun run;
+  run.file_ = std::make_shared<SpillFile>();
+  // 每行的第一列为排序键，其后为记录的各列
+  std::vector<Value> values;
+  for (auto &entry : entries_) {
+    values.clear();
+    values.emplace_back(std::move(entry.key_));
+    values.insert(values.end(), entry.record_->GetValues().begin(), entry.record_->GetValues().end());
+    run.file_->Append(values);
+  }
+  run.file_->Rewind();
+  runs_.push_back(std::move(run));
+  std::vector<SortEntry>().swap(entries_);
+  memory_size_ = 0;
+}
+
+void OrderByExecutor::Advance(SortedRun &run) {
+  if (run.file_ == nullptr) {
+    if (run.index_ < run.entries_.size()) {
+      run.head_ = std::move(run.entries_[run.index_++]);
+    } else {
+      run.head_ = {};
+      run.exhausted_ = true;
+    }
+    return;
+  }
+  std::vector<Value> values;
+  if (!run.file_->Read(values)) {
+    run.head_ = {};
+    run.exhausted_ = true;
+    return;
+  }
+  run.head_.key_ = values[0].GetValue<std::string>();
+  values.erase(values.begin());
+  run.head_.record_ = std::make_shared<Record>(std::move(values));
+}
+
+std::unique_ptr<OrderByExecutor::RunTree> OrderByExecutor::MakeTree(std::vector<SortedRun> &runs) {
+  return std::make_unique<RunTree>(runs.size(), [&runs](size_t lhs, size_t rhs) {
+    if (runs[lhs].exhausted_ || runs[rhs].exhausted_) {
+      return !runs[lhs].exhausted_;
+    }
+    return SortKey::Compare(runs[lhs].head_.key_, runs[rhs].head_.key_) < 0;
+  });
+}
+
+void OrderByExecutor::ReduceRuns() {
+  while (runs_.size() > MAX_MERGE_FAN_IN) {
+    std::vector<SortedRun> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += MAX_MERGE_FAN_IN) {
+      auto end = std::min(begin + MAX_MERGE_FAN_IN, runs_.size());
+      std::vector<SortedRun> group(std::make_move_iterator(runs_.begin() + begin),
+                                   std::make_move_iterator(runs_.begin() + end));
+      for (auto &run : group) {
+        Advance(run);
+      }
+      SortedRun merged;
+      merged.file_ = std::make_shared<SpillFile>();
+      auto tree = MakeTree(group);
+      std::vector<Value> values;
+      while (!group[tree->Winner()].exhausted_) {
+        auto &run = group[tree->Winner()];
+        values.clear();
+        values.emplace_back(std::move(run.head_.key_));
+        values.insert(values.end(), run.head_.record_->GetValues().begin(), run.head_.record_->GetValues().end());
+        merged.file_->Append(values);
+        Advance(run);
+        tree->Replay();
+      }
+      merged.file_->Rewind();
+      merged_runs.push_back(std::move(merged));
+    }
+    runs_ = std::move(merged_runs);
+  }
 }
 
 }  // namespace huadb
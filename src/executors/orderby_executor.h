@@ -1,10 +1,19 @@
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "executors/executor.h"
+#include "executors/loser_tree.h"
 #include "operators/orderby_operator.h"
+#include "storage/spill_file.h"
 
 namespace huadb {
 
+// 外部归并排序，内存中的数据超出 work_mem 时排序后作为一个归并段写入临时文件，最后使用败者树多路归并
+// 排序键编码为可直接按字节比较的字节串
 class OrderByExecutor : public Executor {
  public:
   OrderByExecutor(ExecutorContext &context, std::shared_ptr<const OrderByOperator> plan,
@@ -13,7 +22,38 @@ class OrderByExecutor : public Executor {
   std::shared_ptr<Record> Next() override;
 
  private:
+  struct SortEntry {
+    std::string key_;
+    std::shared_ptr<Record> record_;
+  };
+
+  // 已排序的归并段，保存在临时文件或内存中
+  struct SortedRun {
+    std::shared_ptr<SpillFile> file_;
+    std::vector<SortEntry> entries_;
+    size_t index_ = 0;
+    // 归并段的当前元素
+    SortEntry head_;
+    bool exhausted_ = false;
+  };
+
+  using RunTree = LoserTree<std::function<bool(size_t, size_t)>>;
+
+  std::string MakeSortKey(const std::shared_ptr<Record> &record) const;
+  static void SortEntries(std::vector<SortEntry> &entries);
+  void SpillRun();
+  // 读取归并段的下一个元素
+  static void Advance(SortedRun &run);
+  static std::unique_ptr<RunTree> MakeTree(std::vector<SortedRun> &runs);
+  // 归并段过多时，每次将相邻的若干个归并段合并为一个，直至可以一次归并完成
+  void ReduceRuns();
+
   std::shared_ptr<const OrderByOperator> plan_;
+  std::vector<SortEntry> entries_;
+  size_t index_ = 0;
+  size_t memory_size_ = 0;
+  std::vector<SortedRun> runs_;
+  std::unique_ptr<RunTree> tree_;
 };
 
 }  // namespace huadb
@@ -0,0 +1,76 @@
+#include "executors/pipeline_executor.h"
+
+#include <algorithm>
+
+#include "common/exceptions.h"
+#include "operators/filter_operator.h"
+#include "operators/projection_operator.h"
+
+namespace huadb {
+
+PipelineExecutor::PipelineExecutor(ExecutorContext &context, std::shared_ptr<SeqScanExecutor> source)
+    : Executor(context, {source}), source_(source.get()) {}
+
+void PipelineExecutor::AddStage(std::shared_ptr<const Operator> stage) {
+  if (stage->GetType() == OperatorType::FILTER) {
+    stages_.push_back({std::dynamic_pointer_cast<const FilterOperator>(stage)->predicate_, {}, nullptr});
+  } else if (stage->GetType() == OperatorType::PROJECTION) {
+    const auto &exprs = std::dynamic_pointer_cast<const ProjectionOperator>(stage)->exprs_;
+    stages_.push_back({nullptr, exprs, std::make_shared<Record>(std::vector<Value>(exprs.size()))});
+  } else {
+    throw DbException("Only filter and projection can be fused into a pipeline");
+  }
+}
+
+void PipelineExecutor::Init() {
+  children_[0]->Init();
+  output_.clear();
+  output_index_ = 0;
+  // 复用的输出记录在下一行到来时被覆盖，任一阶段为投影时输出的都是复用的记录，缓冲时需要复制
+  bool copy = std::any_of(stages_.begin(), stages_.end(), [](const Stage &stage) { return stage.predicate_ == nullptr; });
+  buffer_ = [this, copy](const std::shared_ptr<Record> &record) {
+    output_.push_back(copy ? std::make_shared<Record>(record->GetValues(), record->GetRid()) : record);
+  };
+}
+
+std::shared_ptr<Record> PipelineExecutor::Next() {
+  // 一个页面的记录可能全部被过滤，此时继续推送下一个页面
+  while (output_index_ == output_.size()) {
+    output_.clear();
+    output_index_ = 0;
+    if (!ProducePage(buffer_)) {
+      return nullptr;
+    }
+  }
+  return std::move(output_[output_index_++]);
+}
+
+void PipelineExecutor::Produce(const RecordConsumer &consumer) {
+  while (ProducePage(consumer)) {
+  }
+}
+
+bool PipelineExecutor::ProducePage(const RecordConsumer &consumer) {
+  return source_->ProducePage([this, &consumer](const std::shared_ptr<Record> &record) { Push(record, consumer); });
+}
+
+void PipelineExecutor::Push(const std::shared_ptr<Record> &record, const RecordConsumer &consumer) {
+  const auto *row = &record;
+  for (auto &stage : stages_) {
+    if (stage.predicate_ != nullptr) {
+      auto value = stage.predicate_->Evaluate(*row);
+      if (value.IsNull() || !value.GetValue<bool>()) {
+        return;
+      }
+      continue;
+    }
+    for (size_t i = 0; i < stage.exprs_.size(); i++) {
+      stage.output_->SetValue(i, stage.exprs_[i]->Evaluate(*row));
+    }
+    stage.output_->SetRid((*row)->GetRid());
+    row = &stage.output_;
+  }
+  consumer(*row);
+}
+
+}  // namespace huadb
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "executors/executor.h"
+#include "executors/seqscan_executor.h"
+#include "operators/expressions/expression.h"
+#include "operators/operator.h"
+
+namespace huadb {
+
+// 将顺序扫描之上连续的过滤和投影融合为一条流水线，由扫描按页面推送记录驱动
+// 每条记录在一个循环中依次经过各个阶段，投影阶段将结果写入本阶段复用的输出记录，阶段之间不创建新记录
+// 聚集等流水线终点通过 Produce 直接接收输出，其余上层算子通过 Next 逐页缓冲后逐条读取
+class PipelineExecutor : public Executor {
+ public:
+  PipelineExecutor(ExecutorContext &context, std::shared_ptr<SeqScanExecutor> source);
+
+  // 在流水线顶端追加一个过滤或投影阶段，stage 的孩子须为当前流水线的顶端
+  void AddStage(std::shared_ptr<const Operator> stage);
+
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+  // 将流水线的全部输出依次推送给 consumer，记录只在回调期间有效
+  void Produce(const RecordConsumer &consumer);
+
+ private:
+  struct Stage {
+    // 过滤阶段的谓词，投影阶段为空
+    std::shared_ptr<OperatorExpression> predicate_;
+    // 投影阶段的表达式，以及在各行之间复用的输出记录
+    std::vector<std::shared_ptr<OperatorExpression>> exprs_;
+    std::shared_ptr<Record> output_;
+  };
+
+  // 由扫描推送下一个页面，结果交给 consumer，扫描结束时返回 false
+  bool ProducePage(const RecordConsumer &consumer);
+  // 对一条扫描记录依次执行各个阶段，通过所有过滤阶段时将结果交给 consumer
+  void Push(const std::shared_ptr<Record> &record, const RecordConsumer &consumer);
+
+  SeqScanExecutor *source_;
+  // 自底向上的各个阶段
+  std::vector<Stage> stages_;
+  // Next 使用的当前页面的输出，包含投影阶段时复制复用的输出记录
+  std::vector<std::shared_ptr<Record>> output_;
+  size_t output_index_ = 0;
+  RecordConsumer buffer_;
+};
+
+}  // namespace huadb
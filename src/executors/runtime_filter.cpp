@@ -0,0 +1,96 @@
+#include "executors/runtime_filter.h"
+
+#include "common/value_set.h"
+
+namespace huadb {
+
+// 每个键占用的位数和哈希函数个数，假阳性率约为 3%
+static constexpr size_t BITS_PER_KEY = 8;
+static constexpr size_t HASH_COUNT = 3;
+// 检查若干条记录后，通过率超过阈值则停用过滤器
+static constexpr size_t SAMPLE_ROWS = 4096;
+static constexpr double MAX_PASS_RATE = 0.9;
+
+void RuntimeFilter::Reset() {
+  ready_ = false;
+  hashes_.clear();
+  bits_.clear();
+  has_range_ = true;
+  min_ = 0;
+  max_ = 0;
+  disabled_ = false;
+  checked_ = 0;
+  passed_ = 0;
+}
+
+void RuntimeFilter::Insert(const Value &key) {
+  if (has_range_ && key.GetType() == Type::INT) {
+    auto val = key.GetValue<int32_t>();
+    if (hashes_.empty() || val < min_) {
+      min_ = val;
+    }
+    if (hashes_.empty() || val > max_) {
+      max_ = val;
+    }
+  } else {
+    has_range_ = false;
+  }
+  hashes_.push_back(Hash(key));
+}
+
+void RuntimeFilter::Finish() {
+  size_t bit_count = 64;
+  while (bit_count < hashes_.size() * BITS_PER_KEY) {
+    bit_count *= 2;
+  }
+  mask_ = bit_count - 1;
+  bits_.assign(bit_count / 64, 0);
+  for (auto hash : hashes_) {
+    // 由一个 64 位哈希值派生出多个哈希函数
+    auto delta = (hash >> 32) | 1;
+    for (size_t i = 0; i < HASH_COUNT; i++) {
+      auto bit = (hash + i * delta) & mask_;
+      bits_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+  }
+  has_range_ = has_range_ && !hashes_.empty();
+  std::vector<uint64_t>().swap(hashes_);
+  ready_ = true;
+}
+
+bool RuntimeFilter::MightContain(const Value &key) {
+  if (key.IsNull()) {
+    return false;
+  }
+  if (!ready_ || disabled_) {
+    return true;
+  }
+  bool pass = true;
+  if (has_range_ && key.GetType() == Type::INT) {
+    auto val = key.GetValue<int32_t>();
+    pass = val >= min_ && val <= max_;
+  }
+  if (pass) {
+    auto hash = Hash(key);
+    auto delta = (hash >> 32) | 1;
+    for (size_t i = 0; i < HASH_COUNT && pass; i++) {
+      auto bit = (hash + i * delta) & mask_;
+      pass = (bits_[bit / 64] >> (bit % 64)) & 1;
+    }
+  }
+  checked_++;
+  passed_ += pass;
+  if (checked_ == SAMPLE_ROWS && passed_ > MAX_PASS_RATE * SAMPLE_ROWS) {
+    disabled_ = true;
+  }
+  return pass;
+}
+
+uint64_t RuntimeFilter::Hash(const Value &key) {
+  if (key.GetType() == Type::INT) {
+    return HashUtil::Hash(static_cast<double>(key.GetValue<int32_t>()));
+  }
+  return HashUtil::Hash(key);
+}
+
+}  // namespace huadb
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/value.h"
+
+namespace huadb {
+
+// 哈希连接构建侧生成的运行时过滤器，下推到探测侧的顺序扫描，提前丢弃不可能匹配的记录
+// 包含构建侧连接键的 Bloom 过滤器，INT 类型的连接键还记录最小值和最大值
+// 构建结束前过滤器不生效，所有记录均可通过
+class RuntimeFilter {
+ public:
+  // 开始新一轮构建，清空已加入的键
+  void Reset();
+  // 加入构建侧的一个非空连接键
+  void Insert(const Value &key);
+  // 构建结束，生成 Bloom 过滤器
+  void Finish();
+  // 探测侧的键可能在构建侧出现时返回 true，NULL 不会被匹配，返回 false
+  bool MightContain(const Value &key);
+
+ private:
+  // INT 按 DOUBLE 计算哈希值，连接键一侧为 INT、另一侧为 DOUBLE 时也能匹配
+  static uint64_t Hash(const Value &key);
+
+  bool ready_ = false;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint64_t> bits_;
+  uint64_t mask_ = 0;
+  // 构建侧的键均为 INT 时记录取值范围
+  bool has_range_ = true;
+  int32_t min_ = 0;
+  int32_t max_ = 0;
+  // 绝大多数记录都能通过时过滤器没有收益，停用以节省探测开销
+  bool disabled_ = false;
+  size_t checked_ = 0;
+  size_t passed_ = 0;
+};
+
+// 下推到某个算子的运行时过滤器，每项为过滤列在该算子输出中的位置和过滤器
+using RuntimeFilterList = std::vector<std::pair<size_t, std::shared_ptr<RuntimeFilter>>>;
+
+}  // namespace huadb
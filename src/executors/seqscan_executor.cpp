@@ -1,20 +1,128 @@
 #include "executors/seqscan_executor.h"
 
+#include <algorithm>
+
+#include "table/table_page.h"
+
 namespace huadb {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan)
-    : Executor(context, {}), plan_(std::move(plan)) {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan,
+                                 RuntimeFilterList runtime_filters)
+    : Executor(context, {}), plan_(std::move(plan)), runtime_filters_(std::move(runtime_filters)) {}
 
 void SeqScanExecutor::Init() {
-  auto table = context_.GetCatalog().GetTable(plan_->GetTableOid());
-  scan_ = std::make_unique<TableScan>(context_.GetBufferPool(), table, Rid{table->GetFirstPageId(), 0});
+  pending_ = nullptr;
+  table_ = context_.GetCatalog().GetTable(plan_->GetTableOid());
+  if (plan_->parallel_ && context_.GetMorselSource() != nullptr) {
+    morsel_source_ = context_.GetMorselSource();
+    scan_ = nullptr;
+  } else if (plan_->zone_predicates_.empty()) {
+    scan_ = std::make_unique<TableScan>(context_.GetBufferPool(), table_, Rid{table_->GetFirstPageId(), 0});
+  } else {
+    auto page_id = SkipZones(table_->GetFirstPageId());
+    scan_ = page_id == NULL_PAGE_ID ? nullptr
+                                    : std::make_unique<TableScan>(context_.GetBufferPool(), table_, Rid{page_id, 0});
+  }
 }
 
 std::shared_ptr<Record> SeqScanExecutor::Next() {
+  if (pending_ != nullptr) {
+    return std::move(pending_);
+  }
+  while (true) {
+    auto record = NextRecord();
+    if (record == nullptr || runtime_filters_.empty()) {
+      return record;
+    }
+    bool pass = true;
+    for (const auto &[col_idx, filter] : runtime_filters_) {
+      if (!filter->MightContain(record->GetValues()[col_idx])) {
+        pass = false;
+        break;
+      }
+    }
+    if (pass) {
+      return record;
+    }
+  }
+}
+
+bool SeqScanExecutor::ProducePage(const RecordConsumer &consumer) {
+  auto record = Next();
+  if (record == nullptr) {
+    return false;
+  }
+  auto page_id = record->GetRid().page_id_;
+  do {
+    consumer(record);
+    record = Next();
+  } while (record != nullptr && record->GetRid().page_id_ == page_id);
+  pending_ = std::move(record);
+  return true;
+}
+
+std::shared_ptr<Record> SeqScanExecutor::NextRecord() {
   std::unordered_set<xid_t> active_xids;
   // 根据隔离级别，获取活跃事务的 xid（通过 context_ 获取需要的信息）
   // LAB 3 BEGIN
-  return scan_->GetNextRecord(context_.GetXid(), context_.GetIsolationLevel(), context_.GetCid(), active_xids);
+  if (morsel_source_ == nullptr) {
+    while (scan_ != nullptr) {
+      auto record =
+          scan_->GetNextRecord(context_.GetXid(), context_.GetIsolationLevel(), context_.GetCid(), active_xids);
+      if (record == nullptr || plan_->zone_predicates_.empty()) {
+        return record;
+      }
+      // 表扫描进入新的页面段时检查区域映射，可以跳过时从段后的页面重新开始扫描
+      auto page_id = record->GetRid().page_id_;
+      if (ZoneMap::ZoneOf(page_id) == zone_id_) {
+        return record;
+      }
+      auto next_page_id = SkipZones(page_id);
+      if (next_page_id == page_id) {
+        return record;
+      }
+      scan_ = next_page_id == NULL_PAGE_ID
+                  ? nullptr
+                  : std::make_unique<TableScan>(context_.GetBufferPool(), table_, Rid{next_page_id, 0});
+    }
+    return nullptr;
+  }
+  while (true) {
+    if (scan_ == nullptr) {
+      if (!morsel_source_->Next(morsel_pages_)) {
+        return nullptr;
+      }
+      morsel_index_ = 0;
+      scan_ = std::make_unique<TableScan>(context_.GetBufferPool(), table_, Rid{morsel_pages_[0], 0});
+    }
+    // 表扫描沿页面链表前进，读到 morsel 以外页面的记录时说明当前 morsel 已读完
+    auto record = scan_->GetNextRecord(context_.GetXid(), context_.GetIsolationLevel(), context_.GetCid(), active_xids);
+    if (record != nullptr) {
+      auto page_id = record->GetRid().page_id_;
+      while (morsel_index_ < morsel_pages_.size() && morsel_pages_[morsel_index_] != page_id) {
+        morsel_index_++;
+      }
+      if (morsel_index_ < morsel_pages_.size()) {
+        return record;
+      }
+    }
+    scan_ = nullptr;
+  }
+}
+
+pageid_t SeqScanExecutor::SkipZones(pageid_t page_id) {
+  pageid_t last_page_id;
+  while (page_id != NULL_PAGE_ID) {
+    zone_id_ = ZoneMap::ZoneOf(page_id);
+    if (!table_->GetZoneMap().CanSkip(zone_id_, plan_->zone_predicates_, last_page_id)) {
+      break;
+    }
+    // 段内的页面依次相连，从段内最后一个有记录的页面取得段后的页面
+    TablePage table_page(
+        context_.GetBufferPool().GetPage(table_->GetDbOid(), table_->GetOid(), std::max(last_page_id, page_id)));
+    page_id = table_page.GetNextPageId();
+  }
+  return page_id;
 }
 
 }  // namespace huadb
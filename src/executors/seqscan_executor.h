@@ -1,20 +1,47 @@
 #pragma once
 
+#include <functional>
+
 #include "executors/executor.h"
+#include "executors/morsel_source.h"
+#include "executors/runtime_filter.h"
 #include "operators/seqscan_operator.h"
 
 namespace huadb {
 
+// 接收扫描推送的记录，记录只在回调期间有效
+using RecordConsumer = std::function<void(const std::shared_ptr<Record> &)>;
+
 class SeqScanExecutor : public Executor {
  public:
-  SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan);
+  SeqScanExecutor(ExecutorContext &context, std::shared_ptr<const SeqScanOperator> plan,
+                  RuntimeFilterList runtime_filters = {});
 
   void Init() override;
   std::shared_ptr<Record> Next() override;
+  // 将下一个页面中通过运行时过滤器的记录依次推送给 consumer，扫描结束时返回 false
+  bool ProducePage(const RecordConsumer &consumer);
 
  private:
+  // 读取下一条记录，并行扫描时在当前 morsel 读完后领取下一个 morsel
+  std::shared_ptr<Record> NextRecord();
+  // 从 page_id 开始跳过区域映射表明没有满足谓词的记录的页面段，返回第一个需要扫描的页面
+  pageid_t SkipZones(pageid_t page_id);
+
   std::shared_ptr<const SeqScanOperator> plan_;
+  std::shared_ptr<Table> table_;
   std::unique_ptr<TableScan> scan_;
+  // 哈希连接下推的运行时过滤器，不能通过的记录直接丢弃
+  RuntimeFilterList runtime_filters_;
+  // 并行扫描的页面分发器，为空时扫描全表
+  std::shared_ptr<MorselSource> morsel_source_;
+  // 当前 morsel 的页面，以及正在扫描的页面在其中的位置
+  std::vector<pageid_t> morsel_pages_;
+  size_t morsel_index_ = 0;
+  // 正在扫描的页面段，已确认不能跳过
+  size_t zone_id_ = 0;
+  // 按页面推送时已读出的下一个页面的第一条记录
+  std::shared_ptr<Record> pending_;
 };
 
 }  // namespace huadb
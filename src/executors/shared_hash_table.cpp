@@ -0,0 +1,18 @@
+#include "executors/shared_hash_table.h"
+
+namespace huadb {
+
+SharedHashTables::SharedHashTables(size_t participant_count) : participant_count_(participant_count) {}
+
+std::shared_ptr<SharedHashTable> SharedHashTables::Get(const void *plan) {
+  std::lock_guard lock(mutex_);
+  auto &table = tables_[plan];
+  if (table == nullptr) {
+    table = std::make_shared<SharedHashTable>();
+  }
+  return table;
+}
+
+size_t SharedHashTables::GetParticipantCount() const { return participant_count_; }
+
+}  // namespace huadb
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "storage/spill_file.h"
+#include "table/record.h"
+
+namespace huadb {
+
+// 哈希连接构建侧的一个分区，内存中的记录使用开放寻址哈希表索引
+// 哈希表的每个槽保存一个连接键对应的记录链表的表头下标，链表通过 next_ 串联
+struct HashJoinPartition {
+  std::vector<std::shared_ptr<Record>> records_;
+  std::vector<Value> keys_;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> next_;
+  std::vector<bool> matched_;
+  std::vector<uint32_t> slots_;
+  size_t memory_size_ = 0;
+  // 溢出的分区不在内存中，构建侧和探测侧的记录写入对应的临时文件
+  bool spilled_ = false;
+  std::shared_ptr<SpillFile> build_file_;
+  std::shared_ptr<SpillFile> probe_file_;
+};
+
+// 并行计划中同一个哈希连接的各份执行器共享的构建结果
+// 第一个开始构建的执行器读取构建侧并建立哈希表，其余执行器等待构建完成后只读地探测
+// 共享的构建可以使用各份执行器内存上限之和，仍然超出时放弃共享，各份执行器分别构建并溢出到临时文件
+struct SharedHashTable {
+  enum class State { EMPTY, BUILDING, READY, PRIVATE };
+
+  std::mutex mutex_;
+  // 构建完成或放弃共享时通知等待的执行器
+  std::condition_variable cv_;
+  State state_ = State::EMPTY;
+  std::shared_ptr<std::vector<HashJoinPartition>> partitions_;
+  size_t build_row_count_ = 0;
+  bool build_has_null_ = false;
+};
+
+// Gather 为各份子计划创建一个，按哈希连接算子查找共享的构建结果
+class SharedHashTables {
+ public:
+  // participant_count 为执行同一份子计划的线程数
+  explicit SharedHashTables(size_t participant_count);
+
+  std::shared_ptr<SharedHashTable> Get(const void *plan);
+  size_t GetParticipantCount() const;
+
+ private:
+  size_t participant_count_;
+  std::mutex mutex_;
+  std::unordered_map<const void *, std::shared_ptr<SharedHashTable>> tables_;
+};
+
+}  // namespace huadb
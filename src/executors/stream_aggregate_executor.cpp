@@ -0,0 +1,105 @@
+#include "executors/stream_aggregate_executor.h"
+
+#include "common/sort_key.h"
+
+namespace huadb {
+
+StreamAggregateExecutor::StreamAggregateExecutor(ExecutorContext &context,
+                                                 std::shared_ptr<const AggregateOperator> plan,
+                                                 std::shared_ptr<Executor> child)
+    : Executor(context, {std::move(child)}), plan_(std::move(plan)) {
+  group_count_ = plan_->group_bys_.size();
+  size_t offset = group_count_;
+  for (size_t i = 0; i < plan_->aggregates_.size(); i++) {
+    accumulators_.emplace_back(plan_->aggregate_types_[i], plan_->aggregates_[i]->GetValueType(),
+                               plan_->is_distincts_[i]);
+    input_offsets_.push_back(offset);
+    offset += plan_->mode_ == AggregateMode::FINAL ? accumulators_.back().PartialWidth() : 1;
+  }
+}
+
+void StreamAggregateExecutor::Init() {
+  children_[0]->Init();
+  has_group_ = false;
+  done_ = false;
+  // 没有分组列时，即使输入为空也输出一行
+  if (group_count_ == 0) {
+    StartGroup("", {});
+  }
+}
+
+std::shared_ptr<Record> StreamAggregateExecutor::Next() {
+  if (done_) {
+    return nullptr;
+  }
+  std::vector<Value> values;
+  while (NextInput(values)) {
+    std::string key;
+    for (size_t i = 0; i < group_count_; i++) {
+      SortKey::Append(values[i], false, key);
+    }
+    if (!has_group_ || key == key_) {
+      if (!has_group_) {
+        StartGroup(std::move(key), values);
+      }
+      Accumulate(values);
+      continue;
+    }
+    auto record = OutputGroup();
+    StartGroup(std::move(key), values);
+    Accumulate(values);
+    return record;
+  }
+  done_ = true;
+  return has_group_ ? OutputGroup() : nullptr;
+}
+
+bool StreamAggregateExecutor::NextInput(std::vector<Value> &values) {
+  auto record = children_[0]->Next();
+  if (record == nullptr) {
+    return false;
+  }
+  if (plan_->mode_ == AggregateMode::FINAL) {
+    values = record->GetValues();
+    return true;
+  }
+  values.clear();
+  for (const auto &group_by : plan_->group_bys_) {
+    values.push_back(group_by->Evaluate(record));
+  }
+  for (const auto &aggregate : plan_->aggregates_) {
+    values.push_back(aggregate->Evaluate(record));
+  }
+  return true;
+}
+
+void StreamAggregateExecutor::StartGroup(std::string key, const std::vector<Value> &values) {
+  has_group_ = true;
+  key_ = std::move(key);
+  group_values_.assign(values.begin(), values.begin() + group_count_);
+  states_.assign(accumulators_.size(), AggregateState());
+}
+
+void StreamAggregateExecutor::Accumulate(const std::vector<Value> &values) {
+  for (size_t i = 0; i < accumulators_.size(); i++) {
+    if (plan_->mode_ == AggregateMode::FINAL) {
+      accumulators_[i].Combine(states_[i], &values[input_offsets_[i]]);
+    } else {
+      accumulators_[i].Update(states_[i], values[input_offsets_[i]]);
+    }
+  }
+}
+
+std::shared_ptr<Record> StreamAggregateExecutor::OutputGroup() const {
+  auto values = group_values_;
+  for (size_t i = 0; i < accumulators_.size(); i++) {
+    if (plan_->mode_ == AggregateMode::PARTIAL) {
+      accumulators_[i].Partial(states_[i], values);
+    } else {
+      values.push_back(accumulators_[i].Finalize(states_[i]));
+    }
+  }
+  return std::make_shared<Record>(std::move(values));
+}
+
+}  // namespace huadb
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executors/aggregate_accumulator.h"
+#include "executors/executor.h"
+#include "operators/aggregate_operator.h"
+
+namespace huadb {
+
+// 流式聚集，输入已按分组列有序，相同分组的记录相邻
+// 只保存当前分组的聚集状态，分组键变化时立即输出上一个分组
+class StreamAggregateExecutor : public Executor {
+ public:
+  StreamAggregateExecutor(ExecutorContext &context, std::shared_ptr<const AggregateOperator> plan,
+                          std::shared_ptr<Executor> child);
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+
+ private:
+  // 读取一行输入，依次为各分组列的值和各聚集函数的输入
+  bool NextInput(std::vector<Value> &values);
+  void StartGroup(std::string key, const std::vector<Value> &values);
+  void Accumulate(const std::vector<Value> &values);
+  std::shared_ptr<Record> OutputGroup() const;
+
+  std::shared_ptr<const AggregateOperator> plan_;
+  std::vector<AggregateAccumulator> accumulators_;
+  // 各聚集函数的输入在输入行中的位置
+  std::vector<size_t> input_offsets_;
+  size_t group_count_;
+
+  // 当前分组
+  bool has_group_ = false;
+  std::string key_;
+  std::vector<Value> group_values_;
+  std::vector<AggregateState> states_;
+  bool done_ = false;
+};
+
+}  // namespace huadb
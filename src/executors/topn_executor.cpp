@@ -0,0 +1,62 @@
+#include "executors/topn_executor.h"
+
+#include <algorithm>
+
+#include "common/sort_key.h"
+
+namespace huadb {
+
+TopNExecutor::TopNExecutor(ExecutorContext &context, std::shared_ptr<const TopNOperator> plan,
+                           std::shared_ptr<Executor> child)
+    : Executor(context, {std::move(child)}), plan_(std::move(plan)) {}
+
+void TopNExecutor::Init() {
+  children_[0]->Init();
+  heap_.clear();
+  index_ = plan_->limit_offset_;
+  size_t n = static_cast<size_t>(plan_->limit_count_) + plan_->limit_offset_;
+  if (plan_->limit_count_ == 0) {
+    return;
+  }
+  heap_.reserve(n);
+
+  size_t seq = 0;
+  while (auto record = children_[0]->Next()) {
+    HeapEntry entry{{}, seq++, nullptr};
+    for (const auto &[order_by_type, expr] : plan_->order_bys_) {
+      SortKey::Append(expr->Evaluate(record), order_by_type == OrderByType::DESC, entry.key_);
+    }
+    if (heap_.size() < n) {
+      entry.record_ = std::move(record);
+      heap_.push_back(std::move(entry));
+      std::push_heap(heap_.begin(), heap_.end(), EntryLess);
+      continue;
+    }
+    // 堆已满时，只有排在堆顶之前的记录才替换堆顶
+    if (!EntryLess(entry, heap_.front())) {
+      continue;
+    }
+    entry.record_ = std::move(record);
+    std::pop_heap(heap_.begin(), heap_.end(), EntryLess);
+    heap_.back() = std::move(entry);
+    std::push_heap(heap_.begin(), heap_.end(), EntryLess);
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), EntryLess);
+}
+
+std::shared_ptr<Record> TopNExecutor::Next() {
+  if (index_ < heap_.size()) {
+    return std::move(heap_[index_++].record_);
+  }
+  return nullptr;
+}
+
+bool TopNExecutor::EntryLess(const HeapEntry &lhs, const HeapEntry &rhs) {
+  auto cmp = SortKey::Compare(lhs.key_, rhs.key_);
+  if (cmp != 0) {
+    return cmp < 0;
+  }
+  return lhs.seq_ < rhs.seq_;
+}
+
+}  // namespace huadb
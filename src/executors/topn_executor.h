@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "executors/executor.h"
+#include "operators/topn_operator.h"
+
+namespace huadb {
+
+// 使用大小为 limit_offset_ + limit_count_ 的大根堆保留排序后的前若干条记录，无需对全部输入排序
+class TopNExecutor : public Executor {
+ public:
+  TopNExecutor(ExecutorContext &context, std::shared_ptr<const TopNOperator> plan, std::shared_ptr<Executor> child);
+  void Init() override;
+  std::shared_ptr<Record> Next() override;
+
+ private:
+  struct HeapEntry {
+    std::string key_;
+    // 输入顺序，排序键相同时先输入的记录排在前面
+    size_t seq_;
+    std::shared_ptr<Record> record_;
+  };
+
+  static bool EntryLess(const HeapEntry &lhs, const HeapEntry &rhs);
+
+  std::shared_ptr<const TopNOperator> plan_;
+  std::vector<HeapEntry> heap_;
+  size_t index_ = 0;
+};
+
+}  // namespace huadb
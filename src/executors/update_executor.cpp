@@ -9,6 +9,7 @@ UpdateExecutor::UpdateExecutor(ExecutorContext &context, std::shared_ptr<const U
 void UpdateExecutor::Init() {
   children_[0]->Init();
   table_ = context_.GetCatalog().GetTable(plan_->GetTableOid());
+  indexes_ = context_.GetCatalog().GetTableIndexes(plan_->GetTableOid());
 }
 
 std::shared_ptr<Record> UpdateExecutor::Next() {
@@ -25,6 +26,14 @@ std::shared_ptr<Record> UpdateExecutor::Next() {
     // 获取正确的锁，加锁失败时抛出异常
     // LAB 3 BEGIN
     auto rid = table_->UpdateRecord(record->GetRid(), context_.GetXid(), context_.GetCid(), new_record);
+    // 修改页面后清除可见性映射，VACUUM 设置标记前会重新检查页面
+    table_->GetVisibilityMap().ClearAllVisible(record->GetRid().page_id_);
+    table_->GetVisibilityMap().ClearAllVisible(rid.page_id_);
+    table_->GetZoneMap().Update(rid, *new_record);
+    // 旧版本的索引项保留在索引中，由索引扫描回表时过滤
+    for (const auto &index : indexes_) {
+      index->InsertRecord(*new_record, rid);
+    }
     // 获取正确的锁，加锁失败时抛出异常
     // LAB 3 BEGIN
     count++;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "executors/executor.h"
+#include "index/index.h"
 #include "operators/update_operator.h"
 
 namespace huadb {
@@ -15,6 +16,8 @@ class UpdateExecutor : public Executor {
  private:
   std::shared_ptr<const UpdateOperator> plan_;
   std::shared_ptr<Table> table_;
+  // 表上的索引，每插入一条新版本的记录都要插入对应的索引项
+  std::vector<std::shared_ptr<Index>> indexes_;
   bool finished_ = false;
 };
 
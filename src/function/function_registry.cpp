@@ -0,0 +1,174 @@
+#include "function/function_registry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "common/exceptions.h"
+#include "common/string_util.h"
+
+namespace huadb {
+
+namespace {
+
+Value Lower(const std::vector<Value> &args) { return Value(StringUtil::Lower(args[0].GetValue<std::string>())); }
+
+Value Upper(const std::vector<Value> &args) { return Value(StringUtil::Upper(args[0].GetValue<std::string>())); }
+
+Value Length(const std::vector<Value> &args) {
+  return Value(static_cast<int32_t>(args[0].GetValue<std::string>().size()));
+}
+
+// substring(str, start [, count])，下标从 1 开始，超出范围的部分被截断
+Value Substring(const std::vector<Value> &args) {
+  auto str = args[0].GetValue<std::string>();
+  int64_t begin = args[1].GetValue<int32_t>();
+  int64_t end = static_cast<int64_t>(str.size()) + 1;
+  if (args.size() == 3) {
+    auto count = args[2].GetValue<int32_t>();
+    if (count < 0) {
+      throw DbException("Negative substring length not allowed");
+    }
+    end = std::min(end, begin + count);
+  }
+  begin = std::max<int64_t>(begin, 1);
+  if (end <= begin) {
+    return Value(std::string());
+  }
+  return Value(str.substr(begin - 1, end - begin));
+}
+
+Value Trim(const std::vector<Value> &args) {
+  auto str = args[0].GetValue<std::string>();
+  StringUtil::LTrim(str);
+  StringUtil::RTrim(str);
+  return Value(str);
+}
+
+Value LTrim(const std::vector<Value> &args) {
+  auto str = args[0].GetValue<std::string>();
+  StringUtil::LTrim(str);
+  return Value(str);
+}
+
+Value RTrim(const std::vector<Value> &args) {
+  auto str = args[0].GetValue<std::string>();
+  StringUtil::RTrim(str);
+  return Value(str);
+}
+
+Value AbsInt(const std::vector<Value> &args) {
+  auto value = args[0].GetValue<int32_t>();
+  // INT_MIN 的绝对值无法用 int32_t 表示
+  if (value == std::numeric_limits<int32_t>::min()) {
+    throw DbException("Integer out of range in abs");
+  }
+  return Value(std::abs(value));
+}
+
+Value AbsDouble(const std::vector<Value> &args) { return Value(std::fabs(args[0].GetValue<double>())); }
+
+// 单参数函数的批量实现：按列处理，复用参数数组
+template <Value (*Function)(const std::vector<Value> &)>
+void UnaryBatch(const std::vector<std::vector<Value>> &args, std::vector<Value> &results) {
+  std::vector<Value> row(1);
+  results.resize(args[0].size());
+  for (size_t i = 0; i < args[0].size(); i++) {
+    row[0] = args[0][i];
+    results[i] = Function(row);
+  }
+}
+
+}  // namespace
+
+bool ScalarFunction::Matches(const std::vector<Type> &arg_types) const {
+  if (arg_types.size() != arg_types_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < arg_types.size(); i++) {
+    if (arg_types[i] == Type::NULL_TYPE || arg_types[i] == arg_types_[i]) {
+      continue;
+    }
+    if (TypeUtil::IsString(arg_types[i]) && TypeUtil::IsString(arg_types_[i])) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+Value ScalarFunction::Invoke(const std::vector<Value> &args) const {
+  for (const auto &arg : args) {
+    if (arg.IsNull()) {
+      return Value();
+    }
+  }
+  return function_(args);
+}
+
+void ScalarFunction::InvokeBatch(const std::vector<std::vector<Value>> &args, std::vector<Value> &results) const {
+  size_t count = args.empty() ? 0 : args[0].size();
+  // 含有 NULL 的行单独处理，其余行交给批量实现
+  bool has_null = false;
+  for (const auto &column : args) {
+    for (const auto &value : column) {
+      has_null = has_null || value.IsNull();
+    }
+  }
+  if (batch_function_ != nullptr && !has_null) {
+    batch_function_(args, results);
+    return;
+  }
+  results.resize(count);
+  std::vector<Value> row(args.size());
+  for (size_t i = 0; i < count; i++) {
+    for (size_t j = 0; j < args.size(); j++) {
+      row[j] = args[j][i];
+    }
+    results[i] = Invoke(row);
+  }
+}
+
+FunctionRegistry &FunctionRegistry::GetInstance() {
+  static FunctionRegistry registry;
+  return registry;
+}
+
+FunctionRegistry::FunctionRegistry() { RegisterBuiltins(); }
+
+void FunctionRegistry::Register(ScalarFunction function) {
+  auto name = function.name_;
+  functions_[name].push_back(std::make_shared<const ScalarFunction>(std::move(function)));
+}
+
+bool FunctionRegistry::Exists(const std::string &name) const { return functions_.find(name) != functions_.end(); }
+
+std::shared_ptr<const ScalarFunction> FunctionRegistry::Resolve(const std::string &name,
+                                                                const std::vector<Type> &arg_types) const {
+  auto it = functions_.find(name);
+  if (it == functions_.end()) {
+    throw DbException("Unknown function name " + name);
+  }
+  for (const auto &function : it->second) {
+    if (function->Matches(arg_types)) {
+      return function;
+    }
+  }
+  throw DbException("Argument mismatch for function " + name);
+}
+
+void FunctionRegistry::RegisterBuiltins() {
+  Register(ScalarFunction("lower", {Type::VARCHAR}, Type::VARCHAR, Lower, UnaryBatch<Lower>));
+  Register(ScalarFunction("upper", {Type::VARCHAR}, Type::VARCHAR, Upper, UnaryBatch<Upper>));
+  Register(ScalarFunction("length", {Type::VARCHAR}, Type::INT, Length, UnaryBatch<Length>));
+  Register(ScalarFunction("substring", {Type::VARCHAR, Type::INT}, Type::VARCHAR, Substring));
+  Register(ScalarFunction("substring", {Type::VARCHAR, Type::INT, Type::INT}, Type::VARCHAR, Substring));
+  Register(ScalarFunction("trim", {Type::VARCHAR}, Type::VARCHAR, Trim, UnaryBatch<Trim>));
+  Register(ScalarFunction("ltrim", {Type::VARCHAR}, Type::VARCHAR, LTrim, UnaryBatch<LTrim>));
+  Register(ScalarFunction("rtrim", {Type::VARCHAR}, Type::VARCHAR, RTrim, UnaryBatch<RTrim>));
+  Register(ScalarFunction("abs", {Type::INT}, Type::INT, AbsInt, UnaryBatch<AbsInt>));
+  Register(ScalarFunction("abs", {Type::DOUBLE}, Type::DOUBLE, AbsDouble, UnaryBatch<AbsDouble>));
+}
+
+}  // namespace huadb
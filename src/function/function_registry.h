@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/value.h"
+
+namespace huadb {
+
+// 逐行求值，参数均不为 NULL
+using ScalarFunctionPtr = Value (*)(const std::vector<Value> &args);
+// 批量求值，args[i] 为第 i 个参数的一列值，参数均不为 NULL，结果写入 results
+using BatchFunctionPtr = void (*)(const std::vector<std::vector<Value>> &args, std::vector<Value> &results);
+
+class ScalarFunction {
+ public:
+  ScalarFunction(std::string name, std::vector<Type> arg_types, Type return_type, ScalarFunctionPtr function,
+                 BatchFunctionPtr batch_function = nullptr)
+      : name_(std::move(name)),
+        arg_types_(std::move(arg_types)),
+        return_type_(return_type),
+        function_(function),
+        batch_function_(batch_function) {}
+
+  // 参数类型是否与该实现匹配，CHAR 与 VARCHAR 视为同一类型，NULL 匹配任意类型
+  bool Matches(const std::vector<Type> &arg_types) const;
+  // 任一参数为 NULL 时结果为 NULL
+  Value Invoke(const std::vector<Value> &args) const;
+  // 未注册批量实现时逐行调用 function_
+  void InvokeBatch(const std::vector<std::vector<Value>> &args, std::vector<Value> &results) const;
+
+  std::string name_;
+  std::vector<Type> arg_types_;
+  Type return_type_;
+  ScalarFunctionPtr function_;
+  BatchFunctionPtr batch_function_;
+};
+
+// 标量函数注册表，函数名和参数类型在生成查询计划时解析为具体实现
+class FunctionRegistry {
+ public:
+  static FunctionRegistry &GetInstance();
+
+  // 应在执行查询前注册
+  void Register(ScalarFunction function);
+  bool Exists(const std::string &name) const;
+  // 根据参数类型选择重载，找不到时抛出异常
+  std::shared_ptr<const ScalarFunction> Resolve(const std::string &name, const std::vector<Type> &arg_types) const;
+
+ private:
+  FunctionRegistry();
+  void RegisterBuiltins();
+
+  std::unordered_map<std::string, std::vector<std::shared_ptr<const ScalarFunction>>> functions_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,467 @@
+#include "index/b_plus_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <tuple>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+#include "common/sort_key.h"
+
+namespace huadb {
+
+// page_lsn(8) + is_leaf(1) + 保留(1) + key_count(2) + next_page_id(4) = 16
+static constexpr size_t NODE_HEADER_SIZE = sizeof(lsn_t) + 2 + sizeof(uint16_t) + sizeof(pageid_t);
+static constexpr pageid_t META_PAGE_ID = 0;
+
+// 截取 key 的前 bound.size() 个字节与 bound 比较
+static int ComparePrefix(const std::string &key, const std::string &bound) {
+  return SortKey::Compare(key.substr(0, bound.size()), bound);
+}
+
+static bool SatisfiesBound(const std::string &key, const std::string &bound, bool inclusive) {
+  auto result = ComparePrefix(key, bound);
+  return inclusive ? result >= 0 : result > 0;
+}
+
+BPlusTree::BPlusTree(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, bool new_tree)
+    : buffer_pool_(buffer_pool), log_manager_(log_manager), oid_(oid), db_oid_(db_oid) {
+  if (new_tree) {
+    // 0 号页面为元信息页，1 号页面为空的根节点
+    root_page_id_ = 1;
+    page_count_ = 2;
+    WriteMeta(true);
+    WriteNode(root_page_id_, Node(), true);
+  } else {
+    auto page = buffer_pool_.GetPage(db_oid_, oid_, META_PAGE_ID);
+    const char *data = page->GetData() + sizeof(lsn_t);
+    pageid_t root_page_id, page_count;
+    memcpy(&root_page_id, data, sizeof(pageid_t));
+    memcpy(&page_count, data + sizeof(pageid_t), sizeof(pageid_t));
+    root_page_id_ = root_page_id;
+    page_count_ = page_count;
+  }
+}
+
+void BPlusTree::Insert(const std::string &key) {
+  if (key.size() > MAX_INDEX_KEY_SIZE) {
+    throw DbException("Index key size too large: " + std::to_string(key.size()));
+  }
+  while (!TryInsert(key)) {
+    std::this_thread::yield();
+  }
+}
+
+void BPlusTree::BulkLoad(const std::function<bool(std::string &)> &next_key, size_t fill_factor) {
+  auto limit = DB_PAGE_SIZE * fill_factor / 100;
+  // levels[i] 为第 i 层（叶节点为第 0 层）正在填充的节点，第一个叶节点使用空的根节点所在的页面
+  std::vector<BulkLevel> levels;
+  levels.push_back({Node(), root_page_id_, ""});
+  std::string key;
+  while (next_key(key)) {
+    if (key.size() > MAX_INDEX_KEY_SIZE) {
+      throw DbException("Index key size too large: " + std::to_string(key.size()));
+    }
+    // 叶节点至少包含一个键，超出填充上限时写入当前叶节点，之后的键写入新的叶节点
+    if (!levels[0].node_.keys_.empty() && NodeSize(levels[0].node_) + 1 + key.size() > limit) {
+      auto next_page_id = AllocatePage();
+      levels[0].node_.next_page_id_ = next_page_id;
+      WriteNode(levels[0].page_id_, levels[0].node_, levels[0].page_id_ != root_page_id_, true);
+      auto low_key = std::move(levels[0].low_key_);
+      BulkAddChild(levels, 1, low_key, levels[0].page_id_, limit);
+      levels[0] = {Node(), next_page_id, ""};
+    }
+    if (levels[0].node_.keys_.empty()) {
+      levels[0].low_key_ = key;
+    }
+    levels[0].node_.keys_.push_back(std::move(key));
+  }
+  // 自底向上写入各层的最后一个节点，没有上一层的节点即为根节点
+  pageid_t root_page_id = root_page_id_;
+  for (size_t level = 0; level < levels.size(); level++) {
+    auto page_id = levels[level].page_id_;
+    WriteNode(page_id, levels[level].node_, page_id != root_page_id_, true);
+    if (level + 1 == levels.size()) {
+      root_page_id = page_id;
+      break;
+    }
+    auto low_key = std::move(levels[level].low_key_);
+    BulkAddChild(levels, level + 1, low_key, page_id, limit);
+  }
+  root_page_id_ = root_page_id;
+  WriteMeta(false, true);
+}
+
+void BPlusTree::BulkAddChild(std::vector<BulkLevel> &levels, size_t level, const std::string &low_key,
+                             pageid_t child, size_t limit) {
+  if (level == levels.size()) {
+    Node node;
+    node.leaf_ = false;
+    levels.push_back({std::move(node), AllocatePage(), ""});
+  }
+  // 内部节点至少包含两个子节点，超出填充上限时写入当前节点，新的子节点放入同一层的下一个节点
+  const auto &node = levels[level].node_;
+  if (node.children_.size() >= 2 && NodeSize(node) + 1 + low_key.size() + sizeof(pageid_t) > limit) {
+    auto page_id = levels[level].page_id_;
+    WriteNode(page_id, node, true, true);
+    auto node_low_key = std::move(levels[level].low_key_);
+    BulkAddChild(levels, level + 1, node_low_key, page_id, limit);
+    Node next;
+    next.leaf_ = false;
+    levels[level] = {std::move(next), AllocatePage(), ""};
+  }
+  auto &current = levels[level];
+  if (current.node_.children_.empty()) {
+    current.low_key_ = low_key;
+  } else {
+    current.node_.keys_.push_back(low_key);
+  }
+  current.node_.children_.push_back(child);
+}
+
+bool BPlusTree::TryInsert(const std::string &key) {
+  Node node;
+  pageid_t page_id;
+  uint64_t version, root_version;
+  std::vector<std::pair<pageid_t, uint64_t>> path;
+  auto choose_child = [&key](const Node &inner) {
+    return std::upper_bound(inner.keys_.begin(), inner.keys_.end(), key) - inner.keys_.begin();
+  };
+  if (!FindLeaf(choose_child, node, page_id, version, root_version, &path)) {
+    return false;
+  }
+  auto position = std::lower_bound(node.keys_.begin(), node.keys_.end(), key);
+  if (position != node.keys_.end() && *position == key) {
+    return LatchOf(page_id).Validate(version);
+  }
+  // 加锁成功说明叶节点自遍历以来未被修改，读到的副本即为当前内容
+  WriteGuard guard(*this);
+  if (!guard.Lock(page_id, version)) {
+    return false;
+  }
+  node.keys_.insert(position, key);
+  if (NodeSize(node) <= DB_PAGE_SIZE) {
+    WriteNode(page_id, node, false);
+    return true;
+  }
+  // 节点溢出时分裂，分隔键插入父节点，父节点溢出时继续向上分裂，根节点溢出时树高加一
+  // 先在副本上确定分裂到哪一层，并锁住沿途要修改的节点，全部加锁成功后再写入，保证加锁失败重试时尚未修改任何节点
+  std::vector<Node> parents;
+  bool split_root = false;
+  for (Node current = node; NodeSize(current) > DB_PAGE_SIZE;) {
+    if (parents.size() == path.size()) {
+      if (!guard.LockRoot(root_version)) {
+        return false;
+      }
+      split_root = true;
+      break;
+    }
+    auto [parent_id, parent_version] = path[path.size() - 1 - parents.size()];
+    if (!guard.Lock(parent_id, parent_version)) {
+      return false;
+    }
+    auto separator = SplitNode(current).first;
+    parents.push_back(ReadNode(parent_id));
+    current = parents.back();
+    InsertChild(current, std::move(separator), NULL_PAGE_ID);
+  }
+  for (size_t i = 0; i < parents.size(); i++) {
+    auto [separator, new_page_id] = Split(page_id, node);
+    page_id = path[path.size() - 1 - i].first;
+    node = std::move(parents[i]);
+    InsertChild(node, std::move(separator), new_page_id);
+  }
+  if (!split_root) {
+    WriteNode(page_id, node, false);
+    return true;
+  }
+  auto [separator, new_page_id] = Split(page_id, node);
+  Node root;
+  root.leaf_ = false;
+  root.keys_.push_back(std::move(separator));
+  root.children_ = {page_id, new_page_id};
+  auto root_page_id = AllocatePage();
+  WriteNode(root_page_id, root, true);
+  root_page_id_ = root_page_id;
+  WriteMeta(false);
+  return true;
+}
+
+bool BPlusTree::FindLeaf(const std::function<size_t(const Node &)> &choose_child, Node &leaf, pageid_t &page_id,
+                         uint64_t &version, uint64_t &root_version,
+                         std::vector<std::pair<pageid_t, uint64_t>> *path) const {
+  root_version = root_latch_.ReadLock();
+  page_id = root_page_id_;
+  version = LatchOf(page_id).ReadLock();
+  if (!root_latch_.Validate(root_version)) {
+    return false;
+  }
+  while (true) {
+    leaf = ReadNode(page_id);
+    if (!LatchOf(page_id).Validate(version)) {
+      return false;
+    }
+    if (leaf.leaf_) {
+      return true;
+    }
+    if (path != nullptr) {
+      path->emplace_back(page_id, version);
+    }
+    // 先记下子节点的版本号，再确认父节点未被修改，保证进入的子节点仍是正确的
+    auto child_page_id = leaf.children_[choose_child(leaf)];
+    auto child_version = LatchOf(child_page_id).ReadLock();
+    if (!LatchOf(page_id).Validate(version)) {
+      return false;
+    }
+    page_id = child_page_id;
+    version = child_version;
+  }
+}
+
+BPlusTree::Iterator BPlusTree::Seek(const std::string &bound, bool inclusive) const {
+  // 满足条件的键构成键序上的一个后缀，因此可以像查找普通的键一样向下查找
+  auto choose_child = [&bound, inclusive](const Node &inner) {
+    size_t child = 0;
+    while (child < inner.keys_.size() && !SatisfiesBound(inner.keys_[child], bound, inclusive)) {
+      child++;
+    }
+    return child;
+  };
+  Node node;
+  pageid_t page_id;
+  uint64_t version, root_version;
+  while (!FindLeaf(choose_child, node, page_id, version, root_version, nullptr)) {
+    std::this_thread::yield();
+  }
+  Iterator iterator(*this, NULL_PAGE_ID);
+  iterator.keys_ = std::move(node.keys_);
+  iterator.next_page_id_ = node.next_page_id_;
+  while (true) {
+    while (iterator.position_ < iterator.keys_.size() &&
+           !SatisfiesBound(iterator.keys_[iterator.position_], bound, inclusive)) {
+      iterator.position_++;
+    }
+    if (iterator.position_ < iterator.keys_.size() || iterator.next_page_id_ == NULL_PAGE_ID) {
+      break;
+    }
+    // 当前叶节点中没有满足条件的键，继续检查下一个叶节点
+    iterator.position_ = iterator.keys_.size();
+    iterator.SkipEmptyLeaves();
+  }
+  return iterator;
+}
+
+BPlusTree::Iterator::Iterator(const BPlusTree &tree, pageid_t page_id) : tree_(tree), next_page_id_(page_id) {
+  SkipEmptyLeaves();
+}
+
+bool BPlusTree::Iterator::IsEnd() const { return position_ >= keys_.size(); }
+
+const std::string &BPlusTree::Iterator::Key() const { return keys_[position_]; }
+
+void BPlusTree::Iterator::Next() {
+  position_++;
+  SkipEmptyLeaves();
+}
+
+void BPlusTree::Iterator::SkipEmptyLeaves() {
+  // 叶节点分裂时右半部分的键已在之前读到的副本中，沿旧的兄弟指针前进不会遗漏或重复
+  while (position_ >= keys_.size() && next_page_id_ != NULL_PAGE_ID) {
+    auto node = tree_.ReadNodeConsistent(next_page_id_);
+    keys_ = std::move(node.keys_);
+    position_ = 0;
+    next_page_id_ = node.next_page_id_;
+  }
+}
+
+OptimisticLatch &BPlusTree::LatchOf(pageid_t page_id) const { return latches_[page_id % LATCH_COUNT]; }
+
+BPlusTree::Node BPlusTree::ReadNodeConsistent(pageid_t page_id) const {
+  auto &latch = LatchOf(page_id);
+  while (true) {
+    auto version = latch.ReadLock();
+    auto node = ReadNode(page_id);
+    if (latch.Validate(version)) {
+      return node;
+    }
+  }
+}
+
+BPlusTree::Node BPlusTree::ReadNode(pageid_t page_id) const {
+  auto page = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+  const char *data = page->GetData();
+  Node node;
+  uint16_t key_count;
+  node.leaf_ = data[sizeof(lsn_t)] != 0;
+  memcpy(&key_count, data + sizeof(lsn_t) + 2, sizeof(uint16_t));
+  memcpy(&node.next_page_id_, data + sizeof(lsn_t) + 2 + sizeof(uint16_t), sizeof(pageid_t));
+  // 与写者并发读取时内容可能不一致，越界时提前结束，由调用方校验版本号后丢弃
+  key_count = std::min<uint16_t>(key_count, DB_PAGE_SIZE);
+  size_t offset = NODE_HEADER_SIZE;
+  if (!node.leaf_) {
+    node.children_.resize(key_count + 1, META_PAGE_ID);
+    memcpy(&node.children_[0], data + offset, sizeof(pageid_t));
+    offset += sizeof(pageid_t);
+  }
+  node.keys_.reserve(key_count);
+  for (uint16_t i = 0; i < key_count; i++) {
+    auto length = static_cast<uint8_t>(data[offset]);
+    if (offset + 1 + length + (node.leaf_ ? 0 : sizeof(pageid_t)) > DB_PAGE_SIZE) {
+      break;
+    }
+    node.keys_.emplace_back(data + offset + 1, length);
+    offset += 1 + length;
+    if (!node.leaf_) {
+      memcpy(&node.children_[i + 1], data + offset, sizeof(pageid_t));
+      offset += sizeof(pageid_t);
+    }
+  }
+  return node;
+}
+
+void BPlusTree::WriteNode(pageid_t page_id, const Node &node, bool new_page, bool write_log) {
+  char data[DB_PAGE_SIZE] = {};
+  auto key_count = static_cast<uint16_t>(node.keys_.size());
+  data[sizeof(lsn_t)] = node.leaf_ ? 1 : 0;
+  memcpy(data + sizeof(lsn_t) + 2, &key_count, sizeof(uint16_t));
+  memcpy(data + sizeof(lsn_t) + 2 + sizeof(uint16_t), &node.next_page_id_, sizeof(pageid_t));
+  size_t offset = NODE_HEADER_SIZE;
+  if (!node.leaf_) {
+    memcpy(data + offset, &node.children_[0], sizeof(pageid_t));
+    offset += sizeof(pageid_t);
+  }
+  for (size_t i = 0; i < node.keys_.size(); i++) {
+    data[offset] = static_cast<char>(node.keys_[i].size());
+    memcpy(data + offset + 1, node.keys_[i].data(), node.keys_[i].size());
+    offset += 1 + node.keys_[i].size();
+    if (!node.leaf_) {
+      memcpy(data + offset, &node.children_[i + 1], sizeof(pageid_t));
+      offset += sizeof(pageid_t);
+    }
+  }
+  WritePage(page_id, data, new_page, write_log);
+}
+
+void BPlusTree::WritePage(pageid_t page_id, char *data, bool new_page, bool write_log) {
+  if (write_log) {
+    // 追加日志时将页面的 page lsn 设置为日志的 lsn，页面刷盘前会先将日志刷盘
+    log_manager_.AppendPageImageLog(DDL_XID, oid_, db_oid_, page_id, data);
+  } else {
+    // 不写日志时 page lsn 取已追加日志的 lsn 上界，不小于该页面此前所有镜像日志的 lsn，重做时不会用旧镜像覆盖之后的修改
+    lsn_t lsn = log_manager_.GetNextLSN() - 1;
+    memcpy(data, &lsn, sizeof(lsn_t));
+  }
+  auto page = new_page ? buffer_pool_.NewPage(db_oid_, oid_, page_id) : buffer_pool_.GetPage(db_oid_, oid_, page_id);
+  while (true) {
+    memcpy(page->GetData(), data, DB_PAGE_SIZE);
+    page->SetDirty();
+    // buffer pool 不固定页面，写入期间页面可能被其他线程换出，此时写入的内容会丢失
+    // 写入后页面仍在 buffer pool 中时，之后换出会将其刷盘；否则重新读入页面再写一次
+    auto current = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+    if (current == page) {
+      return;
+    }
+    page = std::move(current);
+  }
+}
+
+size_t BPlusTree::NodeSize(const Node &node) {
+  size_t size = NODE_HEADER_SIZE + node.children_.size() * sizeof(pageid_t);
+  for (const auto &key : node.keys_) {
+    size += 1 + key.size();
+  }
+  return size;
+}
+
+pageid_t BPlusTree::AllocatePage() { return page_count_.fetch_add(1); }
+
+void BPlusTree::WriteMeta(bool new_page, bool write_log) {
+  std::lock_guard lock(meta_mutex_);
+  pageid_t root_page_id = root_page_id_;
+  pageid_t page_count = page_count_;
+  char data[DB_PAGE_SIZE] = {};
+  memcpy(data + sizeof(lsn_t), &root_page_id, sizeof(pageid_t));
+  memcpy(data + sizeof(lsn_t) + sizeof(pageid_t), &page_count, sizeof(pageid_t));
+  WritePage(META_PAGE_ID, data, new_page, write_log);
+}
+
+std::pair<std::string, BPlusTree::Node> BPlusTree::SplitNode(Node &node) {
+  // 按字节数将节点分为大小接近的两半
+  size_t half = (NodeSize(node) - NODE_HEADER_SIZE) / 2;
+  // 叶节点两侧至少各保留一个键，内部节点除提升的分隔键外两侧也至少各保留一个键
+  size_t max_middle = node.keys_.size() - (node.leaf_ ? 1 : 2);
+  size_t middle = 0, size = 0;
+  while (middle < max_middle && size < half) {
+    size += 1 + node.keys_[middle].size() + (node.leaf_ ? 0 : sizeof(pageid_t));
+    middle++;
+  }
+  middle = std::max<size_t>(middle, 1);
+  Node right;
+  right.leaf_ = node.leaf_;
+  std::string separator;
+  if (node.leaf_) {
+    // 叶节点的分隔键为右半部分的第一个键，仍保留在叶节点中
+    right.keys_.assign(node.keys_.begin() + middle, node.keys_.end());
+    separator = right.keys_[0];
+    node.keys_.resize(middle);
+  } else {
+    // 内部节点的分隔键提升到父节点，不再保留
+    separator = node.keys_[middle];
+    right.keys_.assign(node.keys_.begin() + middle + 1, node.keys_.end());
+    right.children_.assign(node.children_.begin() + middle + 1, node.children_.end());
+    node.keys_.resize(middle);
+    node.children_.resize(middle + 1);
+  }
+  return {std::move(separator), std::move(right)};
+}
+
+void BPlusTree::InsertChild(Node &node, std::string separator, pageid_t child) {
+  auto position = std::upper_bound(node.keys_.begin(), node.keys_.end(), separator) - node.keys_.begin();
+  node.keys_.insert(node.keys_.begin() + position, std::move(separator));
+  node.children_.insert(node.children_.begin() + position + 1, child);
+}
+
+std::pair<std::string, pageid_t> BPlusTree::Split(pageid_t page_id, Node &node) {
+  auto [separator, right] = SplitNode(node);
+  auto right_page_id = AllocatePage();
+  if (node.leaf_) {
+    right.next_page_id_ = node.next_page_id_;
+    node.next_page_id_ = right_page_id;
+  }
+  WriteNode(right_page_id, right, true);
+  WriteNode(page_id, node, false);
+  WriteMeta(false);
+  return {std::move(separator), right_page_id};
+}
+
+BPlusTree::WriteGuard::~WriteGuard() {
+  for (const auto &[latch_index, version] : held_) {
+    tree_.latches_[latch_index].WriteUnlock();
+  }
+  if (root_held_) {
+    tree_.root_latch_.WriteUnlock();
+  }
+}
+
+bool BPlusTree::WriteGuard::Lock(pageid_t page_id, uint64_t version) {
+  auto latch_index = page_id % LATCH_COUNT;
+  for (const auto &[held_index, held_version] : held_) {
+    // 与已加锁的页面共用一把锁，版本号相同说明该页面自遍历以来未被其他写者修改
+    if (held_index == latch_index) {
+      return held_version == version;
+    }
+  }
+  if (!tree_.latches_[latch_index].TryUpgrade(version)) {
+    return false;
+  }
+  held_.emplace_back(latch_index, version);
+  return true;
+}
+
+bool BPlusTree::WriteGuard::LockRoot(uint64_t version) {
+  root_held_ = tree_.root_latch_.TryUpgrade(version);
+  return root_held_;
+}
+
+}  // namespace huadb
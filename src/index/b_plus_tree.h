@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/constants.h"
+#include "common/typedefs.h"
+#include "index/optimistic_latch.h"
+#include "log/log_manager.h"
+#include "storage/buffer_pool.h"
+
+namespace huadb {
+
+// 存储在独立文件中的 B+ 树，通过 buffer pool 读写页面
+// 树中的键为按 memcmp 比较的字节串，由调用方保证各个键互不相同
+// 0 号页面为元信息页，记录根节点的页面号和已分配的页面数
+// 删除记录时不删除索引项，由索引扫描回表时判断记录是否仍然存在，因此树只会增长，不需要合并节点
+// 并发控制采用乐观锁耦合：读者只记录并校验经过节点的版本号，不加锁；写者乐观地找到叶节点后，
+// 只对需要修改的节点加写锁，分裂时自底向上逐层加锁，加锁失败时放弃已持有的锁并从根节点重试
+// 逐个插入的修改不写日志，批量构建写入的页面整页写日志
+class BPlusTree {
+ public:
+  BPlusTree(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, bool new_tree);
+
+  // 插入键，键已存在时不做任何操作
+  void Insert(const std::string &key);
+  // 由按升序排列且互不相同的键自底向上构建整棵树，next_key 没有更多的键时返回 false
+  // 各层节点依次填充到页面大小的 fill_factor% 后写入，为之后的插入预留空间
+  // 调用时树必须为空，且没有其他线程访问
+  void BulkLoad(const std::function<bool(std::string &)> &next_key, size_t fill_factor);
+
+  // 按键的顺序遍历叶节点的迭代器
+  class Iterator {
+   public:
+    bool IsEnd() const;
+    const std::string &Key() const;
+    void Next();
+
+   private:
+    friend class BPlusTree;
+    Iterator(const BPlusTree &tree, pageid_t page_id);
+    // 当前叶节点读完时，沿兄弟指针前进到下一个非空叶节点
+    void SkipEmptyLeaves();
+
+    const BPlusTree &tree_;
+    std::vector<std::string> keys_;
+    size_t position_ = 0;
+    pageid_t next_page_id_;
+  };
+
+  // 定位到第一个截取前 bound.size() 个字节后大于等于 bound（inclusive 为 false 时为大于）的键
+  Iterator Seek(const std::string &bound, bool inclusive) const;
+
+ private:
+  // 节点在内存中的形式，读写页面时整体序列化，不在多次 buffer pool 访问之间持有页面
+  // 内部节点的 children_ 比 keys_ 多一个，children_[i] 中的键大于等于 keys_[i - 1] 且小于 keys_[i]
+  struct Node {
+    bool leaf_ = true;
+    pageid_t next_page_id_ = NULL_PAGE_ID;
+    std::vector<std::string> keys_;
+    std::vector<pageid_t> children_;
+  };
+
+  // 批量构建时某一层正在填充的节点
+  struct BulkLevel {
+    Node node_;
+    pageid_t page_id_;
+    // 节点中最小的键，节点写入后作为分隔键插入上一层
+    std::string low_key_;
+  };
+
+  // 写者持有的写锁，析构时全部释放
+  class WriteGuard {
+   public:
+    explicit WriteGuard(BPlusTree &tree) : tree_(tree) {}
+    ~WriteGuard();
+    // 以遍历时读到的版本号加写锁，节点在此之后被修改过时返回 false
+    bool Lock(pageid_t page_id, uint64_t version);
+    bool LockRoot(uint64_t version);
+
+   private:
+    BPlusTree &tree_;
+    // 已持有的锁在 latches_ 中的下标，以及加锁时的版本号
+    std::vector<std::pair<size_t, uint64_t>> held_;
+    bool root_held_ = false;
+  };
+
+  // 插入一次，与其他写者冲突时返回 false，由调用方重试
+  bool TryInsert(const std::string &key);
+  // 乐观地从根节点找到叶节点，choose_child 返回内部节点中要进入的子节点下标
+  // 返回叶节点的副本、页面号和版本号，path 不为空时记录经过的内部节点及其版本号
+  // 经过的节点被其他写者修改时返回 false
+  bool FindLeaf(const std::function<size_t(const Node &)> &choose_child, Node &leaf, pageid_t &page_id,
+                uint64_t &version, uint64_t &root_version,
+                std::vector<std::pair<pageid_t, uint64_t>> *path) const;
+  OptimisticLatch &LatchOf(pageid_t page_id) const;
+  // 读取节点的一致副本，节点正被修改时重试
+  Node ReadNodeConsistent(pageid_t page_id) const;
+  // 读取页面中的节点，并发修改时可能读到不一致的内容，由调用方校验版本号
+  Node ReadNode(pageid_t page_id) const;
+  // write_log: 是否整页写日志，仅批量构建时写日志
+  void WriteNode(pageid_t page_id, const Node &node, bool new_page, bool write_log = false);
+  // 将整个页面的内容写入 buffer pool
+  void WritePage(pageid_t page_id, char *data, bool new_page, bool write_log);
+  static size_t NodeSize(const Node &node);
+  pageid_t AllocatePage();
+  void WriteMeta(bool new_page, bool write_log = false);
+  // 批量构建时向第 level 层追加子节点，当前节点已满时先写入该节点，并将其插入更上一层
+  void BulkAddChild(std::vector<BulkLevel> &levels, size_t level, const std::string &low_key, pageid_t child,
+                    size_t limit);
+  // 在内存中将节点分裂为两半，node 保留左半部分，返回提升到父节点的分隔键和右半部分
+  static std::pair<std::string, Node> SplitNode(Node &node);
+  // 将分隔键和其右侧的子节点插入内部节点
+  static void InsertChild(Node &node, std::string separator, pageid_t child);
+  // 将节点分裂为两半，右半部分写入新页面，返回提升到父节点的分隔键和新页面号
+  std::pair<std::string, pageid_t> Split(pageid_t page_id, Node &node);
+
+  // 页面按页面号映射到固定数量的乐观锁，不同页面共用一把锁只会带来多余的重试
+  static constexpr size_t LATCH_COUNT = 256;
+
+  BufferPool &buffer_pool_;
+  LogManager &log_manager_;
+  oid_t oid_;
+  oid_t db_oid_;
+  mutable std::array<OptimisticLatch, LATCH_COUNT> latches_;
+  // 保护根节点的页面号，根节点分裂时修改
+  mutable OptimisticLatch root_latch_;
+  std::atomic<pageid_t> root_page_id_;
+  std::atomic<pageid_t> page_count_;
+  // 保护元信息页的写入
+  std::mutex meta_mutex_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,176 @@
+#include "index/index.h"
+
+#include "common/exceptions.h"
+#include "common/sort_key.h"
+
+namespace huadb {
+
+// rid 按大端序编码，使得相同键的索引项按 rid 排列
+static void AppendRid(const Rid &rid, std::string &key) {
+  for (size_t i = sizeof(pageid_t); i-- > 0;) {
+    key.push_back(static_cast<char>((rid.page_id_ >> (i * 8)) & 0xFF));
+  }
+  for (size_t i = sizeof(slotid_t); i-- > 0;) {
+    key.push_back(static_cast<char>((rid.slot_id_ >> (i * 8)) & 0xFF));
+  }
+}
+
+static constexpr size_t RID_SIZE = sizeof(pageid_t) + sizeof(slotid_t);
+
+static Rid ExtractRid(const std::string &key) {
+  Rid rid{0, 0};
+  auto offset = key.size() - RID_SIZE;
+  for (size_t i = 0; i < sizeof(pageid_t); i++) {
+    rid.page_id_ = (rid.page_id_ << 8) | static_cast<uint8_t>(key[offset++]);
+  }
+  for (size_t i = 0; i < sizeof(slotid_t); i++) {
+    rid.slot_id_ = static_cast<slotid_t>((rid.slot_id_ << 8) | static_cast<uint8_t>(key[offset++]));
+  }
+  return rid;
+}
+
+Index::Index(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, std::string name,
+             oid_t table_oid, IndexType index_type, const ColumnList &column_list, std::vector<size_t> key_columns,
+             std::vector<size_t> include_columns, bool new_index)
+    : oid_(oid),
+      name_(std::move(name)),
+      table_oid_(table_oid),
+      index_type_(index_type),
+      key_columns_(std::move(key_columns)),
+      include_columns_(std::move(include_columns)) {
+  if (index_type_ == IndexType::HASH) {
+    hash_table_ = std::make_unique<LinearHashTable>(buffer_pool, log_manager, oid, db_oid, new_index);
+  } else {
+    tree_ = std::make_unique<BPlusTree>(buffer_pool, log_manager, oid, db_oid, new_index);
+  }
+  for (auto col_idx : key_columns_) {
+    types_.push_back(column_list.GetColumn(col_idx).type_);
+  }
+  for (auto col_idx : include_columns_) {
+    types_.push_back(column_list.GetColumn(col_idx).type_);
+  }
+}
+
+void Index::InsertRecord(const Record &record, const Rid &rid) {
+  auto entry = MakeEntry(record, rid);
+  if (hash_table_ != nullptr) {
+    hash_table_->Insert(HashKey(entry.substr(0, entry.size() - RID_SIZE)), entry);
+  } else {
+    tree_->Insert(entry);
+  }
+}
+
+std::string Index::MakeEntry(const Record &record, const Rid &rid) const {
+  // 包含列的编码位于键列之后、rid 之前，不影响按键列前缀的查找
+  std::string entry;
+  for (auto col_idx : key_columns_) {
+    SortKey::Append(record.GetValue(col_idx), false, entry);
+  }
+  for (auto col_idx : include_columns_) {
+    SortKey::Append(record.GetValue(col_idx), false, entry);
+  }
+  AppendRid(rid, entry);
+  return entry;
+}
+
+void Index::BulkLoad(const std::function<bool(std::string &)> &next_entry, size_t fill_factor) {
+  if (hash_table_ == nullptr) {
+    tree_->BulkLoad(next_entry, fill_factor);
+    return;
+  }
+  hash_table_->BulkLoad(
+      [&next_entry](uint64_t &hash, std::string &entry) {
+        if (!next_entry(entry)) {
+          return false;
+        }
+        hash = HashKey(entry.substr(0, entry.size() - RID_SIZE));
+        return true;
+      },
+      fill_factor);
+}
+
+std::vector<Rid> Index::ScanRange(const IndexRange &range) const {
+  std::vector<Rid> rids;
+  Scan(range, [&rids](const std::string &key) { rids.push_back(ExtractRid(key)); });
+  return rids;
+}
+
+std::vector<IndexEntry> Index::ScanEntries(const IndexRange &range) const {
+  std::vector<IndexEntry> entries;
+  Scan(range, [this, &entries](const std::string &key) {
+    IndexEntry entry{ExtractRid(key), {}};
+    size_t offset = 0;
+    for (auto type : types_) {
+      entry.values_.push_back(SortKey::Decode(key, offset, type));
+    }
+    entries.push_back(std::move(entry));
+  });
+  return entries;
+}
+
+void Index::Scan(const IndexRange &range, const std::function<void(const std::string &)> &visit) const {
+  std::string prefix;
+  for (const auto &value : range.equal_values_) {
+    SortKey::Append(value, false, prefix);
+  }
+  if (hash_table_ != nullptr) {
+    if (range.equal_values_.size() != key_columns_.size() || range.lower_.has_value() || range.upper_.has_value()) {
+      throw DbException("Hash index " + name_ + " only supports equality on all key columns");
+    }
+    // 哈希值相同的索引项中，只有键列编码与 prefix 相同的才在范围内
+    hash_table_->Find(HashKey(prefix), [&prefix, &visit](const std::string &entry) {
+      if (entry.size() == prefix.size() + RID_SIZE && entry.compare(0, prefix.size(), prefix) == 0) {
+        visit(entry);
+      }
+    });
+    return;
+  }
+  // 下界和上界都只比较索引项的前缀，NULL 的编码以 1 开头，排在所有非 NULL 值之后
+  auto lower = prefix;
+  bool lower_inclusive = true;
+  if (range.lower_.has_value()) {
+    SortKey::Append(*range.lower_, false, lower);
+    lower_inclusive = range.lower_inclusive_;
+  }
+  auto upper = prefix;
+  bool upper_inclusive = true;
+  if (range.upper_.has_value()) {
+    SortKey::Append(*range.upper_, false, upper);
+    upper_inclusive = range.upper_inclusive_;
+  } else if (range.lower_.has_value()) {
+    upper.push_back(static_cast<char>(1));
+    upper_inclusive = false;
+  }
+
+  for (auto iterator = tree_->Seek(lower, lower_inclusive); !iterator.IsEnd(); iterator.Next()) {
+    const auto &key = iterator.Key();
+    auto result = SortKey::Compare(key.substr(0, upper.size()), upper);
+    if (result > 0 || (result == 0 && !upper_inclusive)) {
+      break;
+    }
+    visit(key);
+  }
+}
+
+oid_t Index::GetOid() const { return oid_; }
+
+const std::string &Index::GetName() const { return name_; }
+
+oid_t Index::GetTableOid() const { return table_oid_; }
+
+IndexType Index::GetIndexType() const { return index_type_; }
+
+const std::vector<size_t> &Index::GetKeyColumns() const { return key_columns_; }
+
+const std::vector<size_t> &Index::GetIncludeColumns() const { return include_columns_; }
+
+uint64_t Index::HashKey(const std::string &key) {
+  // 哈希值保存在索引文件中，使用与实现无关的 FNV-1a，而不是 std::hash
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto c : key) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace huadb
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "catalog/column_list.h"
+#include "common/typedefs.h"
+#include "common/value.h"
+#include "index/b_plus_tree.h"
+#include "index/index_type.h"
+#include "index/linear_hash_table.h"
+#include "table/record.h"
+
+namespace huadb {
+
+// 索引扫描的范围：前若干个键列等于 equal_values_，下一个键列位于 (lower_, upper_) 之间
+// 区间端点为空表示该侧无界，键列为 NULL 的索引项不在任何范围内
+struct IndexRange {
+  std::vector<Value> equal_values_;
+  std::optional<Value> lower_;
+  bool lower_inclusive_ = true;
+  std::optional<Value> upper_;
+  bool upper_inclusive_ = true;
+};
+
+// 索引项中保存的记录，values_ 依次为键列和包含列的值
+struct IndexEntry {
+  Rid rid_;
+  std::vector<Value> values_;
+};
+
+// 表上的二级索引，索引项为键列和包含列的排序键编码加上记录的 rid，因此重复的键也互不相同
+// 包含列（INCLUDE）不参与查找，只用于仅索引扫描时直接从索引项中取值
+// 哈希索引以键列的编码计算哈希值，不支持包含列，只能查找所有键列都给定等值的范围，且不按键的顺序返回
+class Index {
+ public:
+  Index(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, std::string name, oid_t table_oid,
+        IndexType index_type, const ColumnList &column_list, std::vector<size_t> key_columns,
+        std::vector<size_t> include_columns, bool new_index);
+
+  // 为一条记录插入索引项
+  void InsertRecord(const Record &record, const Rid &rid);
+  // 生成记录的索引项，索引项按字节序比较
+  std::string MakeEntry(const Record &record, const Rid &rid) const;
+  // 由按字节序升序排列的索引项批量构建空的索引，见 BPlusTree::BulkLoad 和 LinearHashTable::BulkLoad
+  void BulkLoad(const std::function<bool(std::string &)> &next_entry, size_t fill_factor);
+  // 按键的顺序返回范围内索引项的 rid，对应的记录可能已被删除，需要回表确认
+  std::vector<Rid> ScanRange(const IndexRange &range) const;
+  // 按键的顺序返回范围内的索引项，并解码出键列和包含列的值
+  std::vector<IndexEntry> ScanEntries(const IndexRange &range) const;
+
+  oid_t GetOid() const;
+  const std::string &GetName() const;
+  oid_t GetTableOid() const;
+  IndexType GetIndexType() const;
+  // 键列在表中的下标
+  const std::vector<size_t> &GetKeyColumns() const;
+  // 包含列在表中的下标
+  const std::vector<size_t> &GetIncludeColumns() const;
+
+ private:
+  // 依次访问范围内的索引项
+  void Scan(const IndexRange &range, const std::function<void(const std::string &)> &visit) const;
+  // 键列编码的哈希值
+  static uint64_t HashKey(const std::string &key);
+
+  oid_t oid_;
+  std::string name_;
+  oid_t table_oid_;
+  IndexType index_type_;
+  std::vector<size_t> key_columns_;
+  std::vector<size_t> include_columns_;
+  // 键列和包含列的类型，用于解码索引项
+  std::vector<Type> types_;
+  // 根据索引类型，二者只有一个不为空
+  std::unique_ptr<BPlusTree> tree_;
+  std::unique_ptr<LinearHashTable> hash_table_;
+};
+
+}  // namespace huadb
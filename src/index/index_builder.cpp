@@ -0,0 +1,226 @@
+#include "index/index_builder.h"
+
+#include <algorithm>
+
+#include "common/sort_key.h"
+#include "table/table_page.h"
+
+namespace huadb {
+
+// 一次归并的最大路数
+static constexpr size_t MAX_MERGE_FAN_IN = 64;
+
+IndexBuilder::SharedState::SharedState(BufferPool &buffer_pool, std::shared_ptr<Table> table,
+                                       std::shared_ptr<Index> index, size_t memory_limit)
+    : buffer_pool_(buffer_pool),
+      table_(std::move(table)),
+      index_(std::move(index)),
+      morsel_source_(buffer_pool, table_),
+      memory_limit_(memory_limit) {}
+
+IndexBuilder::IndexBuilder(BufferPool &buffer_pool, std::shared_ptr<Table> table, std::shared_ptr<Index> index,
+                           size_t memory_limit, WorkerPool *worker_pool, size_t worker_count)
+    : worker_pool_(worker_pool), worker_count_(worker_pool == nullptr ? 0 : worker_count) {
+  state_ = std::make_shared<SharedState>(buffer_pool, std::move(table), std::move(index),
+                                         memory_limit / (worker_count_ + 1));
+}
+
+void IndexBuilder::Build(size_t fill_factor) {
+  state_->worker_states_.assign(worker_count_, WorkerState::PENDING);
+  for (size_t i = 0; i < worker_count_; i++) {
+    worker_pool_->Submit([state = state_, i] { RunWorker(state, i); });
+  }
+  try {
+    ScanMorsels(*state_);
+  } catch (...) {
+    std::lock_guard lock(state_->mutex_);
+    if (state_->error_ == nullptr) {
+      state_->error_ = std::current_exception();
+    }
+    state_->cancelled_ = true;
+  }
+  std::vector<SortedRun> runs;
+  {
+    std::unique_lock lock(state_->mutex_);
+    // 所有 morsel 都已被领取，尚未开始的 worker 即使执行也没有输入
+    for (auto &worker_state : state_->worker_states_) {
+      if (worker_state == WorkerState::PENDING) {
+        worker_state = WorkerState::DONE;
+      }
+    }
+    state_->cv_.wait(lock, [this] { return state_->running_count_ == 0; });
+    if (state_->error_ != nullptr) {
+      std::rethrow_exception(state_->error_);
+    }
+    runs = std::move(state_->runs_);
+  }
+
+  ReduceRuns(runs);
+  if (runs.empty()) {
+    state_->index_->BulkLoad([](std::string &) { return false; }, fill_factor);
+    return;
+  }
+  for (auto &run : runs) {
+    Advance(run);
+  }
+  auto tree = MakeTree(runs);
+  state_->index_->BulkLoad(
+      [&runs, &tree](std::string &entry) {
+        auto &run = runs[tree->Winner()];
+        if (run.exhausted_) {
+          return false;
+        }
+        entry = std::move(run.head_);
+        Advance(run);
+        tree->Replay();
+        return true;
+      },
+      fill_factor);
+}
+
+void IndexBuilder::RunWorker(const std::shared_ptr<SharedState> &state, size_t worker_index) {
+  {
+    std::lock_guard lock(state->mutex_);
+    if (state->worker_states_[worker_index] != WorkerState::PENDING) {
+      return;
+    }
+    state->worker_states_[worker_index] = WorkerState::RUNNING;
+    state->running_count_++;
+  }
+  try {
+    ScanMorsels(*state);
+  } catch (...) {
+    std::lock_guard lock(state->mutex_);
+    if (state->error_ == nullptr) {
+      state->error_ = std::current_exception();
+    }
+    state->cancelled_ = true;
+  }
+  std::lock_guard lock(state->mutex_);
+  state->worker_states_[worker_index] = WorkerState::DONE;
+  state->running_count_--;
+  state->cv_.notify_all();
+}
+
+void IndexBuilder::ScanMorsels(SharedState &state) {
+  std::vector<std::string> entries;
+  size_t memory_size = 0;
+  std::vector<pageid_t> morsel_pages;
+  while (true) {
+    {
+      std::lock_guard lock(state.mutex_);
+      if (state.cancelled_) {
+        return;
+      }
+    }
+    if (!state.morsel_source_.Next(morsel_pages)) {
+      break;
+    }
+    for (auto page_id : morsel_pages) {
+      auto table_page = std::make_unique<TablePage>(
+          state.buffer_pool_.GetPage(state.table_->GetDbOid(), state.table_->GetOid(), page_id));
+      for (slotid_t slot_id = 0; slot_id < table_page->GetRecordCount(); slot_id++) {
+        auto record = table_page->GetRecord(slot_id, state.table_->GetColumnList());
+        // 只跳过已物理删除的记录，其余版本是否可见由索引扫描回表时判断
+        if (record->IsDeleted()) {
+          continue;
+        }
+        auto entry = state.index_->MakeEntry(*record, Rid{page_id, slot_id});
+        memory_size += sizeof(std::string) + entry.size();
+        entries.push_back(std::move(entry));
+        if (memory_size > state.memory_limit_) {
+          auto run = SpillRun(entries);
+          memory_size = 0;
+          std::lock_guard lock(state.mutex_);
+          state.runs_.push_back(std::move(run));
+        }
+      }
+    }
+  }
+  // 最后一个归并段留在内存中
+  if (!entries.empty()) {
+    SortEntries(entries);
+    SortedRun run;
+    run.entries_ = std::move(entries);
+    std::lock_guard lock(state.mutex_);
+    state.runs_.push_back(std::move(run));
+  }
+}
+
+void IndexBuilder::SortEntries(std::vector<std::string> &entries) {
+  // 索引项包含 rid，互不相同，不需要稳定排序
+  std::sort(entries.begin(), entries.end(),
+            [](const std::string &lhs, const std::string &rhs) { return SortKey::Compare(lhs, rhs) < 0; });
+}
+
+IndexBuilder::SortedRun IndexBuilder::SpillRun(std::vector<std::string> &entries) {
+  SortEntries(entries);
+  SortedRun run;
+  run.file_ = std::make_shared<SpillFile>();
+  std::vector<Value> values(1);
+  for (auto &entry : entries) {
+    values[0] = Value(std::move(entry));
+    run.file_->Append(values);
+  }
+  run.file_->Rewind();
+  std::vector<std::string>().swap(entries);
+  return run;
+}
+
+void IndexBuilder::Advance(SortedRun &run) {
+  if (run.file_ == nullptr) {
+    if (run.index_ < run.entries_.size()) {
+      run.head_ = std::move(run.entries_[run.index_++]);
+    } else {
+      run.head_.clear();
+      run.exhausted_ = true;
+    }
+    return;
+  }
+  std::vector<Value> values;
+  if (!run.file_->Read(values)) {
+    run.head_.clear();
+    run.exhausted_ = true;
+    return;
+  }
+  run.head_ = values[0].GetValue<std::string>();
+}
+
+std::unique_ptr<IndexBuilder::RunTree> IndexBuilder::MakeTree(std::vector<SortedRun> &runs) {
+  return std::make_unique<RunTree>(runs.size(), [&runs](size_t lhs, size_t rhs) {
+    if (runs[lhs].exhausted_ || runs[rhs].exhausted_) {
+      return !runs[lhs].exhausted_;
+    }
+    return SortKey::Compare(runs[lhs].head_, runs[rhs].head_) < 0;
+  });
+}
+
+void IndexBuilder::ReduceRuns(std::vector<SortedRun> &runs) {
+  while (runs.size() > MAX_MERGE_FAN_IN) {
+    std::vector<SortedRun> merged_runs;
+    for (size_t begin = 0; begin < runs.size(); begin += MAX_MERGE_FAN_IN) {
+      auto end = std::min(begin + MAX_MERGE_FAN_IN, runs.size());
+      std::vector<SortedRun> group(std::make_move_iterator(runs.begin() + begin),
+                                   std::make_move_iterator(runs.begin() + end));
+      for (auto &run : group) {
+        Advance(run);
+      }
+      SortedRun merged;
+      merged.file_ = std::make_shared<SpillFile>();
+      auto tree = MakeTree(group);
+      std::vector<Value> values(1);
+      while (!group[tree->Winner()].exhausted_) {
+        auto &run = group[tree->Winner()];
+        values[0] = Value(std::move(run.head_));
+        merged.file_->Append(values);
+        Advance(run);
+        tree->Replay();
+      }
+      merged.file_->Rewind();
+      merged_runs.push_back(std::move(merged));
+    }
+    runs = std::move(merged_runs);
+  }
+}
+
+}  // namespace huadb
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/worker_pool.h"
+#include "executors/loser_tree.h"
+#include "executors/morsel_source.h"
+#include "index/index.h"
+#include "storage/buffer_pool.h"
+#include "storage/spill_file.h"
+#include "table/table.h"
+
+namespace huadb {
+
+// 为已有数据的表构建索引：并行扫描表生成索引项，外部排序后自底向上批量构建 B+ 树
+// leader 与线程池中的 worker 按 morsel 分担扫描，各自在内存中排序，超出内存预算时写入临时文件作为一个归并段
+// 所有参与者结束后，用败者树归并全部归并段，按序交给 Index::BulkLoad
+class IndexBuilder {
+ public:
+  // memory_limit 为所有参与者共用的内存预算（字节），worker_count 为额外使用的 worker 数
+  IndexBuilder(BufferPool &buffer_pool, std::shared_ptr<Table> table, std::shared_ptr<Index> index,
+               size_t memory_limit, WorkerPool *worker_pool, size_t worker_count);
+
+  // 为表中所有未被物理删除的记录版本生成索引项，可见性由索引扫描回表时判断
+  void Build(size_t fill_factor);
+
+ private:
+  enum class WorkerState { PENDING, RUNNING, DONE };
+
+  // 已排序的归并段，保存在临时文件或内存中
+  struct SortedRun {
+    std::shared_ptr<SpillFile> file_;
+    std::vector<std::string> entries_;
+    size_t index_ = 0;
+    // 归并段的当前索引项
+    std::string head_;
+    bool exhausted_ = false;
+  };
+
+  // leader 与 worker 共享的状态，由 mutex_ 保护
+  struct SharedState {
+    SharedState(BufferPool &buffer_pool, std::shared_ptr<Table> table, std::shared_ptr<Index> index,
+                size_t memory_limit);
+
+    BufferPool &buffer_pool_;
+    std::shared_ptr<Table> table_;
+    std::shared_ptr<Index> index_;
+    MorselSource morsel_source_;
+    // 每个参与者的内存预算
+    size_t memory_limit_;
+    std::mutex mutex_;
+    // worker 结束时通知 leader
+    std::condition_variable cv_;
+    std::vector<WorkerState> worker_states_;
+    size_t running_count_ = 0;
+    bool cancelled_ = false;
+    std::exception_ptr error_;
+    std::vector<SortedRun> runs_;
+  };
+
+  using RunTree = LoserTree<std::function<bool(size_t, size_t)>>;
+
+  static void RunWorker(const std::shared_ptr<SharedState> &state, size_t worker_index);
+  // 领取 morsel 并生成索引项，直至表扫描完或构建取消，产生的归并段加入 state.runs_
+  static void ScanMorsels(SharedState &state);
+  static void SortEntries(std::vector<std::string> &entries);
+  static SortedRun SpillRun(std::vector<std::string> &entries);
+  // 读取归并段的下一个索引项
+  static void Advance(SortedRun &run);
+  static std::unique_ptr<RunTree> MakeTree(std::vector<SortedRun> &runs);
+  // 归并段过多时，每次将相邻的若干个归并段合并为一个，直至可以一次归并完成
+  static void ReduceRuns(std::vector<SortedRun> &runs);
+
+  std::shared_ptr<SharedState> state_;
+  WorkerPool *worker_pool_;
+  size_t worker_count_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "common/exceptions.h"
+
+namespace huadb {
+
+// 索引的存储结构：B+ 树支持等值和范围查找，哈希表只支持全部键列的等值查找
+enum class IndexType { BTREE, HASH };
+
+inline std::string IndexTypeToString(IndexType index_type) {
+  return index_type == IndexType::HASH ? "hash" : "btree";
+}
+
+inline IndexType StringToIndexType(const std::string &index_type) {
+  if (index_type == "btree") {
+    return IndexType::BTREE;
+  }
+  if (index_type == "hash") {
+    return IndexType::HASH;
+  }
+  throw DbException("Unknown index type: " + index_type);
+}
+
+}  // namespace huadb
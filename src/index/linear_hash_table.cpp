@@ -0,0 +1,315 @@
+#include "index/linear_hash_table.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+
+namespace huadb {
+
+// page_lsn(8) + next_page_id(4) + entry_count(2) = 14，每个项为 hash(4) + length(1) + 内容
+static constexpr size_t BUCKET_HEADER_SIZE = sizeof(lsn_t) + sizeof(pageid_t) + sizeof(uint16_t);
+static constexpr size_t ENTRY_HEADER_SIZE = sizeof(uint32_t) + 1;
+static constexpr size_t BUCKET_CAPACITY = DB_PAGE_SIZE - BUCKET_HEADER_SIZE;
+// page_lsn(8) + next_page_id(4)，之后为各个桶首页面的页面号
+static constexpr size_t DIRECTORY_HEADER_SIZE = sizeof(lsn_t) + sizeof(pageid_t);
+static constexpr size_t DIRECTORY_ENTRIES = (DB_PAGE_SIZE - DIRECTORY_HEADER_SIZE) / sizeof(pageid_t);
+static constexpr pageid_t META_PAGE_ID = 0;
+
+LinearHashTable::LinearHashTable(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid,
+                                 bool new_table)
+    : buffer_pool_(buffer_pool), log_manager_(log_manager), oid_(oid), db_oid_(db_oid) {
+  if (new_table) {
+    // 0 号页面为元信息页，1 号页面为目录页，2 号页面为唯一的空桶
+    page_count_ = 3;
+    fill_factor_ = DEFAULT_INDEX_FILL_FACTOR;
+    directory_pages_.push_back(1);
+    buckets_.push_back(2);
+    insert_pages_.push_back(2);
+    WriteMeta(true);
+    WriteDirectoryPage(0, true);
+    WriteBucketPage(buckets_[0], BucketPage(), true);
+    return;
+  }
+  uint32_t bucket_count, fill_factor;
+  pageid_t directory_page_id;
+  {
+    auto page = buffer_pool_.GetPage(db_oid_, oid_, META_PAGE_ID);
+    const char *data = page->GetData() + sizeof(lsn_t);
+    memcpy(&bucket_count, data, sizeof(uint32_t));
+    memcpy(&page_count_, data + 4, sizeof(pageid_t));
+    memcpy(&data_size_, data + 8, sizeof(uint64_t));
+    memcpy(&fill_factor, data + 16, sizeof(uint32_t));
+    memcpy(&directory_page_id, data + 20, sizeof(pageid_t));
+  }
+  fill_factor_ = fill_factor;
+  while (buckets_.size() < bucket_count) {
+    directory_pages_.push_back(directory_page_id);
+    auto page = buffer_pool_.GetPage(db_oid_, oid_, directory_page_id);
+    const char *data = page->GetData();
+    memcpy(&directory_page_id, data + sizeof(lsn_t), sizeof(pageid_t));
+    for (size_t i = 0; i < DIRECTORY_ENTRIES && buckets_.size() < bucket_count; i++) {
+      pageid_t page_id;
+      memcpy(&page_id, data + DIRECTORY_HEADER_SIZE + i * sizeof(pageid_t), sizeof(pageid_t));
+      buckets_.push_back(page_id);
+    }
+  }
+  insert_pages_.assign(buckets_.size(), NULL_PAGE_ID);
+}
+
+void LinearHashTable::Insert(uint64_t hash, const std::string &entry) {
+  if (entry.size() > MAX_INDEX_KEY_SIZE) {
+    throw DbException("Index key size too large: " + std::to_string(entry.size()));
+  }
+  std::unique_lock lock(mutex_);
+  InsertLocked(static_cast<uint32_t>(hash), entry);
+}
+
+void LinearHashTable::Find(uint64_t hash, const std::function<void(const std::string &)> &visit) const {
+  std::shared_lock lock(mutex_);
+  auto hash32 = static_cast<uint32_t>(hash);
+  for (auto page_id = buckets_[BucketOf(hash32)]; page_id != NULL_PAGE_ID;) {
+    auto bucket_page = ReadBucketPage(page_id);
+    for (const auto &[entry_hash, entry] : bucket_page.entries_) {
+      if (entry_hash == hash32) {
+        visit(entry);
+      }
+    }
+    page_id = bucket_page.next_page_id_;
+  }
+}
+
+void LinearHashTable::BulkLoad(const std::function<bool(uint64_t &, std::string &)> &next_entry,
+                               size_t fill_factor) {
+  std::unique_lock lock(mutex_);
+  fill_factor_ = fill_factor;
+  uint64_t hash;
+  std::string entry;
+  while (next_entry(hash, entry)) {
+    if (entry.size() > MAX_INDEX_KEY_SIZE) {
+      throw DbException("Index key size too large: " + std::to_string(entry.size()));
+    }
+    InsertLocked(static_cast<uint32_t>(hash), entry);
+  }
+  WriteMeta(false);
+  // 桶的分裂会改写已有的页面，因此全部插入完成后再将每个页面写一次日志
+  char data[DB_PAGE_SIZE];
+  for (pageid_t page_id = 0; page_id < page_count_; page_id++) {
+    memcpy(data, buffer_pool_.GetPage(db_oid_, oid_, page_id)->GetData(), DB_PAGE_SIZE);
+    WritePage(page_id, data, false, true);
+  }
+}
+
+void LinearHashTable::InsertLocked(uint32_t hash, const std::string &entry) {
+  // 只读写桶中接收新项的页面，不遍历整个桶
+  auto bucket = BucketOf(hash);
+  auto page_id = InsertPageOf(bucket);
+  auto bucket_page = ReadBucketPage(page_id);
+  bool new_page = false;
+  if (PageSize(bucket_page) + ENTRY_HEADER_SIZE + entry.size() > DB_PAGE_SIZE) {
+    // 页面已满时使用之后的空页面，没有时在链表末尾追加溢出页
+    if (bucket_page.next_page_id_ == NULL_PAGE_ID) {
+      bucket_page.next_page_id_ = AllocatePage();
+      new_page = true;
+      WriteBucketPage(page_id, bucket_page, false);
+    }
+    page_id = bucket_page.next_page_id_;
+    bucket_page = new_page ? BucketPage() : ReadBucketPage(page_id);
+    insert_pages_[bucket] = page_id;
+  }
+  bucket_page.entries_.emplace_back(hash, entry);
+  WriteBucketPage(page_id, bucket_page, new_page);
+  data_size_ += ENTRY_HEADER_SIZE + entry.size();
+  if (data_size_ * 100 > buckets_.size() * BUCKET_CAPACITY * fill_factor_) {
+    Split();
+  }
+  WriteMeta(false);
+}
+
+size_t LinearHashTable::BucketOf(uint32_t hash) const {
+  size_t low = 1;
+  while (low * 2 <= buckets_.size()) {
+    low *= 2;
+  }
+  size_t bucket = hash & (low * 2 - 1);
+  return bucket < buckets_.size() ? bucket : hash & (low - 1);
+}
+
+pageid_t LinearHashTable::InsertPageOf(size_t bucket) {
+  if (insert_pages_[bucket] == NULL_PAGE_ID) {
+    auto page_id = buckets_[bucket];
+    insert_pages_[bucket] = page_id;
+    while (page_id != NULL_PAGE_ID) {
+      auto bucket_page = ReadBucketPage(page_id);
+      if (!bucket_page.entries_.empty()) {
+        insert_pages_[bucket] = page_id;
+      }
+      page_id = bucket_page.next_page_id_;
+    }
+  }
+  return insert_pages_[bucket];
+}
+
+LinearHashTable::BucketPage LinearHashTable::ReadBucketPage(pageid_t page_id) const {
+  auto page = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+  const char *data = page->GetData();
+  BucketPage bucket_page;
+  uint16_t entry_count;
+  memcpy(&bucket_page.next_page_id_, data + sizeof(lsn_t), sizeof(pageid_t));
+  memcpy(&entry_count, data + sizeof(lsn_t) + sizeof(pageid_t), sizeof(uint16_t));
+  size_t offset = BUCKET_HEADER_SIZE;
+  bucket_page.entries_.reserve(entry_count);
+  for (uint16_t i = 0; i < entry_count; i++) {
+    uint32_t hash;
+    memcpy(&hash, data + offset, sizeof(uint32_t));
+    auto length = static_cast<uint8_t>(data[offset + sizeof(uint32_t)]);
+    bucket_page.entries_.emplace_back(hash, std::string(data + offset + ENTRY_HEADER_SIZE, length));
+    offset += ENTRY_HEADER_SIZE + length;
+  }
+  return bucket_page;
+}
+
+void LinearHashTable::WriteBucketPage(pageid_t page_id, const BucketPage &bucket_page, bool new_page) {
+  char data[DB_PAGE_SIZE] = {};
+  auto entry_count = static_cast<uint16_t>(bucket_page.entries_.size());
+  memcpy(data + sizeof(lsn_t), &bucket_page.next_page_id_, sizeof(pageid_t));
+  memcpy(data + sizeof(lsn_t) + sizeof(pageid_t), &entry_count, sizeof(uint16_t));
+  size_t offset = BUCKET_HEADER_SIZE;
+  for (const auto &[hash, entry] : bucket_page.entries_) {
+    memcpy(data + offset, &hash, sizeof(uint32_t));
+    data[offset + sizeof(uint32_t)] = static_cast<char>(entry.size());
+    memcpy(data + offset + ENTRY_HEADER_SIZE, entry.data(), entry.size());
+    offset += ENTRY_HEADER_SIZE + entry.size();
+  }
+  WritePage(page_id, data, new_page);
+}
+
+size_t LinearHashTable::PageSize(const BucketPage &bucket_page) {
+  size_t size = BUCKET_HEADER_SIZE;
+  for (const auto &[hash, entry] : bucket_page.entries_) {
+    size += ENTRY_HEADER_SIZE + entry.size();
+  }
+  return size;
+}
+
+void LinearHashTable::Split() {
+  size_t low = 1;
+  while (low * 2 <= buckets_.size()) {
+    low *= 2;
+  }
+  auto split_bucket = buckets_.size() - low;
+  // 按 h mod 2^(level+1) 将被分裂桶中的项分为留在原桶和移入新桶的两部分，各自依次装入页面
+  std::vector<BucketPage> stay_pages(1), move_pages(1);
+  std::vector<pageid_t> old_page_ids;
+  for (auto page_id = buckets_[split_bucket]; page_id != NULL_PAGE_ID;) {
+    old_page_ids.push_back(page_id);
+    auto bucket_page = ReadBucketPage(page_id);
+    for (auto &[hash, entry] : bucket_page.entries_) {
+      auto &pages = (hash & (low * 2 - 1)) == split_bucket ? stay_pages : move_pages;
+      if (PageSize(pages.back()) + ENTRY_HEADER_SIZE + entry.size() > DB_PAGE_SIZE) {
+        pages.emplace_back();
+      }
+      pages.back().entries_.emplace_back(hash, std::move(entry));
+    }
+    page_id = bucket_page.next_page_id_;
+  }
+  // 原桶的页面依次复用，不足时分配新页面，剩余的页面作为空的溢出页接在新桶之后
+  size_t reused = 0;
+  auto assign_pages = [&](size_t page_count) {
+    std::vector<std::pair<pageid_t, bool>> page_ids;
+    for (size_t i = 0; i < page_count; i++) {
+      if (reused < old_page_ids.size()) {
+        page_ids.emplace_back(old_page_ids[reused++], false);
+      } else {
+        page_ids.emplace_back(AllocatePage(), true);
+      }
+    }
+    return page_ids;
+  };
+  auto stay_page_ids = assign_pages(stay_pages.size());
+  auto move_page_ids = assign_pages(move_pages.size());
+  insert_pages_[split_bucket] = stay_page_ids.back().first;
+  auto move_insert_page_id = move_page_ids.back().first;
+  while (reused < old_page_ids.size()) {
+    move_pages.emplace_back();
+    move_page_ids.emplace_back(old_page_ids[reused++], false);
+  }
+  WriteChain(stay_page_ids, stay_pages);
+  WriteChain(move_page_ids, move_pages);
+  AppendBucket(move_page_ids[0].first);
+  insert_pages_.push_back(move_insert_page_id);
+}
+
+void LinearHashTable::WriteChain(const std::vector<std::pair<pageid_t, bool>> &page_ids,
+                                 std::vector<BucketPage> &bucket_pages) {
+  for (size_t i = 0; i < bucket_pages.size(); i++) {
+    bucket_pages[i].next_page_id_ = i + 1 < bucket_pages.size() ? page_ids[i + 1].first : NULL_PAGE_ID;
+    WriteBucketPage(page_ids[i].first, bucket_pages[i], page_ids[i].second);
+  }
+}
+
+void LinearHashTable::AppendBucket(pageid_t page_id) {
+  buckets_.push_back(page_id);
+  auto directory_index = (buckets_.size() - 1) / DIRECTORY_ENTRIES;
+  if (directory_index < directory_pages_.size()) {
+    WriteDirectoryPage(directory_index, false);
+    return;
+  }
+  // 当前的目录页已满，分配新的目录页并链接到上一个目录页之后
+  directory_pages_.push_back(AllocatePage());
+  WriteDirectoryPage(directory_index, true);
+  WriteDirectoryPage(directory_index - 1, false);
+}
+
+void LinearHashTable::WriteDirectoryPage(size_t directory_index, bool new_page) {
+  char data[DB_PAGE_SIZE] = {};
+  pageid_t next_page_id =
+      directory_index + 1 < directory_pages_.size() ? directory_pages_[directory_index + 1] : NULL_PAGE_ID;
+  memcpy(data + sizeof(lsn_t), &next_page_id, sizeof(pageid_t));
+  for (size_t i = directory_index * DIRECTORY_ENTRIES;
+       i < buckets_.size() && i < (directory_index + 1) * DIRECTORY_ENTRIES; i++) {
+    memcpy(data + DIRECTORY_HEADER_SIZE + (i % DIRECTORY_ENTRIES) * sizeof(pageid_t), &buckets_[i],
+           sizeof(pageid_t));
+  }
+  WritePage(directory_pages_[directory_index], data, new_page);
+}
+
+void LinearHashTable::WriteMeta(bool new_page) {
+  // bucket_count(4) + page_count(4) + data_size(8) + fill_factor(4) + directory_page_id(4)
+  char data[DB_PAGE_SIZE] = {};
+  auto bucket_count = static_cast<uint32_t>(buckets_.size());
+  auto fill_factor = static_cast<uint32_t>(fill_factor_);
+  char *meta = data + sizeof(lsn_t);
+  memcpy(meta, &bucket_count, sizeof(uint32_t));
+  memcpy(meta + 4, &page_count_, sizeof(pageid_t));
+  memcpy(meta + 8, &data_size_, sizeof(uint64_t));
+  memcpy(meta + 16, &fill_factor, sizeof(uint32_t));
+  memcpy(meta + 20, &directory_pages_[0], sizeof(pageid_t));
+  WritePage(META_PAGE_ID, data, new_page);
+}
+
+void LinearHashTable::WritePage(pageid_t page_id, char *data, bool new_page, bool write_log) {
+  if (write_log) {
+    log_manager_.AppendPageImageLog(DDL_XID, oid_, db_oid_, page_id, data);
+  } else {
+    // 与 BPlusTree::WritePage 相同，不写日志时 page lsn 取已追加日志的 lsn 上界
+    lsn_t lsn = log_manager_.GetNextLSN() - 1;
+    memcpy(data, &lsn, sizeof(lsn_t));
+  }
+  auto page = new_page ? buffer_pool_.NewPage(db_oid_, oid_, page_id) : buffer_pool_.GetPage(db_oid_, oid_, page_id);
+  while (true) {
+    memcpy(page->GetData(), data, DB_PAGE_SIZE);
+    page->SetDirty();
+    // buffer pool 不固定页面，写入后页面已被换出时重新读入再写一次，见 BPlusTree::WritePage
+    auto current = buffer_pool_.GetPage(db_oid_, oid_, page_id);
+    if (current == page) {
+      return;
+    }
+    page = std::move(current);
+  }
+}
+
+pageid_t LinearHashTable::AllocatePage() { return page_count_++; }
+
+}  // namespace huadb
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/typedefs.h"
+#include "log/log_manager.h"
+#include "storage/buffer_pool.h"
+
+namespace huadb {
+
+// 存储在独立文件中的线性哈希表，通过 buffer pool 读写页面
+// 表中的项为调用方给出的字节串及其哈希值，哈希值相同的项由调用方比较内容区分
+// 0 号页面为元信息页，之后为目录页、桶的首页面和溢出页。目录页组成链表，依次记录各个桶首页面的页面号
+// 桶数为 n 且 2^level <= n < 2^(level+1) 时，哈希值 h 位于 h mod 2^(level+1) 号桶，该值不小于 n 时位于 h mod 2^level 号桶
+// 项的平均占用超过填充上限时分裂 n - 2^level 号桶，其中的项按 h mod 2^(level+1) 分到原桶和新增的 n 号桶
+// 与 B+ 树相同，删除记录时不删除项，因此桶中只有最后一个非空页面之后还有空间，新项总是追加到该页面
+// 读者加共享锁，写者加排他锁；逐个插入的修改不写日志，批量构建后整页写日志
+class LinearHashTable {
+ public:
+  LinearHashTable(BufferPool &buffer_pool, LogManager &log_manager, oid_t oid, oid_t db_oid, bool new_table);
+
+  // 插入项，项中带有记录的 rid，调用方保证不插入相同的项
+  void Insert(uint64_t hash, const std::string &entry);
+  // 依次访问哈希值为 hash 的项，可能包含哈希值的低 32 位相同的其他项
+  void Find(uint64_t hash, const std::function<void(const std::string &)> &visit) const;
+  // 插入 next_entry 给出的全部项，之后的插入按 fill_factor 决定何时分裂，最后将所有页面整页写日志
+  // 调用时表必须为空，且没有其他线程访问
+  void BulkLoad(const std::function<bool(uint64_t &, std::string &)> &next_entry, size_t fill_factor);
+
+ private:
+  // 桶中的一个页面，entries_ 为项的哈希值的低 32 位和内容
+  struct BucketPage {
+    pageid_t next_page_id_ = NULL_PAGE_ID;
+    std::vector<std::pair<uint32_t, std::string>> entries_;
+  };
+
+  void InsertLocked(uint32_t hash, const std::string &entry);
+  size_t BucketOf(uint32_t hash) const;
+  // 返回桶中接收新项的页面，即最后一个非空页面，桶为空时为首页面
+  pageid_t InsertPageOf(size_t bucket);
+  BucketPage ReadBucketPage(pageid_t page_id) const;
+  void WriteBucketPage(pageid_t page_id, const BucketPage &bucket_page, bool new_page);
+  static size_t PageSize(const BucketPage &bucket_page);
+  // 将 bucket_pages 依次写入 page_ids 中的页面并连成链表，page_ids 中的 bool 表示是否为新分配的页面
+  void WriteChain(const std::vector<std::pair<pageid_t, bool>> &page_ids, std::vector<BucketPage> &bucket_pages);
+  void Split();
+  // 在目录末尾追加桶的首页面号
+  void AppendBucket(pageid_t page_id);
+  void WriteDirectoryPage(size_t directory_index, bool new_page);
+  void WriteMeta(bool new_page);
+  // write_log: 是否整页写日志，仅批量构建时写日志
+  void WritePage(pageid_t page_id, char *data, bool new_page, bool write_log = false);
+  pageid_t AllocatePage();
+
+  BufferPool &buffer_pool_;
+  LogManager &log_manager_;
+  oid_t oid_;
+  oid_t db_oid_;
+  mutable std::shared_mutex mutex_;
+  // 各个桶首页面的页面号
+  std::vector<pageid_t> buckets_;
+  // 各个桶接收新项的页面，打开已有的表后首次插入时沿页面链表查找，之前为 NULL_PAGE_ID
+  std::vector<pageid_t> insert_pages_;
+  std::vector<pageid_t> directory_pages_;
+  pageid_t page_count_;
+  // 所有项占用的字节数，用于判断是否分裂
+  uint64_t data_size_ = 0;
+  size_t fill_factor_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace huadb {
+
+// 乐观锁：版本号的最低位表示是否被写者持有，写锁释放时版本号增加
+// 读者不加锁，读取前记下版本号，读取后校验版本号未变化，否则重新读取，因此读者之间互不阻塞
+class OptimisticLatch {
+ public:
+  // 等待写者释放后返回当前版本号
+  uint64_t ReadLock() const {
+    while (true) {
+      auto version = version_.load(std::memory_order_acquire);
+      if ((version & 1) == 0) {
+        return version;
+      }
+      std::this_thread::yield();
+    }
+  }
+  // 自 ReadLock 返回 version 以来没有写者修改过时返回 true
+  bool Validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+  // 版本号仍为 version 时获取写锁，不等待
+  bool TryUpgrade(uint64_t version) {
+    return version_.compare_exchange_strong(version, version + 1, std::memory_order_acquire);
+  }
+  void WriteUnlock() { version_.fetch_add(1, std::memory_order_release); }
+
+ private:
+  std::atomic<uint64_t> version_ = 0;
+};
+
+}  // namespace huadb
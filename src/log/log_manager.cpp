@@ -83,6 +83,25 @@ lsn_t LogManager::AppendNewPageLog(xid_t xid, oid_t oid, pageid_t prev_page_id,
   return lsn;
 }
 
+lsn_t LogManager::AppendPageImageLog(xid_t xid, oid_t oid, oid_t db_oid, pageid_t page_id, char *image) {
+  if (xid != DDL_XID && att_.find(xid) == att_.end()) {
+    throw DbException(std::to_string(xid) + " does not exist in att (in AppendPageImageLog)");
+  }
+  lsn_t lsn = next_lsn_;
+  memcpy(image, &lsn, sizeof(lsn_t));
+  auto log = std::make_shared<PageImageLog>(xid, xid == DDL_XID ? NULL_LSN : att_[xid], oid, db_oid, page_id, image);
+  next_lsn_ += log->GetSize();
+  log->SetLSN(lsn);
+  if (xid != DDL_XID) {
+    att_[xid] = lsn;
+  }
+  log_buffer_.push_back(std::move(log));
+  if (dpt_.find({oid, page_id}) == dpt_.end()) {
+    dpt_[{oid, page_id}] = lsn;
+  }
+  return lsn;
+}
+
 lsn_t LogManager::AppendBeginLog(xid_t xid) {
   if (att_.find(xid) != att_.end()) {
     throw DbException(std::to_string(xid) + " already exists in att");
@@ -36,6 +36,8 @@ class LogManager {
                         char *new_record);
   lsn_t AppendDeleteLog(xid_t xid, oid_t oid, pageid_t page_id, slotid_t slot_id);
   lsn_t AppendNewPageLog(xid_t xid, oid_t oid, pageid_t prev_page_id, pageid_t page_id);
+  // 记录整个页面的内容，image 的前 8 个字节（page lsn）在追加时被设置为日志的 lsn
+  lsn_t AppendPageImageLog(xid_t xid, oid_t oid, oid_t db_oid, pageid_t page_id, char *image);
   lsn_t AppendBeginLog(xid_t xid);
   lsn_t AppendCommitLog(xid_t xid);
   lsn_t AppendRollbackLog(xid_t xid);
@@ -29,6 +29,8 @@ std::shared_ptr<LogRecord> LogRecord::DeserializeFrom(const char *data) {
       return DeleteLog::DeserializeFrom(data + sizeof(type));
     case LogType::NEW_PAGE:
       return NewPageLog::DeserializeFrom(data + sizeof(type));
+    case LogType::PAGE_IMAGE:
+      return PageImageLog::DeserializeFrom(data + sizeof(type));
     case LogType::BEGIN:
       return BeginLog::DeserializeFrom(data + sizeof(type));
     case LogType::COMMIT:
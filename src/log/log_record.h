@@ -21,6 +21,7 @@ enum class LogType {
   NEW_PAGE,
   BEGIN_CHECKPOINT,
   END_CHECKPOINT,
+  PAGE_IMAGE,
 };
 
 class LogRecord {
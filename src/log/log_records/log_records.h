@@ -7,4 +7,5 @@
 #include "log/log_records/end_checkpoint_log.h"
 #include "log/log_records/insert_log.h"
 #include "log/log_records/new_page_log.h"
+#include "log/log_records/page_image_log.h"
 #include "log/log_records/rollback_log.h"
@@ -0,0 +1,67 @@
+#include "log/log_records/page_image_log.h"
+
+#include "log/log_manager.h"
+
+namespace huadb {
+
+PageImageLog::PageImageLog(xid_t xid, lsn_t prev_lsn, oid_t oid, oid_t db_oid, pageid_t page_id, const char *image)
+    : LogRecord(LogType::PAGE_IMAGE, xid, prev_lsn), oid_(oid), db_oid_(db_oid), page_id_(page_id) {
+  memcpy(image_, image, DB_PAGE_SIZE);
+  size_ += sizeof(oid_) + sizeof(db_oid_) + sizeof(page_id_) + DB_PAGE_SIZE;
+}
+
+size_t PageImageLog::SerializeTo(char *data) const {
+  size_t offset = LogRecord::SerializeTo(data);
+  memcpy(data + offset, &oid_, sizeof(oid_));
+  offset += sizeof(oid_);
+  memcpy(data + offset, &db_oid_, sizeof(db_oid_));
+  offset += sizeof(db_oid_);
+  memcpy(data + offset, &page_id_, sizeof(page_id_));
+  offset += sizeof(page_id_);
+  memcpy(data + offset, image_, DB_PAGE_SIZE);
+  offset += DB_PAGE_SIZE;
+  assert(offset == size_);
+  return offset;
+}
+
+std::shared_ptr<PageImageLog> PageImageLog::DeserializeFrom(const char *data) {
+  xid_t xid;
+  lsn_t prev_lsn;
+  oid_t oid, db_oid;
+  pageid_t page_id;
+  size_t offset = 0;
+  memcpy(&xid, data + offset, sizeof(xid));
+  offset += sizeof(xid);
+  memcpy(&prev_lsn, data + offset, sizeof(prev_lsn));
+  offset += sizeof(prev_lsn);
+  memcpy(&oid, data + offset, sizeof(oid));
+  offset += sizeof(oid);
+  memcpy(&db_oid, data + offset, sizeof(db_oid));
+  offset += sizeof(db_oid);
+  memcpy(&page_id, data + offset, sizeof(page_id));
+  offset += sizeof(page_id);
+  return std::make_shared<PageImageLog>(xid, prev_lsn, oid, db_oid, page_id, data + offset);
+}
+
+void PageImageLog::Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t lsn) {
+  // 如果 oid_ 不存在，表示该表或索引已经被删除，无需 redo
+  if (!catalog.TableExists(oid_)) {
+    return;
+  }
+  auto page = buffer_pool.GetPage(db_oid_, oid_, page_id_);
+  lsn_t page_lsn;
+  memcpy(&page_lsn, page->GetData(), sizeof(lsn_t));
+  if (page_lsn >= lsn) {
+    return;
+  }
+  // 页面内容的前 8 个字节为 page lsn，日志中记录的已经是写入时的 lsn
+  memcpy(page->GetData(), image_, DB_PAGE_SIZE);
+  page->SetDirty();
+  log_manager.IncrementRedoCount();
+}
+
+oid_t PageImageLog::GetOid() const { return oid_; }
+
+pageid_t PageImageLog::GetPageId() const { return page_id_; }
+
+}  // namespace huadb
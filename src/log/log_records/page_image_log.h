@@ -0,0 +1,27 @@
+#pragma once
+
+#include "log/log_record.h"
+
+namespace huadb {
+
+// 整个页面内容的日志，用于批量构建索引等一次写满整个页面的操作，redo 时直接覆盖页面，不需要 undo
+class PageImageLog : public LogRecord {
+ public:
+  PageImageLog(xid_t xid, lsn_t prev_lsn, oid_t oid, oid_t db_oid, pageid_t page_id, const char *image);
+
+  size_t SerializeTo(char *data) const override;
+  static std::shared_ptr<PageImageLog> DeserializeFrom(const char *data);
+
+  void Redo(BufferPool &buffer_pool, Catalog &catalog, LogManager &log_manager, lsn_t lsn) override;
+
+  oid_t GetOid() const;
+  pageid_t GetPageId() const;
+
+ private:
+  oid_t oid_;
+  oid_t db_oid_;
+  pageid_t page_id_;
+  char image_[DB_PAGE_SIZE];
+};
+
+}  // namespace huadb
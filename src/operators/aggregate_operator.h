@@ -6,21 +6,32 @@
 
 namespace huadb {
 
-enum class AggregateType { AVG, COUNT_STAR, COUNT, SUM, MIN, MAX };
+enum class AggregateType { AVG, COUNT_STAR, COUNT, SUM, MIN, MAX, APPROX_COUNT_DISTINCT };
+
+// SIMPLE 直接输出聚集结果
+// PARTIAL 输出分组列和各聚集函数的中间状态，FINAL 的输入为 PARTIAL 的输出，合并中间状态后输出聚集结果
+enum class AggregateMode { SIMPLE, PARTIAL, FINAL };
+
+// HASH 使用哈希表分组；SORT 要求输入已按分组列有序，分组列的值变化时输出当前分组
+enum class AggregateAlgorithm { HASH, SORT };
 
 class AggregateOperator : public Operator {
  public:
   AggregateOperator(std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> child,
                     std::vector<std::shared_ptr<OperatorExpression>> group_bys,
                     std::vector<std::shared_ptr<OperatorExpression>> aggregates, std::vector<bool> is_distincts,
-                    std::vector<AggregateType> aggregate_types)
+                    std::vector<AggregateType> aggregate_types, AggregateMode mode = AggregateMode::SIMPLE)
       : Operator(OperatorType::AGGREGATE, std::move(column_list), {std::move(child)}),
         group_bys_(std::move(group_bys)),
         aggregates_(std::move(aggregates)),
         is_distincts_(std::move(is_distincts)),
-        aggregate_types_(std::move(aggregate_types)) {}
+        aggregate_types_(std::move(aggregate_types)),
+        mode_(mode) {}
   std::string ToString(size_t indent_num = 0) const override {
-    return fmt::format("{}Aggregate:\n{}", std::string(indent_num * 2, ' '), children_[0]->ToString(indent_num + 1));
+    const char *mode = mode_ == AggregateMode::PARTIAL ? " (partial)" : mode_ == AggregateMode::FINAL ? " (final)" : "";
+    return fmt::format("{}{}Aggregate{}:\n{}", std::string(indent_num * 2, ' '),
+                       algorithm_ == AggregateAlgorithm::SORT ? "Stream" : "", mode,
+                       children_[0]->ToString(indent_num + 1));
   }
 
   const std::vector<std::shared_ptr<OperatorExpression>> &GetGroupBys() const { return group_bys_; }
@@ -31,6 +42,10 @@ class AggregateOperator : public Operator {
   std::vector<std::shared_ptr<OperatorExpression>> aggregates_;
   std::vector<bool> is_distincts_;
   std::vector<AggregateType> aggregate_types_;
+  // FINAL 模式下 aggregates_ 不再求值，只用于确定聚集函数的参数类型
+  AggregateMode mode_;
+  // 由优化器根据输入的有序性选择
+  AggregateAlgorithm algorithm_ = AggregateAlgorithm::HASH;
 };
 
 }  // namespace huadb
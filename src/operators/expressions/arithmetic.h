@@ -11,7 +11,12 @@ class Arithmetic : public OperatorExpression {
  public:
   Arithmetic(ArithmeticType type, std::shared_ptr<OperatorExpression> left, std::shared_ptr<OperatorExpression> right)
       : OperatorExpression(OperatorExpressionType::ARITHMETIC, {std::move(left), std::move(right)}, Type::INT),
-        type_(type) {}
+        type_(type) {
+    // 整数与浮点数运算时整数转换为浮点数，结果为浮点数
+    if (children_[0]->GetValueType() == Type::DOUBLE || children_[1]->GetValueType() == Type::DOUBLE) {
+      value_type_ = Type::DOUBLE;
+    }
+  }
 
   Value Evaluate(std::shared_ptr<const Record> record) override {
     Value lhs = children_[0]->Evaluate(record);
@@ -26,6 +31,7 @@ class Arithmetic : public OperatorExpression {
   }
 
   std::string ToString() const override { return fmt::format("{} {} {}", children_[0], type_, children_[1]); }
+  ArithmeticType GetArithmeticType() const { return type_; }
 
  private:
   ArithmeticType type_;
@@ -33,14 +39,18 @@ class Arithmetic : public OperatorExpression {
     if (lhs.IsNull() || rhs.IsNull()) {
       return Value();
     }
-    switch (lhs.GetType()) {
-      case Type::INT:
-        return Value(DoOperation(lhs.GetValue<int32_t>(), rhs.GetValue<int32_t>()));
-      case Type::DOUBLE:
-        return Value(DoOperation(lhs.GetValue<double>(), rhs.GetValue<double>()));
-      default:
-        throw DbException("Type unsupported for arithmetic operation");
+    if (lhs.GetType() == Type::INT && rhs.GetType() == Type::INT) {
+      return Value(DoOperation(lhs.GetValue<int32_t>(), rhs.GetValue<int32_t>()));
     }
+    if ((lhs.GetType() == Type::INT || lhs.GetType() == Type::DOUBLE) &&
+        (rhs.GetType() == Type::INT || rhs.GetType() == Type::DOUBLE)) {
+      return Value(DoOperation(ToDouble(lhs), ToDouble(rhs)));
+    }
+    throw DbException("Type unsupported for arithmetic operation");
+  }
+
+  static double ToDouble(const Value &value) {
+    return value.GetType() == Type::INT ? value.GetValue<int32_t>() : value.GetValue<double>();
   }
 
   template <typename T>
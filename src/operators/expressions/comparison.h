@@ -5,8 +5,10 @@
 #include <regex>
 
 #include "common/exceptions.h"
+#include "common/value_set.h"
 #include "fmt/format.h"
 #include "operators/expressions/expression.h"
+#include "operators/expressions/list.h"
 
 namespace huadb {
 
@@ -29,22 +31,78 @@ class Comparison : public OperatorExpression {
  public:
   Comparison(ComparisonType type, std::shared_ptr<OperatorExpression> left, std::shared_ptr<OperatorExpression> right)
       : OperatorExpression(OperatorExpressionType::COMPARISON, {std::move(left), std::move(right)}, Type::BOOL),
-        type_(type) {}
+        type_(type) {
+    if (type_ == ComparisonType::IN || type_ == ComparisonType::NOT_IN) {
+      in_set_ = BuildInSet(*children_[1]);
+    }
+  }
   Value Evaluate(std::shared_ptr<const Record> record) override {
     Value lhs = children_[0]->Evaluate(record);
+    if (in_set_ != nullptr) {
+      return ComputeIn(lhs);
+    }
     Value rhs = children_[1]->Evaluate(record);
     return Compute(lhs, rhs);
   }
   Value EvaluateJoin(std::shared_ptr<const Record> left, std::shared_ptr<const Record> right) override {
     Value lhs = children_[0]->EvaluateJoin(left, right);
+    if (in_set_ != nullptr) {
+      return ComputeIn(lhs);
+    }
     Value rhs = children_[1]->EvaluateJoin(left, right);
     return Compute(lhs, rhs);
   }
   std::string ToString() const override { return fmt::format("{} {} {}", children_[0], type_, children_[1]); }
-  ComparisonType GetComparisonType() { return type_; }
+  ComparisonType GetComparisonType() const { return type_; }
 
  private:
   ComparisonType type_;
+  // IN 列表全部为同类型非空常量时，在生成查询计划时预先构建的集合
+  std::shared_ptr<const ValueSet> in_set_;
+
+  static std::shared_ptr<const ValueSet> BuildInSet(const OperatorExpression &rhs) {
+    if (rhs.GetExprType() != OperatorExpressionType::LIST) {
+      return nullptr;
+    }
+    const auto &exprs = dynamic_cast<const List &>(rhs).exprs_;
+    if (exprs.empty()) {
+      return nullptr;
+    }
+    std::vector<Value> values;
+    for (const auto &expr : exprs) {
+      if (expr->GetExprType() != OperatorExpressionType::CONST) {
+        return nullptr;
+      }
+      values.push_back(expr->Evaluate(nullptr));
+    }
+    if (values[0].IsNull() || !ValueSet::Supports(values[0].GetType())) {
+      return nullptr;
+    }
+    auto set = std::make_shared<ValueSet>(values[0].GetType());
+    for (const auto &value : values) {
+      if (value.IsNull() || !set->Matches(value)) {
+        return nullptr;
+      }
+      set->Insert(value);
+    }
+    return set;
+  }
+
+  Value ComputeIn(const Value &lhs) {
+    if (lhs.IsNull()) {
+      return Value();
+    }
+    if (!in_set_->Matches(lhs)) {
+      throw DbException("Type unsupported for comparison operation (in)");
+    }
+    bool in_list = in_set_->Contains(lhs);
+    if (type_ == ComparisonType::IN) {
+      return Value(in_list);
+    } else {
+      return Value(!in_list);
+    }
+  }
+
   Value Compute(const Value &lhs, const Value &rhs) {
     if (lhs.IsNull() || rhs.IsNull()) {
       return Value();
@@ -1,9 +1,10 @@
 #pragma once
 
+#include <deque>
+
 #include "common/exceptions.h"
-#include "common/string_util.h"
-#include "common/type_util.h"
 #include "fmt/ranges.h"
+#include "function/function_registry.h"
 #include "operators/expressions/expression.h"
 
 namespace huadb {
@@ -11,53 +12,71 @@ namespace huadb {
 class FuncCall : public OperatorExpression {
  public:
   FuncCall(std::string function_name, std::vector<std::shared_ptr<OperatorExpression>> args)
-      : OperatorExpression(OperatorExpressionType::FUNC_CALL, {}, GetReturnType(function_name), function_name),
+      : OperatorExpression(OperatorExpressionType::FUNC_CALL, {}, Type::NULL_TYPE, function_name),
         function_name_(std::move(function_name)),
         args_(std::move(args)) {
-    if (function_name_ == "lower" || function_name_ == "upper" || function_name_ == "length") {
-      if (args_.size() != 1 || !TypeUtil::IsString(args_[0]->GetValueType())) {
-        throw DbException("Argument mismatch for function " + function_name_);
-      }
-    } else {
-      throw std::runtime_error("Unknown function name " + function_name_);
+    // 生成查询计划时根据参数类型确定函数实现，执行时不再比较函数名
+    std::vector<Type> arg_types;
+    for (const auto &arg : args_) {
+      arg_types.push_back(arg->GetValueType());
     }
+    function_ = FunctionRegistry::GetInstance().Resolve(function_name_, arg_types);
+    value_type_ = function_->return_type_;
   }
   Value Evaluate(std::shared_ptr<const Record> record) override {
-    if (function_name_ == "lower") {
-      return Value(StringUtil::Lower(args_[0]->Evaluate(record).GetValue<std::string>()));
-    } else if (function_name_ == "upper") {
-      return Value(StringUtil::Upper(args_[0]->Evaluate(record).GetValue<std::string>()));
-    } else if (function_name_ == "length") {
-      return Value(static_cast<uint32_t>(args_[0]->Evaluate(record).GetValue<std::string>().size()));
+    ArgumentBuffer buffer(args_.size());
+    auto &values = buffer.Get();
+    for (size_t i = 0; i < args_.size(); i++) {
+      values[i] = args_[i]->Evaluate(record);
     }
-    throw std::runtime_error("Unknown function name " + function_name_);
+    return function_->Invoke(values);
   }
   Value EvaluateJoin(std::shared_ptr<const Record> left, std::shared_ptr<const Record> right) override {
-    if (function_name_ == "lower") {
-      return Value(StringUtil::Lower(args_[0]->EvaluateJoin(left, right).GetValue<std::string>()));
-    } else if (function_name_ == "upper") {
-      return Value(StringUtil::Upper(args_[0]->EvaluateJoin(left, right).GetValue<std::string>()));
-    } else if (function_name_ == "length") {
-      return Value(static_cast<uint32_t>(args_[0]->EvaluateJoin(left, right).GetValue<std::string>().size()));
+    ArgumentBuffer buffer(args_.size());
+    auto &values = buffer.Get();
+    for (size_t i = 0; i < args_.size(); i++) {
+      values[i] = args_[i]->EvaluateJoin(left, right);
+    }
+    return function_->Invoke(values);
+  }
+  // 对一批记录求值，结果依次写入 results
+  void EvaluateBatch(const std::vector<std::shared_ptr<const Record>> &records, std::vector<Value> &results) {
+    std::vector<std::vector<Value>> columns(args_.size());
+    for (size_t i = 0; i < args_.size(); i++) {
+      columns[i].reserve(records.size());
+      for (const auto &record : records) {
+        columns[i].push_back(args_[i]->Evaluate(record));
+      }
     }
-    throw std::runtime_error("Unknown function name " + function_name_);
+    function_->InvokeBatch(columns, results);
   }
   std::string ToString() const override { return fmt::format("{}({})", function_name_, args_); }
   std::string function_name_;
   std::vector<std::shared_ptr<OperatorExpression>> args_;
 
  private:
-  Type GetReturnType(const std::string &function_name) {
-    if (function_name == "lower") {
-      return Type::VARCHAR;
-    } else if (function_name == "upper") {
-      return Type::VARCHAR;
-    } else if (function_name == "length") {
-      return Type::INT;
-    } else {
-      throw std::runtime_error("Unknown function name " + function_name);
+  // 参数数组在每个线程内按函数调用的嵌套深度复用，避免逐行分配
+  // 并行计划中同一个表达式会被多个 worker 同时求值，因此不能保存在表达式对象中
+  class ArgumentBuffer {
+   public:
+    explicit ArgumentBuffer(size_t size) {
+      if (depth_ == buffers_.size()) {
+        buffers_.emplace_back();
+      }
+      buffer_ = &buffers_[depth_++];
+      buffer_->resize(size);
     }
-  }
+    ~ArgumentBuffer() { depth_--; }
+    std::vector<Value> &Get() { return *buffer_; }
+
+   private:
+    // deque 扩展时已有元素的地址不变
+    static inline thread_local std::deque<std::vector<Value>> buffers_;
+    static inline thread_local size_t depth_ = 0;
+    std::vector<Value> *buffer_;
+  };
+
+  std::shared_ptr<const ScalarFunction> function_;
 };
 
 }  // namespace huadb
@@ -33,7 +33,7 @@ class Logic : public OperatorExpression {
 
   Value EvaluateJoin(std::shared_ptr<const Record> left, std::shared_ptr<const Record> right) override {
     if (logic_type_ == LogicType::NOT) {
-      return children_[0]->Evaluate(left).Not();
+      return children_[0]->EvaluateJoin(left, right).Not();
     } else {
       Value lhs = children_[0]->EvaluateJoin(left, right);
       Value rhs = children_[1]->EvaluateJoin(left, right);
@@ -46,8 +46,14 @@ class Logic : public OperatorExpression {
 
  private:
   LogicType logic_type_;
+  // 三值逻辑：false AND NULL 为 false，true OR NULL 为 true，其余含 NULL 的情况为 NULL
   Value Compute(const Value &lhs, const Value &rhs) {
     if (lhs.IsNull() || rhs.IsNull()) {
+      const auto &other = lhs.IsNull() ? rhs : lhs;
+      if (!other.IsNull() && other.GetType() == Type::BOOL &&
+          other.GetValue<bool>() == (logic_type_ == LogicType::OR)) {
+        return other;
+      }
       return Value();
     }
     switch (lhs.GetType()) {
@@ -19,7 +19,7 @@ class NullTest : public OperatorExpression {
     }
   }
   Value EvaluateJoin(std::shared_ptr<const Record> left, std::shared_ptr<const Record> right) override {
-    auto value = arg_->Evaluate(left);
+    auto value = arg_->EvaluateJoin(left, right);
     if (is_null_) {
       return Value(value.IsNull());
     } else {
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "fmt/format.h"
+#include "operators/operator.h"
+
+namespace huadb {
+
+// 由 worker_count_ 个工作线程和执行查询的线程各执行一份子计划，汇总各自的输出，输出无序
+// 子计划中标记为并行的顺序扫描在各份子计划间划分页面，其余部分每份子计划完整执行
+class GatherOperator : public Operator {
+ public:
+  GatherOperator(std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> child, size_t worker_count)
+      : Operator(OperatorType::GATHER, std::move(column_list), {std::move(child)}), worker_count_(worker_count) {}
+  std::string ToString(size_t indent_num = 0) const override {
+    return fmt::format("{}Gather: workers={}\n{}", std::string(indent_num * 2, ' '), worker_count_,
+                       children_[0]->ToString(indent_num + 1));
+  }
+
+  size_t worker_count_;
+};
+
+}  // namespace huadb
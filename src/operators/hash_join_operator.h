@@ -5,6 +5,7 @@
 #include "binder/table_ref.h"
 #include "expressions/expression.h"
 #include "fmt/format.h"
+#include "fmt/ranges.h"
 #include "operators/operator.h"
 
 namespace huadb {
@@ -12,19 +13,27 @@ namespace huadb {
 class HashJoinOperator : public Operator {
  public:
   HashJoinOperator(std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> left,
-                   std::shared_ptr<Operator> right, std::shared_ptr<OperatorExpression> left_key,
-                   std::shared_ptr<OperatorExpression> right_key, JoinType join_type = JoinType::INNER)
-      : left_key_(std::move(left_key)),
-        right_key_(std::move(right_key)),
+                   std::shared_ptr<Operator> right, std::vector<std::shared_ptr<OperatorExpression>> left_keys,
+                   std::vector<std::shared_ptr<OperatorExpression>> right_keys, JoinType join_type = JoinType::INNER)
+      : left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
         join_type_(join_type),
         Operator(OperatorType::HASHJOIN, std::move(column_list), {std::move(left), std::move(right)}) {}
   std::string ToString(size_t indent_num = 0) const override {
-    return fmt::format("{}HashJoin: left={} right={}\n{}\n{}", std::string(indent_num * 2, ' '), left_key_, right_key_,
-                       children_[0]->ToString(indent_num + 1), children_[1]->ToString(indent_num + 1));
+    std::string join_type;
+    if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+      join_type = fmt::format(null_aware_ ? " (null-aware {})" : " ({})", join_type_);
+    }
+    return fmt::format("{}HashJoin{}: left={} right={}\n{}\n{}", std::string(indent_num * 2, ' '), join_type,
+                       fmt::join(left_keys_, ", "), fmt::join(right_keys_, ", "), children_[0]->ToString(indent_num + 1),
+                       children_[1]->ToString(indent_num + 1));
   }
-  std::shared_ptr<OperatorExpression> left_key_;
-  std::shared_ptr<OperatorExpression> right_key_;
+  // 多列连接键，left_keys_[i] 与 right_keys_[i] 相等
+  std::vector<std::shared_ptr<OperatorExpression>> left_keys_;
+  std::vector<std::shared_ptr<OperatorExpression>> right_keys_;
   JoinType join_type_;
+  // NOT IN 改写得到的反连接：构建侧含有 NULL 时不输出任何记录，探测侧为 NULL 的记录仅在构建侧为空时输出
+  bool null_aware_ = false;
 };
 
 }  // namespace huadb
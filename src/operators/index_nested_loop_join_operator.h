@@ -0,0 +1,43 @@
+#pragma once
+
+#include "binder/table_ref.h"
+#include "expressions/expression.h"
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "operators/operator.h"
+
+namespace huadb {
+
+// 索引嵌套循环连接，左孩子为外表，右孩子为内表上参数化的索引扫描，其上可能依次有过滤内表记录的 Filter
+// 和只选取列的 Projection
+// 内表不单独执行，外表的每批记录按连接键在索引中查找匹配的内表记录
+class IndexNestedLoopJoinOperator : public Operator {
+ public:
+  IndexNestedLoopJoinOperator(std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> left,
+                              std::shared_ptr<Operator> right,
+                              std::vector<std::shared_ptr<OperatorExpression>> left_keys,
+                              std::vector<std::shared_ptr<OperatorExpression>> right_keys, size_t probe_key_count,
+                              JoinType join_type = JoinType::INNER)
+      : left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        probe_key_count_(probe_key_count),
+        join_type_(join_type),
+        Operator(OperatorType::INDEXNESTEDLOOP, std::move(column_list), {std::move(left), std::move(right)}) {}
+  std::string ToString(size_t indent_num = 0) const override {
+    std::string join_type;
+    if (join_type_ == JoinType::SEMI || join_type_ == JoinType::ANTI) {
+      join_type = fmt::format(" ({})", join_type_);
+    }
+    return fmt::format("{}IndexNestedLoopJoin{}: left={} right={}\n{}\n{}", std::string(indent_num * 2, ' '),
+                       join_type, fmt::join(left_keys_, ", "), fmt::join(right_keys_, ", "),
+                       children_[0]->ToString(indent_num + 1), children_[1]->ToString(indent_num + 1));
+  }
+  // 多列连接键，left_keys_[i] 与 right_keys_[i] 相等
+  std::vector<std::shared_ptr<OperatorExpression>> left_keys_;
+  std::vector<std::shared_ptr<OperatorExpression>> right_keys_;
+  // 前 probe_key_count_ 个连接键依次对应索引的键列前缀，用于查找索引，其余连接键在取出内表记录后比较
+  size_t probe_key_count_;
+  JoinType join_type_;
+};
+
+}  // namespace huadb
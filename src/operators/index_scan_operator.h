@@ -0,0 +1,61 @@
+#pragma once
+
+#include <optional>
+
+#include "fmt/format.h"
+#include "index/index.h"
+#include "operators/expressions/expression.h"
+#include "operators/operator.h"
+
+namespace huadb {
+
+class IndexScanOperator : public Operator {
+ public:
+  IndexScanOperator(std::shared_ptr<ColumnList> column_list, oid_t table_oid, std::string table_name,
+                    std::optional<std::string> alias, oid_t index_oid, std::string index_name, IndexType index_type,
+                    std::vector<size_t> key_columns, std::vector<IndexRange> ranges,
+                    std::shared_ptr<OperatorExpression> index_cond)
+      : Operator(OperatorType::INDEXSCAN, std::move(column_list), {}),
+        table_oid_(table_oid),
+        table_name_(std::move(table_name)),
+        alias_(std::move(alias)),
+        index_oid_(index_oid),
+        index_name_(std::move(index_name)),
+        index_type_(index_type),
+        key_columns_(std::move(key_columns)),
+        ranges_(std::move(ranges)),
+        index_cond_(std::move(index_cond)) {}
+  std::string ToString(size_t indent_num = 0) const override {
+    std::string table = alias_ ? table_name_ + " " + *alias_ : table_name_;
+    return fmt::format("{}{}: {} using {} ({})", std::string(indent_num * 2, ' '),
+                       index_only_ ? "IndexOnlyScan" : "IndexScan", table, index_name_, index_cond_);
+  }
+
+  oid_t GetTableOid() const { return table_oid_; }
+  const std::string &GetTableName() const { return table_name_; }
+  oid_t GetIndexOid() const { return index_oid_; }
+  IndexType GetIndexType() const { return index_type_; }
+  const std::vector<size_t> &GetKeyColumns() const { return key_columns_; }
+  const std::vector<IndexRange> &GetRanges() const { return ranges_; }
+  const std::shared_ptr<OperatorExpression> &GetIndexCond() const { return index_cond_; }
+
+  // 上层算子只用到索引中的列时为 true，此时全部可见的页面上的记录直接由索引项构造，不回表
+  bool index_only_ = false;
+  // 作为索引嵌套循环连接的内表时为 true，此时没有固定的扫描范围，由连接在执行时按外表的连接键查找
+  bool parameterized_ = false;
+
+ private:
+  oid_t table_oid_;
+  std::string table_name_;
+  std::optional<std::string> alias_;
+  oid_t index_oid_;
+  std::string index_name_;
+  IndexType index_type_;
+  std::vector<size_t> key_columns_;
+  // 依次扫描的键范围
+  std::vector<IndexRange> ranges_;
+  // 转换为扫描范围的谓词，仅用于输出查询计划
+  std::shared_ptr<OperatorExpression> index_cond_;
+};
+
+}  // namespace huadb
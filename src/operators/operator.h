@@ -11,7 +11,10 @@ enum class OperatorType {
   AGGREGATE,
   DELETE,
   FILTER,
+  GATHER,
   HASHJOIN,
+  INDEXNESTEDLOOP,
+  INDEXSCAN,
   INSERT,
   LIMIT,
   LOCK_ROWS,
@@ -20,6 +23,7 @@ enum class OperatorType {
   ORDERBY,
   PROJECTION,
   SEQSCAN,
+  TOPN,
   UPDATE,
   VALUES,
 };
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "fmt/format.h"
 #include "operators/operator.h"
 #include "table/table.h"
 #include "table/table_scan.h"
+#include "table/zone_map.h"
 
 namespace huadb {
 
@@ -19,10 +21,11 @@ class SeqScanOperator : public Operator {
         alias_(std::move(alias)),
         has_lock_(has_lock) {}
   std::string ToString(size_t indent_num = 0) const override {
+    const char *parallel = parallel_ ? "Parallel " : "";
     if (alias_) {
-      return fmt::format("{}SeqScan: {} {}", std::string(indent_num * 2, ' '), table_name_, *alias_);
+      return fmt::format("{}{}SeqScan: {} {}", std::string(indent_num * 2, ' '), parallel, table_name_, *alias_);
     } else {
-      return fmt::format("{}SeqScan: {}", std::string(indent_num * 2, ' '), table_name_);
+      return fmt::format("{}{}SeqScan: {}", std::string(indent_num * 2, ' '), parallel, table_name_);
     }
   }
 
@@ -35,8 +38,14 @@ class SeqScanOperator : public Operator {
     }
   }
   const std::string &GetTableName() const { return table_name_; }
+  const std::optional<std::string> &GetAlias() const { return alias_; }
   bool HasLock() const { return has_lock_; }
 
+  // 由优化器设置，并行扫描时同一 Gather 下的各个 worker 分别领取表的一段页面，合起来恰好扫描全表一次
+  bool parallel_ = false;
+  // 由优化器设置，为上方过滤谓词中可以根据区域映射整段跳过页面的合取项，扫描出的记录仍由过滤算子检查
+  std::vector<ZonePredicate> zone_predicates_;
+
  private:
   oid_t table_oid_;
   std::string table_name_;
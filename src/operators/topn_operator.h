@@ -0,0 +1,30 @@
+#pragma once
+
+#include "binder/order_by.h"
+#include "expressions/expression.h"
+#include "fmt/format.h"
+#include "operators/operator.h"
+
+namespace huadb {
+
+// ORDER BY 之后紧跟 LIMIT 时由优化器合并生成，只保留排序后的前 limit_offset_ + limit_count_ 条记录
+class TopNOperator : public Operator {
+ public:
+  TopNOperator(std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> child,
+               std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> order_bys, uint32_t limit_count,
+               uint32_t limit_offset)
+      : Operator(OperatorType::TOPN, std::move(column_list), {std::move(child)}),
+        order_bys_(std::move(order_bys)),
+        limit_count_(limit_count),
+        limit_offset_(limit_offset) {}
+  std::string ToString(size_t indent_num = 0) const override {
+    return fmt::format("{}TopN: limit {} offset {}\n{}", std::string(indent_num * 2, ' '), limit_count_, limit_offset_,
+                       children_[0]->ToString(indent_num + 1));
+  }
+
+  std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> order_bys_;
+  uint32_t limit_count_;
+  uint32_t limit_offset_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,754 @@
+#include "optimizer/cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "operators/expressions/expressions.h"
+#include "operators/operators.h"
+#include "table/record_header.h"
+#include "table/table_page.h"
+
+namespace huadb {
+
+// 随机读取一个页面的代价
+static constexpr double RANDOM_PAGE_COST = 4.0;
+// 读取 buffer pool 中已有的页面的代价
+static constexpr double CACHED_PAGE_COST = 0.05;
+// 处理一条记录的代价
+static constexpr double CPU_TUPLE_COST = 0.01;
+// 计算一次表达式、比较或哈希的代价
+static constexpr double CPU_OPERATOR_COST = 0.0025;
+
+// 缺少统计信息时的经验选择率
+static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.005;
+static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+static constexpr double DEFAULT_LIKE_SELECTIVITY = 0.1;
+static constexpr double DEFAULT_NULL_SELECTIVITY = 0.01;
+static constexpr double DEFAULT_SELECTIVITY = 0.5;
+// 半连接中能找到匹配的左侧记录比例的默认值
+static constexpr double DEFAULT_SEMI_SELECTIVITY = 0.5;
+// 分组列不是基表的列时，分组数占输入行数的比例
+static constexpr double DEFAULT_GROUP_RATIO = 0.1;
+
+static double ToDouble(const Value &value) {
+  return value.GetType() == Type::INT ? value.GetValue<int32_t>() : value.GetValue<double>();
+}
+
+// 交换比较的两侧后的比较类型
+static std::optional<ComparisonType> Commute(ComparisonType type) {
+  switch (type) {
+    case ComparisonType::EQUAL:
+    case ComparisonType::NOT_EQUAL:
+      return type;
+    case ComparisonType::LESS:
+      return ComparisonType::GREATER;
+    case ComparisonType::LESS_EQUAL:
+      return ComparisonType::GREATER_EQUAL;
+    case ComparisonType::GREATER:
+      return ComparisonType::LESS;
+    case ComparisonType::GREATER_EQUAL:
+      return ComparisonType::LESS_EQUAL;
+    default:
+      return std::nullopt;
+  }
+}
+
+// 非空且不在 MCV 列表中的记录占全部记录的比例
+static double RestFraction(const ColumnStatistics &statistics) {
+  double mcv_total = 0;
+  for (auto freq : statistics.mcv_freqs_) {
+    mcv_total += freq;
+  }
+  return std::max(0.0, 1 - statistics.null_frac_ - mcv_total);
+}
+
+// 列等于 value 的记录的比例，不在 MCV 列表中的值平分其余的记录
+static std::optional<double> EqualFraction(const ColumnStatistics &statistics, const Value &value) {
+  if (value.IsNull()) {
+    return 0;
+  }
+  for (size_t i = 0; i < statistics.mcv_values_.size(); i++) {
+    auto cmp = ColumnStatistics::Compare(statistics.mcv_values_[i], value);
+    if (!cmp) {
+      return std::nullopt;
+    }
+    if (*cmp == 0) {
+      return statistics.mcv_freqs_[i];
+    }
+  }
+  if (statistics.n_distinct_ <= statistics.mcv_values_.size()) {
+    return 0;
+  }
+  return RestFraction(statistics) / (statistics.n_distinct_ - statistics.mcv_values_.size());
+}
+
+// 列小于 value 的记录的比例。MCV 列表中的值逐个比较，其余的记录由直方图估计，桶内按线性插值
+static std::optional<double> LessFraction(const ColumnStatistics &statistics, const Value &value) {
+  if (value.IsNull()) {
+    return 0;
+  }
+  double fraction = 0;
+  for (size_t i = 0; i < statistics.mcv_values_.size(); i++) {
+    auto cmp = ColumnStatistics::Compare(statistics.mcv_values_[i], value);
+    if (!cmp) {
+      return std::nullopt;
+    }
+    fraction += *cmp < 0 ? statistics.mcv_freqs_[i] : 0;
+  }
+  const auto &bounds = statistics.histogram_bounds_;
+  if (bounds.empty()) {
+    return fraction + RestFraction(statistics) * DEFAULT_RANGE_SELECTIVITY;
+  }
+  auto first = ColumnStatistics::Compare(bounds.front(), value);
+  if (!first) {
+    return std::nullopt;
+  }
+  double histogram_fraction;
+  if (*first >= 0) {
+    histogram_fraction = 0;
+  } else if (*ColumnStatistics::Compare(bounds.back(), value) < 0) {
+    histogram_fraction = 1;
+  } else {
+    // 找到 bounds[i] < value <= bounds[i + 1] 的桶
+    size_t i = 0;
+    while (*ColumnStatistics::Compare(bounds[i + 1], value) < 0) {
+      i++;
+    }
+    // 字符串无法插值，取桶的中点
+    double position = 0.5;
+    if (value.GetType() == Type::INT || value.GetType() == Type::DOUBLE) {
+      auto low = ToDouble(bounds[i]);
+      auto high = ToDouble(bounds[i + 1]);
+      position = high > low ? (ToDouble(value) - low) / (high - low) : 0.5;
+    }
+    histogram_fraction = (i + position) / (bounds.size() - 1);
+  }
+  return fraction + RestFraction(statistics) * histogram_fraction;
+}
+
+// LIKE 模式中第一个通配符之前的前缀
+static std::string LikePrefix(const std::string &pattern) { return pattern.substr(0, pattern.find_first_of("%_")); }
+
+CostModel::CostModel(Catalog &catalog, BufferPool &buffer_pool, size_t work_mem)
+    : catalog_(catalog), buffer_pool_(buffer_pool), work_mem_(work_mem) {}
+
+bool CostModel::HasStatistics(const Operator &plan) {
+  if (plan.GetType() == OperatorType::SEQSCAN || plan.GetType() == OperatorType::INDEXSCAN) {
+    const auto &table_name = plan.GetType() == OperatorType::SEQSCAN
+                                 ? dynamic_cast<const SeqScanOperator &>(plan).GetTableName()
+                                 : dynamic_cast<const IndexScanOperator &>(plan).GetTableName();
+    return catalog_.GetCardinality(table_name) != INVALID_CARDINALITY;
+  }
+  return std::all_of(plan.GetChildren().begin(), plan.GetChildren().end(),
+                     [this](const auto &child) { return HasStatistics(*child); });
+}
+
+double CostModel::EstimateRows(const Operator &plan) {
+  const auto &children = plan.GetChildren();
+  switch (plan.GetType()) {
+    case OperatorType::SEQSCAN: {
+      auto cardinality = catalog_.GetCardinality(dynamic_cast<const SeqScanOperator &>(plan).GetTableName());
+      return cardinality == INVALID_CARDINALITY ? 0 : cardinality;
+    }
+    case OperatorType::INDEXSCAN: {
+      const auto &index_scan = dynamic_cast<const IndexScanOperator &>(plan);
+      auto cardinality = catalog_.GetCardinality(index_scan.GetTableName());
+      if (cardinality == INVALID_CARDINALITY) {
+        return 0;
+      }
+      // 参数化的索引扫描由上方的索引嵌套循环连接按外表的连接键查找，行数为连接可能匹配的全部内表记录
+      if (index_scan.parameterized_) {
+        return cardinality;
+      }
+      // 索引条件中的列与索引扫描输出的列一致，以自身为输入估计选择率
+      return cardinality * EstimateSelectivity(*index_scan.GetIndexCond(), plan);
+    }
+    case OperatorType::VALUES:
+      return dynamic_cast<const ValuesOperator &>(plan).values_.size();
+    case OperatorType::FILTER:
+      return EstimateRows(*children[0]) *
+             EstimateSelectivity(*dynamic_cast<const FilterOperator &>(plan).predicate_, *children[0]);
+    case OperatorType::LIMIT: {
+      const auto &limit = dynamic_cast<const LimitOperator &>(plan);
+      auto rows = std::max(0.0, EstimateRows(*children[0]) - limit.limit_offset_.value_or(0));
+      return limit.limit_count_ ? std::min<double>(rows, *limit.limit_count_) : rows;
+    }
+    case OperatorType::TOPN: {
+      const auto &topn = dynamic_cast<const TopNOperator &>(plan);
+      return std::min<double>(std::max(0.0, EstimateRows(*children[0]) - topn.limit_offset_), topn.limit_count_);
+    }
+    case OperatorType::AGGREGATE: {
+      const auto &aggregate = dynamic_cast<const AggregateOperator &>(plan);
+      auto input_rows = EstimateRows(*children[0]);
+      if (aggregate.group_bys_.empty()) {
+        return 1;
+      }
+      double groups = 1;
+      for (const auto &group_by : aggregate.group_bys_) {
+        auto distinct = ColumnDistinct(*group_by, *children[0], nullptr);
+        groups *= distinct ? *distinct : std::max(1.0, input_rows * DEFAULT_GROUP_RATIO);
+      }
+      return std::max(1.0, std::min(groups, input_rows));
+    }
+    case OperatorType::NESTEDLOOP: {
+      const auto &join = dynamic_cast<const NestedLoopJoinOperator &>(plan);
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      auto inner_rows =
+          left_rows * right_rows * EstimateSelectivity(*join.join_condition_, *children[0], children[1].get());
+      return JoinRows(join.join_type_, left_rows, right_rows, inner_rows);
+    }
+    case OperatorType::INDEXNESTEDLOOP: {
+      const auto &join = dynamic_cast<const IndexNestedLoopJoinOperator &>(plan);
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      auto inner_rows =
+          left_rows * right_rows * EquiJoinSelectivity(join.left_keys_, join.right_keys_, *children[0], *children[1]);
+      return JoinRows(join.join_type_, left_rows, right_rows, inner_rows);
+    }
+    case OperatorType::HASHJOIN:
+    case OperatorType::MERGEJOIN: {
+      bool hash = plan.GetType() == OperatorType::HASHJOIN;
+      const auto &left_keys = hash ? dynamic_cast<const HashJoinOperator &>(plan).left_keys_
+                                   : dynamic_cast<const MergeJoinOperator &>(plan).left_keys_;
+      const auto &right_keys = hash ? dynamic_cast<const HashJoinOperator &>(plan).right_keys_
+                                    : dynamic_cast<const MergeJoinOperator &>(plan).right_keys_;
+      auto join_type = hash ? dynamic_cast<const HashJoinOperator &>(plan).join_type_
+                            : dynamic_cast<const MergeJoinOperator &>(plan).join_type_;
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      auto inner_rows =
+          left_rows * right_rows * EquiJoinSelectivity(left_keys, right_keys, *children[0], *children[1]);
+      return JoinRows(join_type, left_rows, right_rows, inner_rows);
+    }
+    default:
+      // 投影、排序、Gather 等算子不改变行数；插入、删除和更新只输出一行，其代价由子节点决定
+      return children.empty() ? 1 : EstimateRows(*children[0]);
+  }
+}
+
+double CostModel::EstimateCost(const Operator &plan) {
+  const auto &children = plan.GetChildren();
+  double cost = 0;
+  for (const auto &child : children) {
+    // 索引嵌套循环连接的内表不单独执行，其代价由连接按查找次数计算
+    if (plan.GetType() == OperatorType::INDEXNESTEDLOOP && child == children[1]) {
+      break;
+    }
+    cost += EstimateCost(*child);
+  }
+  auto rows = EstimateRows(plan);
+  switch (plan.GetType()) {
+    case OperatorType::SEQSCAN: {
+      auto table_oid = dynamic_cast<const SeqScanOperator &>(plan).GetTableOid();
+      auto pages = Pages(rows, RowWidth(plan));
+      return TableIoCost(table_oid, pages, pages, false) + rows * CPU_TUPLE_COST;
+    }
+    case OperatorType::INDEXSCAN: {
+      // 每个扫描范围从根结点下降到叶结点，之后每个索引项回表随机读取一个页面
+      const auto &index_scan = dynamic_cast<const IndexScanOperator &>(plan);
+      auto cardinality = std::max(1.0, static_cast<double>(catalog_.GetCardinality(index_scan.GetTableName())));
+      double ranges = index_scan.GetRanges().size();
+      double heap_pages = index_scan.index_only_ ? 0 : rows;
+      return ranges * IndexProbePages(index_scan, cardinality) * RANDOM_PAGE_COST +
+             TableIoCost(index_scan.GetTableOid(), Pages(cardinality, RowWidth(plan)), heap_pages, true) +
+             rows * (CPU_TUPLE_COST + CPU_OPERATOR_COST);
+    }
+    case OperatorType::FILTER:
+      return cost + EstimateRows(*children[0]) * CPU_OPERATOR_COST;
+    case OperatorType::PROJECTION:
+      return cost + rows * dynamic_cast<const ProjectionOperator &>(plan).exprs_.size() * CPU_OPERATOR_COST;
+    case OperatorType::ORDERBY:
+      return cost + SortCost(rows, RowWidth(plan));
+    case OperatorType::TOPN: {
+      // 堆中最多保留 limit + offset 条记录
+      const auto &topn = dynamic_cast<const TopNOperator &>(plan);
+      auto input_rows = EstimateRows(*children[0]);
+      auto heap_size = std::max(2.0, static_cast<double>(topn.limit_count_) + topn.limit_offset_);
+      return cost + input_rows * std::log2(heap_size) * 2 * CPU_OPERATOR_COST;
+    }
+    case OperatorType::AGGREGATE: {
+      const auto &aggregate = dynamic_cast<const AggregateOperator &>(plan);
+      auto input_rows = EstimateRows(*children[0]);
+      double per_row = (aggregate.group_bys_.size() + aggregate.aggregates_.size()) * CPU_OPERATOR_COST;
+      cost += input_rows * per_row + rows * CPU_TUPLE_COST;
+      if (aggregate.algorithm_ == AggregateAlgorithm::HASH) {
+        // 分组数超出内存时，哈希聚集将输入按分区溢出到临时文件
+        cost += rows * RowWidth(plan) > work_mem_ ? SpillCost(input_rows, RowWidth(*children[0])) : 0;
+      }
+      return cost;
+    }
+    case OperatorType::NESTEDLOOP: {
+      // 内表物化后，每条外表记录与全部内表记录比较
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      return cost + left_rows * right_rows * CPU_OPERATOR_COST + SpillCost(right_rows, RowWidth(*children[1])) +
+             rows * CPU_TUPLE_COST;
+    }
+    case OperatorType::HASHJOIN: {
+      // 右侧为构建侧，构建侧超出内存时两侧都按分区溢出到临时文件
+      // 在 Gather 之下时构建侧只由一份执行器构建，由各个 worker 共享，构建代价同样只计一次
+      const auto &join = dynamic_cast<const HashJoinOperator &>(plan);
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      double key_count = join.left_keys_.size();
+      cost += right_rows * (CPU_TUPLE_COST + key_count * CPU_OPERATOR_COST) +
+              left_rows * key_count * CPU_OPERATOR_COST + rows * CPU_TUPLE_COST;
+      if (right_rows * RowWidth(*children[1]) > work_mem_) {
+        cost += SpillCost(right_rows, RowWidth(*children[1])) + SpillCost(left_rows, RowWidth(*children[0]));
+      }
+      return cost;
+    }
+    case OperatorType::MERGEJOIN: {
+      auto left_rows = EstimateRows(*children[0]);
+      auto right_rows = EstimateRows(*children[1]);
+      return cost + (left_rows + right_rows) * CPU_OPERATOR_COST + rows * CPU_TUPLE_COST;
+    }
+    case OperatorType::INDEXNESTEDLOOP: {
+      // 外表每批的连接键排序去重后依次查找：内部结点在相邻的查找之间保持缓存，只计一次下降，
+      // 落在同一叶结点上的键只读取一次该叶结点，读取的叶结点数按键在叶结点中均匀分布估计；
+      // 哈希索引每次查找读取一个桶。查到的每个索引项回表随机读取一个页面
+      const auto &join = dynamic_cast<const IndexNestedLoopJoinOperator &>(plan);
+      // 内表为参数化的索引扫描，其上可能依次有过滤和只选取列的投影
+      const auto *inner = children[1].get();
+      double per_row = 0;
+      while (inner->GetType() != OperatorType::INDEXSCAN) {
+        per_row += inner->GetType() == OperatorType::FILTER
+                       ? CPU_OPERATOR_COST
+                       : dynamic_cast<const ProjectionOperator &>(*inner).exprs_.size() * CPU_OPERATOR_COST;
+        inner = inner->GetChildren()[0].get();
+      }
+      const auto &index_scan = dynamic_cast<const IndexScanOperator &>(*inner);
+      auto cardinality = std::max(1.0, static_cast<double>(catalog_.GetCardinality(index_scan.GetTableName())));
+      auto left_rows = EstimateRows(*children[0]);
+      // 查找的次数为外表连接键的不同值个数，每次查找取出的索引项数由连接键与索引键列的不同值个数估计
+      double probes = 1;
+      double selectivity = 1;
+      for (size_t i = 0; i < join.probe_key_count_; i++) {
+        auto left_distinct = ColumnDistinct(*join.left_keys_[i], *children[0], nullptr);
+        auto right_distinct = ColumnDistinct(*inner, index_scan.GetKeyColumns()[i]);
+        probes *= left_distinct.value_or(left_rows);
+        double distinct = std::max(left_distinct.value_or(0), right_distinct.value_or(0));
+        selectivity *= distinct >= 1 ? 1 / distinct : DEFAULT_EQUAL_SELECTIVITY;
+      }
+      probes = std::min(probes, left_rows);
+      auto fetched = left_rows * cardinality * selectivity;
+      double index_pages = probes;
+      if (index_scan.GetIndexType() == IndexType::BTREE) {
+        auto leaf_pages = std::ceil(cardinality * IndexKeyWidth(index_scan) / (DB_PAGE_SIZE - PAGE_HEADER_SIZE));
+        index_pages = IndexProbePages(index_scan, cardinality) - 1 +
+                      leaf_pages * (1 - std::pow(1 - 1 / std::max(1.0, leaf_pages), probes));
+      }
+      return cost + index_pages * RANDOM_PAGE_COST +
+             TableIoCost(index_scan.GetTableOid(), Pages(cardinality, RowWidth(*inner)), fetched, true) +
+             fetched * (CPU_TUPLE_COST + CPU_OPERATOR_COST + per_row) +
+             left_rows * join.left_keys_.size() * CPU_OPERATOR_COST + rows * CPU_TUPLE_COST;
+    }
+    default:
+      return cost + rows * CPU_TUPLE_COST;
+  }
+}
+
+double CostModel::EstimateSelectivity(const OperatorExpression &predicate, const Operator &left,
+                                      const Operator *right) {
+  switch (predicate.GetExprType()) {
+    case OperatorExpressionType::CONST: {
+      auto value = dynamic_cast<const Const &>(predicate).value_;
+      return !value.IsNull() && value.GetType() == Type::BOOL && value.GetValue<bool>() ? 1 : 0;
+    }
+    case OperatorExpressionType::LOGIC: {
+      const auto &logic = dynamic_cast<const Logic &>(predicate);
+      auto lhs = EstimateSelectivity(*predicate.children_[0], left, right);
+      if (logic.GetLogicType() == LogicType::NOT) {
+        return 1 - lhs;
+      }
+      auto rhs = EstimateSelectivity(*predicate.children_[1], left, right);
+      return logic.GetLogicType() == LogicType::AND ? lhs * rhs : lhs + rhs - lhs * rhs;
+    }
+    case OperatorExpressionType::NULL_TEST: {
+      const auto &null_test = dynamic_cast<const NullTest &>(predicate);
+      auto statistics = ColumnStatisticsOf(*null_test.arg_, left, right);
+      auto null_frac = statistics ? statistics->null_frac_ : DEFAULT_NULL_SELECTIVITY;
+      return null_test.is_null_ ? null_frac : 1 - null_frac;
+    }
+    case OperatorExpressionType::COMPARISON:
+      break;
+    default:
+      return DEFAULT_SELECTIVITY;
+  }
+  auto type = dynamic_cast<const Comparison &>(predicate).GetComparisonType();
+  const auto &lhs = *predicate.children_[0];
+  const auto &rhs = *predicate.children_[1];
+  if (auto selectivity = ComparisonSelectivity(type, lhs, rhs, left, right)) {
+    return std::clamp(*selectivity, 0.0, 1.0);
+  }
+  // 列与常量比较时取列的不同值个数，两列比较时取较大者
+  auto equal_selectivity = [&]() {
+    auto lhs_distinct = ColumnDistinct(lhs, left, right);
+    auto rhs_distinct = ColumnDistinct(rhs, left, right);
+    double distinct = std::max(lhs_distinct.value_or(0), rhs_distinct.value_or(0));
+    return distinct >= 1 ? 1 / distinct : DEFAULT_EQUAL_SELECTIVITY;
+  };
+  switch (type) {
+    case ComparisonType::EQUAL:
+      return equal_selectivity();
+    case ComparisonType::NOT_EQUAL:
+      return 1 - equal_selectivity();
+    case ComparisonType::LESS:
+    case ComparisonType::LESS_EQUAL:
+    case ComparisonType::GREATER:
+    case ComparisonType::GREATER_EQUAL:
+      return DEFAULT_RANGE_SELECTIVITY;
+    case ComparisonType::BETWEEN:
+      return DEFAULT_RANGE_SELECTIVITY * DEFAULT_RANGE_SELECTIVITY;
+    case ComparisonType::NOT_BETWEEN:
+      return 1 - DEFAULT_RANGE_SELECTIVITY * DEFAULT_RANGE_SELECTIVITY;
+    case ComparisonType::IN:
+    case ComparisonType::NOT_IN: {
+      double selectivity = DEFAULT_SELECTIVITY;
+      if (rhs.GetExprType() == OperatorExpressionType::LIST) {
+        double count = dynamic_cast<const List &>(rhs).exprs_.size();
+        auto distinct = ColumnDistinct(lhs, left, right);
+        selectivity = std::min(1.0, count * (distinct && *distinct >= 1 ? 1 / *distinct : DEFAULT_EQUAL_SELECTIVITY));
+      }
+      return type == ComparisonType::IN ? selectivity : 1 - selectivity;
+    }
+    case ComparisonType::LIKE:
+      return DEFAULT_LIKE_SELECTIVITY;
+    case ComparisonType::NOT_LIKE:
+      return 1 - DEFAULT_LIKE_SELECTIVITY;
+    default:
+      return DEFAULT_SELECTIVITY;
+  }
+}
+
+std::optional<double> CostModel::ComparisonSelectivity(ComparisonType type, const OperatorExpression &lhs,
+                                                      const OperatorExpression &rhs, const Operator &left,
+                                                      const Operator *right) {
+  // 常量在左侧时交换两侧
+  if (lhs.GetExprType() == OperatorExpressionType::CONST) {
+    if (auto commuted = Commute(type)) {
+      return ComparisonSelectivity(*commuted, rhs, lhs, left, right);
+    }
+    return std::nullopt;
+  }
+  auto statistics = ColumnStatisticsOf(lhs, left, right);
+  if (statistics == nullptr) {
+    return std::nullopt;
+  }
+  // rhs 为常量或常量列表时取出其中的值
+  std::vector<Value> values;
+  if (rhs.GetExprType() == OperatorExpressionType::CONST) {
+    values.push_back(dynamic_cast<const Const &>(rhs).value_);
+  } else if (rhs.GetExprType() == OperatorExpressionType::LIST) {
+    for (const auto &expr : dynamic_cast<const List &>(rhs).exprs_) {
+      if (expr->GetExprType() != OperatorExpressionType::CONST) {
+        return std::nullopt;
+      }
+      values.push_back(dynamic_cast<const Const &>(*expr).value_);
+    }
+  } else {
+    return std::nullopt;
+  }
+  auto non_null = 1 - statistics->null_frac_;
+  // 小于等于与小于、大于等于与大于的差别只在于等于常量的记录
+  auto less_equal = [&](const Value &value) -> std::optional<double> {
+    auto less = LessFraction(*statistics, value);
+    auto equal = EqualFraction(*statistics, value);
+    return less && equal ? std::optional(*less + *equal) : std::nullopt;
+  };
+  std::optional<double> selectivity;
+  switch (type) {
+    case ComparisonType::EQUAL:
+      return EqualFraction(*statistics, values[0]);
+    case ComparisonType::NOT_EQUAL:
+      selectivity = EqualFraction(*statistics, values[0]);
+      return selectivity ? std::optional(non_null - *selectivity) : std::nullopt;
+    case ComparisonType::LESS:
+      return LessFraction(*statistics, values[0]);
+    case ComparisonType::LESS_EQUAL:
+      return less_equal(values[0]);
+    case ComparisonType::GREATER:
+      selectivity = less_equal(values[0]);
+      return selectivity ? std::optional(non_null - *selectivity) : std::nullopt;
+    case ComparisonType::GREATER_EQUAL:
+      selectivity = LessFraction(*statistics, values[0]);
+      return selectivity ? std::optional(non_null - *selectivity) : std::nullopt;
+    case ComparisonType::BETWEEN:
+    case ComparisonType::NOT_BETWEEN: {
+      if (values.size() != 2) {
+        return std::nullopt;
+      }
+      auto high = less_equal(values[1]);
+      auto low = LessFraction(*statistics, values[0]);
+      if (!high || !low) {
+        return std::nullopt;
+      }
+      auto between = std::max(0.0, *high - *low);
+      return type == ComparisonType::BETWEEN ? between : non_null - between;
+    }
+    case ComparisonType::IN:
+    case ComparisonType::NOT_IN: {
+      // 列表中相同的值只计一次
+      double in = 0;
+      for (size_t i = 0; i < values.size(); i++) {
+        bool duplicate = std::any_of(values.begin(), values.begin() + i, [&](const Value &value) {
+          return ColumnStatistics::Compare(value, values[i]) == 0;
+        });
+        auto equal = duplicate ? 0 : EqualFraction(*statistics, values[i]);
+        if (!equal) {
+          return std::nullopt;
+        }
+        in += *equal;
+      }
+      in = std::min(in, non_null);
+      return type == ComparisonType::IN ? in : non_null - in;
+    }
+    case ComparisonType::LIKE:
+    case ComparisonType::NOT_LIKE: {
+      // 前缀确定的值域 [prefix, 前缀的最后一个字符加一) 由 MCV 列表和直方图估计
+      // 模式在前缀之后还有其他条件时再乘以经验选择率
+      const auto &value = values[0];
+      if (value.IsNull() || (value.GetType() != Type::CHAR && value.GetType() != Type::VARCHAR)) {
+        return std::nullopt;
+      }
+      auto pattern = value.GetValue<std::string>();
+      auto prefix = LikePrefix(pattern);
+      if (prefix.empty()) {
+        return std::nullopt;
+      }
+      double like;
+      if (prefix == pattern) {
+        auto equal = EqualFraction(*statistics, Value(prefix));
+        if (!equal) {
+          return std::nullopt;
+        }
+        like = *equal;
+      } else {
+        auto upper = prefix;
+        while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+          upper.pop_back();
+        }
+        std::optional<double> high = non_null;
+        if (!upper.empty()) {
+          upper.back()++;
+          high = LessFraction(*statistics, Value(upper));
+        }
+        auto low = LessFraction(*statistics, Value(prefix));
+        if (!high || !low) {
+          return std::nullopt;
+        }
+        like = std::max(0.0, *high - *low) * (pattern == prefix + "%" ? 1 : DEFAULT_LIKE_SELECTIVITY);
+      }
+      return type == ComparisonType::LIKE ? like : non_null - like;
+    }
+    default:
+      return std::nullopt;
+  }
+}
+
+std::optional<double> CostModel::ColumnDistinct(const OperatorExpression &expr, const Operator &left,
+                                                const Operator *right) {
+  if (expr.GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+    return std::nullopt;
+  }
+  const auto &column = dynamic_cast<const ColumnValue &>(expr);
+  const auto &plan = right == nullptr || column.IsLeft() ? left : *right;
+  return ColumnDistinct(plan, column.GetColumnIndex());
+}
+
+std::optional<double> CostModel::ColumnDistinct(const Operator &plan, size_t col_idx) {
+  // 沿不改变列值的算子找到列所在的基表，不同值个数不超过当前的行数
+  const auto &children = plan.GetChildren();
+  std::optional<double> distinct;
+  switch (plan.GetType()) {
+    case OperatorType::SEQSCAN:
+    case OperatorType::INDEXSCAN: {
+      bool seqscan = plan.GetType() == OperatorType::SEQSCAN;
+      auto table_oid = seqscan ? dynamic_cast<const SeqScanOperator &>(plan).GetTableOid()
+                               : dynamic_cast<const IndexScanOperator &>(plan).GetTableOid();
+      const auto &table_name = seqscan ? dynamic_cast<const SeqScanOperator &>(plan).GetTableName()
+                                       : dynamic_cast<const IndexScanOperator &>(plan).GetTableName();
+      const auto &column_name = catalog_.GetTable(table_oid)->GetColumnList().GetColumn(col_idx).GetName();
+      auto value = catalog_.GetDistinct(table_name, column_name);
+      if (value == INVALID_DISTINCT) {
+        return std::nullopt;
+      }
+      // 索引扫描的行数由本函数估计，不再以行数为上限
+      return value;
+    }
+    case OperatorType::FILTER:
+    case OperatorType::ORDERBY:
+    case OperatorType::LIMIT:
+    case OperatorType::TOPN:
+    case OperatorType::GATHER:
+    case OperatorType::LOCK_ROWS:
+      distinct = ColumnDistinct(*children[0], col_idx);
+      break;
+    case OperatorType::PROJECTION: {
+      const auto &expr = *dynamic_cast<const ProjectionOperator &>(plan).exprs_[col_idx];
+      if (expr.GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+        return std::nullopt;
+      }
+      distinct = ColumnDistinct(*children[0], dynamic_cast<const ColumnValue &>(expr).GetColumnIndex());
+      break;
+    }
+    case OperatorType::AGGREGATE: {
+      const auto &group_bys = dynamic_cast<const AggregateOperator &>(plan).group_bys_;
+      if (col_idx >= group_bys.size()) {
+        return std::nullopt;
+      }
+      distinct = ColumnDistinct(*group_bys[col_idx], *children[0], nullptr);
+      break;
+    }
+    case OperatorType::NESTEDLOOP:
+    case OperatorType::HASHJOIN:
+    case OperatorType::MERGEJOIN:
+    case OperatorType::INDEXNESTEDLOOP: {
+      auto left_count = children[0]->OutputColumns().Length();
+      distinct = col_idx < left_count ? ColumnDistinct(*children[0], col_idx)
+                                      : ColumnDistinct(*children[1], col_idx - left_count);
+      break;
+    }
+    default:
+      return std::nullopt;
+  }
+  if (distinct) {
+    distinct = std::min(*distinct, std::max(1.0, EstimateRows(plan)));
+  }
+  return distinct;
+}
+
+std::shared_ptr<const ColumnStatistics> CostModel::ColumnStatisticsOf(const OperatorExpression &expr,
+                                                                      const Operator &left, const Operator *right) {
+  if (expr.GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+    return nullptr;
+  }
+  const auto &column = dynamic_cast<const ColumnValue &>(expr);
+  const auto &plan = right == nullptr || column.IsLeft() ? left : *right;
+  return ColumnStatisticsOf(plan, column.GetColumnIndex());
+}
+
+std::shared_ptr<const ColumnStatistics> CostModel::ColumnStatisticsOf(const Operator &plan, size_t col_idx) {
+  // 沿不改变列值分布的算子找到列所在的基表，聚集之后的分组列每个值只出现一次，不使用基表的统计信息
+  const auto &children = plan.GetChildren();
+  switch (plan.GetType()) {
+    case OperatorType::SEQSCAN:
+    case OperatorType::INDEXSCAN: {
+      bool seqscan = plan.GetType() == OperatorType::SEQSCAN;
+      auto table_oid = seqscan ? dynamic_cast<const SeqScanOperator &>(plan).GetTableOid()
+                               : dynamic_cast<const IndexScanOperator &>(plan).GetTableOid();
+      const auto &table_name = seqscan ? dynamic_cast<const SeqScanOperator &>(plan).GetTableName()
+                                       : dynamic_cast<const IndexScanOperator &>(plan).GetTableName();
+      const auto &column_name = catalog_.GetTable(table_oid)->GetColumnList().GetColumn(col_idx).GetName();
+      return catalog_.GetColumnStatistics(table_name, column_name);
+    }
+    case OperatorType::FILTER:
+    case OperatorType::ORDERBY:
+    case OperatorType::LIMIT:
+    case OperatorType::TOPN:
+    case OperatorType::GATHER:
+    case OperatorType::LOCK_ROWS:
+      return ColumnStatisticsOf(*children[0], col_idx);
+    case OperatorType::PROJECTION: {
+      const auto &expr = *dynamic_cast<const ProjectionOperator &>(plan).exprs_[col_idx];
+      return ColumnStatisticsOf(expr, *children[0], nullptr);
+    }
+    case OperatorType::NESTEDLOOP:
+    case OperatorType::HASHJOIN:
+    case OperatorType::MERGEJOIN:
+    case OperatorType::INDEXNESTEDLOOP: {
+      auto left_count = children[0]->OutputColumns().Length();
+      return col_idx < left_count ? ColumnStatisticsOf(*children[0], col_idx)
+                                  : ColumnStatisticsOf(*children[1], col_idx - left_count);
+    }
+    default:
+      return nullptr;
+  }
+}
+
+double CostModel::EquiJoinSelectivity(const std::vector<std::shared_ptr<OperatorExpression>> &left_keys,
+                                      const std::vector<std::shared_ptr<OperatorExpression>> &right_keys,
+                                      const Operator &left, const Operator &right) {
+  double selectivity = 1;
+  for (size_t i = 0; i < left_keys.size(); i++) {
+    auto left_distinct = ColumnDistinct(*left_keys[i], left, nullptr);
+    auto right_distinct = ColumnDistinct(*right_keys[i], right, nullptr);
+    double distinct = std::max(left_distinct.value_or(0), right_distinct.value_or(0));
+    selectivity *= distinct >= 1 ? 1 / distinct : DEFAULT_EQUAL_SELECTIVITY;
+  }
+  return selectivity;
+}
+
+double CostModel::JoinRows(JoinType join_type, double left_rows, double right_rows, double inner_rows) const {
+  switch (join_type) {
+    case JoinType::LEFT:
+      return std::max(inner_rows, left_rows);
+    case JoinType::RIGHT:
+      return std::max(inner_rows, right_rows);
+    case JoinType::FULL:
+      return std::max(inner_rows, std::max(left_rows, right_rows));
+    case JoinType::SEMI:
+      return std::min(left_rows, right_rows == 0 ? 0 : std::max(inner_rows, left_rows * DEFAULT_SEMI_SELECTIVITY));
+    case JoinType::ANTI:
+      return left_rows - std::min(left_rows, right_rows == 0 ? 0 : left_rows * DEFAULT_SEMI_SELECTIVITY);
+    default:
+      return inner_rows;
+  }
+}
+
+double CostModel::RowWidth(const Operator &plan) {
+  double width = RECORD_HEADER_SIZE;
+  const auto &column_list = plan.OutputColumns();
+  for (size_t i = 0; i < column_list.Length(); i++) {
+    width += column_list.GetColumn(i).GetMaxSize();
+  }
+  return width;
+}
+
+double CostModel::IndexKeyWidth(const IndexScanOperator &index_scan) {
+  double key_width = sizeof(pageid_t) + sizeof(slotid_t);
+  for (auto col_idx : index_scan.GetKeyColumns()) {
+    key_width += index_scan.OutputColumns().GetColumn(col_idx).GetMaxSize();
+  }
+  return key_width;
+}
+
+double CostModel::IndexProbePages(const IndexScanOperator &index_scan, double cardinality) {
+  if (index_scan.GetIndexType() == IndexType::HASH) {
+    return 1;
+  }
+  auto fanout = std::max(2.0, (DB_PAGE_SIZE - PAGE_HEADER_SIZE) / IndexKeyWidth(index_scan));
+  return std::ceil(std::log(cardinality) / std::log(fanout)) + 1;
+}
+
+double CostModel::Pages(double rows, double width) {
+  // 每条记录在页面中另占一个槽位
+  auto records_per_page = std::max(1.0, std::floor((DB_PAGE_SIZE - PAGE_HEADER_SIZE) / (width + sizeof(Slot))));
+  return std::ceil(rows / records_per_page);
+}
+
+double CostModel::TableIoCost(oid_t table_oid, double table_pages, double pages, bool random) {
+  if (pages <= 0) {
+    return 0;
+  }
+  // 读到的页面中已在 buffer pool 中的比例按整个表的比例估计
+  auto table = catalog_.GetTable(table_oid);
+  double resident = buffer_pool_.GetResidentPageCount(table->GetDbOid(), table_oid);
+  double cached_ratio = std::min(1.0, resident / std::max(1.0, table_pages));
+  double page_cost = random ? RANDOM_PAGE_COST : 1;
+  return pages * (cached_ratio * CACHED_PAGE_COST + (1 - cached_ratio) * page_cost);
+}
+
+double CostModel::SpillCost(double rows, double width) const {
+  if (rows * width <= work_mem_) {
+    return 0;
+  }
+  return 2 * Pages(rows, width);
+}
+
+double CostModel::SortCost(double rows, double width) const {
+  return rows * std::log2(std::max(2.0, rows)) * 2 * CPU_OPERATOR_COST + SpillCost(rows, width);
+}
+
+}  // namespace huadb
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <optional>
+
+#include "binder/table_ref.h"
+#include "catalog/catalog.h"
+#include "catalog/column_statistics.h"
+#include "operators/expressions/comparison.h"
+#include "operators/expressions/expression.h"
+#include "operators/index_scan_operator.h"
+#include "operators/operator.h"
+#include "storage/buffer_pool.h"
+
+namespace huadb {
+
+// 代价模型：计划的代价为页面 I/O 与逐记录 CPU 开销之和，单位为顺序读取一个磁盘页面的代价
+// 已在 buffer pool 中的页面只计 CPU 开销；排序、哈希聚集和哈希连接的数据超出 work_mem 时额外计入临时文件的读写
+// 基数由 ANALYZE 收集的表行数和列的统计信息估计：列与常量的比较使用 MCV 列表和直方图，
+// 列之间的比较使用不同值个数，缺少的信息使用经验选择率
+class CostModel {
+ public:
+  // work_mem 为单个执行器可使用的内存（字节）
+  CostModel(Catalog &catalog, BufferPool &buffer_pool, size_t work_mem);
+
+  // 计划中的所有表都已 ANALYZE 时返回 true，否则优化器保持基于规则的选择
+  bool HasStatistics(const Operator &plan);
+  // 估计算子输出的行数
+  double EstimateRows(const Operator &plan);
+  // 估计执行整个计划的代价
+  double EstimateCost(const Operator &plan);
+  // 估计谓词的选择率。right 不为空时为连接条件，列按 is_left 分别来自 left 和 right 的输出
+  double EstimateSelectivity(const OperatorExpression &predicate, const Operator &left,
+                             const Operator *right = nullptr);
+
+ private:
+  // 表达式为来自基表的列时，返回该列的不同值个数
+  std::optional<double> ColumnDistinct(const OperatorExpression &expr, const Operator &left, const Operator *right);
+  std::optional<double> ColumnDistinct(const Operator &plan, size_t col_idx);
+  // 表达式为来自基表的列时，返回该列的统计信息
+  std::shared_ptr<const ColumnStatistics> ColumnStatisticsOf(const OperatorExpression &expr, const Operator &left,
+                                                             const Operator *right);
+  std::shared_ptr<const ColumnStatistics> ColumnStatisticsOf(const Operator &plan, size_t col_idx);
+  // 由统计信息估计列与常量比较的选择率，无法使用统计信息时返回 nullopt
+  std::optional<double> ComparisonSelectivity(ComparisonType type, const OperatorExpression &lhs,
+                                              const OperatorExpression &rhs, const Operator &left,
+                                              const Operator *right);
+  // 等值连接的选择率，keys 两两相等
+  double EquiJoinSelectivity(const std::vector<std::shared_ptr<OperatorExpression>> &left_keys,
+                             const std::vector<std::shared_ptr<OperatorExpression>> &right_keys, const Operator &left,
+                             const Operator &right);
+  // 各种连接类型的输出行数，inner_rows 为内连接的行数
+  double JoinRows(JoinType join_type, double left_rows, double right_rows, double inner_rows) const;
+  // 索引项的估计字节数
+  static double IndexKeyWidth(const IndexScanOperator &index_scan);
+  // 在 cardinality 条记录的索引中查找一个键时，从根结点下降到叶结点读取的页面数
+  static double IndexProbePages(const IndexScanOperator &index_scan, double cardinality);
+  // 一条输出记录的估计字节数
+  static double RowWidth(const Operator &plan);
+  // rows 条宽度为 width 的记录占用的页面数
+  static double Pages(double rows, double width);
+  // 从共有 table_pages 个页面的表中读取 pages 个页面的 I/O 代价，random 表示随机读取
+  double TableIoCost(oid_t table_oid, double table_pages, double pages, bool random);
+  // 超出 work_mem 时写出并读回临时文件的代价
+  double SpillCost(double rows, double width) const;
+  double SortCost(double rows, double width) const;
+
+  Catalog &catalog_;
+  BufferPool &buffer_pool_;
+  size_t work_mem_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,441 @@
+#include "optimizer/expression_simplifier.h"
+
+#include <map>
+#include <optional>
+#include <utility>
+
+namespace huadb {
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::Simplify(std::shared_ptr<OperatorExpression> expr,
+                                                                   bool is_predicate) {
+  if (expr == nullptr) {
+    return expr;
+  }
+  expr = SimplifyNode(std::move(expr), is_predicate);
+  if (is_predicate) {
+    expr = MergeRanges(std::move(expr));
+  }
+  return expr;
+}
+
+bool ExpressionSimplifier::IsConstBool(const OperatorExpression &expr, bool value) {
+  if (expr.GetExprType() != OperatorExpressionType::CONST) {
+    return false;
+  }
+  const auto &const_value = dynamic_cast<const Const &>(expr).value_;
+  return !const_value.IsNull() && const_value.GetType() == Type::BOOL && const_value.GetValue<bool>() == value;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::SimplifyNode(std::shared_ptr<OperatorExpression> expr,
+                                                                       bool is_predicate) {
+  // 自底向上化简，AND 的子表达式仍处于谓词上下文，其余表达式的子表达式不是
+  bool child_is_predicate = false;
+  if (is_predicate && expr->GetExprType() == OperatorExpressionType::LOGIC) {
+    child_is_predicate = std::dynamic_pointer_cast<Logic>(expr)->GetLogicType() == LogicType::AND;
+  }
+  auto children = GetChildren(*expr);
+  bool changed = false;
+  for (auto &child : children) {
+    auto new_child = SimplifyNode(child, child_is_predicate);
+    if (new_child != child) {
+      child = std::move(new_child);
+      changed = true;
+    }
+  }
+  // 表达式可能在计划的多处共享，不原地修改，而是重建节点
+  if (changed) {
+    expr = Rebuild(expr, std::move(children));
+  }
+
+  expr = FoldConstant(std::move(expr));
+  switch (expr->GetExprType()) {
+    case OperatorExpressionType::ARITHMETIC:
+      return SimplifyArithmetic(std::move(expr));
+    case OperatorExpressionType::LOGIC:
+      return SimplifyLogic(std::move(expr), is_predicate);
+    case OperatorExpressionType::COMPARISON:
+      return SimplifyComparison(std::move(expr), is_predicate);
+    default:
+      return expr;
+  }
+}
+
+std::vector<std::shared_ptr<OperatorExpression>> ExpressionSimplifier::GetChildren(const OperatorExpression &expr) {
+  switch (expr.GetExprType()) {
+    case OperatorExpressionType::ARITHMETIC:
+    case OperatorExpressionType::COMPARISON:
+    case OperatorExpressionType::LOGIC:
+      return expr.children_;
+    case OperatorExpressionType::FUNC_CALL:
+      return dynamic_cast<const FuncCall &>(expr).args_;
+    case OperatorExpressionType::LIST:
+      return dynamic_cast<const List &>(expr).exprs_;
+    case OperatorExpressionType::NULL_TEST:
+      return {dynamic_cast<const NullTest &>(expr).arg_};
+    case OperatorExpressionType::TYPE_CAST:
+      return {dynamic_cast<const TypeCast &>(expr).arg_};
+    default:
+      return {};
+  }
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::Rebuild(
+    const std::shared_ptr<OperatorExpression> &expr, std::vector<std::shared_ptr<OperatorExpression>> children) {
+  std::shared_ptr<OperatorExpression> result;
+  switch (expr->GetExprType()) {
+    case OperatorExpressionType::ARITHMETIC:
+      result = std::make_shared<Arithmetic>(std::dynamic_pointer_cast<Arithmetic>(expr)->GetArithmeticType(),
+                                            children[0], children[1]);
+      break;
+    case OperatorExpressionType::COMPARISON:
+      result = std::make_shared<Comparison>(std::dynamic_pointer_cast<Comparison>(expr)->GetComparisonType(),
+                                            children[0], children[1]);
+      break;
+    case OperatorExpressionType::LOGIC: {
+      auto logic_type = std::dynamic_pointer_cast<Logic>(expr)->GetLogicType();
+      if (logic_type == LogicType::NOT) {
+        result = std::make_shared<Logic>(logic_type, children[0]);
+      } else {
+        result = std::make_shared<Logic>(logic_type, children[0], children[1]);
+      }
+      break;
+    }
+    case OperatorExpressionType::FUNC_CALL:
+      result = std::make_shared<FuncCall>(std::dynamic_pointer_cast<FuncCall>(expr)->function_name_,
+                                          std::move(children));
+      break;
+    case OperatorExpressionType::LIST:
+      result = std::make_shared<List>(std::move(children));
+      break;
+    case OperatorExpressionType::NULL_TEST:
+      result = std::make_shared<NullTest>(std::dynamic_pointer_cast<NullTest>(expr)->is_null_, children[0]);
+      break;
+    case OperatorExpressionType::TYPE_CAST:
+      result = std::make_shared<TypeCast>(std::dynamic_pointer_cast<TypeCast>(expr)->cast_type_, children[0]);
+      break;
+    default:
+      return expr;
+  }
+  result->SetName(expr->name_);
+  return result;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::FoldConstant(std::shared_ptr<OperatorExpression> expr) {
+  // 列表本身保留，由 IN 比较使用
+  if (expr->GetExprType() == OperatorExpressionType::LIST) {
+    return expr;
+  }
+  auto children = GetChildren(*expr);
+  if (children.empty()) {
+    return expr;
+  }
+  for (const auto &child : children) {
+    if (child->GetExprType() == OperatorExpressionType::LIST) {
+      for (const auto &element : GetChildren(*child)) {
+        if (!IsConst(*element)) {
+          return expr;
+        }
+      }
+    } else if (!IsConst(*child)) {
+      return expr;
+    }
+  }
+  // 整数除零在执行时报错，不在优化阶段求值
+  if (expr->GetExprType() == OperatorExpressionType::ARITHMETIC &&
+      std::dynamic_pointer_cast<Arithmetic>(expr)->GetArithmeticType() == ArithmeticType::DIV) {
+    auto divisor = children[1]->Evaluate(nullptr);
+    if (!divisor.IsNull() && divisor.GetType() == Type::INT && divisor.GetValue<int32_t>() == 0) {
+      return expr;
+    }
+  }
+  Value value;
+  try {
+    value = expr->Evaluate(nullptr);
+  } catch (DbException &) {
+    // 求值出错时保留原表达式，错误推迟到执行时报告
+    return expr;
+  }
+  auto result = std::make_shared<Const>(value);
+  result->SetName(expr->name_);
+  return result;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::SimplifyArithmetic(std::shared_ptr<OperatorExpression> expr) {
+  // 整数加法和乘法重结合：(e + c1) + c2 => e + (c1 + c2)
+  // 浮点数重结合会改变舍入结果，不做处理
+  auto arithmetic_type = std::dynamic_pointer_cast<Arithmetic>(expr)->GetArithmeticType();
+  if (arithmetic_type != ArithmeticType::ADD && arithmetic_type != ArithmeticType::MUL) {
+    return expr;
+  }
+  auto left = expr->children_[0];
+  auto right = expr->children_[1];
+  if (left->GetExprType() != OperatorExpressionType::ARITHMETIC || !IsConst(*right) ||
+      right->GetValueType() != Type::INT) {
+    return expr;
+  }
+  auto left_arithmetic = std::dynamic_pointer_cast<Arithmetic>(left);
+  auto inner_expr = left_arithmetic->children_[0];
+  auto inner_const = left_arithmetic->children_[1];
+  // 所有操作数都必须是整数，DOUBLE 列与整数常量运算的结果仍是浮点数
+  if (left_arithmetic->GetArithmeticType() != arithmetic_type || !IsConst(*inner_const) ||
+      inner_const->GetValueType() != Type::INT || inner_expr->GetValueType() != Type::INT) {
+    return expr;
+  }
+  auto folded = FoldConstant(std::make_shared<Arithmetic>(arithmetic_type, inner_const, right));
+  auto result = std::make_shared<Arithmetic>(arithmetic_type, inner_expr, folded);
+  result->SetName(expr->name_);
+  return result;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::SimplifyLogic(std::shared_ptr<OperatorExpression> expr,
+                                                                        bool is_predicate) {
+  auto logic_type = std::dynamic_pointer_cast<Logic>(expr)->GetLogicType();
+  if (logic_type == LogicType::NOT) {
+    // NOT NOT p => p
+    const auto &arg = expr->children_[0];
+    if (arg->GetExprType() == OperatorExpressionType::LOGIC &&
+        std::dynamic_pointer_cast<Logic>(arg)->GetLogicType() == LogicType::NOT &&
+        arg->children_[0]->GetValueType() == Type::BOOL) {
+      return arg->children_[0];
+    }
+    return expr;
+  }
+  bool identity = logic_type == LogicType::AND;
+  for (size_t i = 0; i < 2; i++) {
+    const auto &operand = expr->children_[i];
+    const auto &other = expr->children_[1 - i];
+    // true AND p => p，false OR p => p
+    if (IsConstBool(*operand, identity) && other->GetValueType() == Type::BOOL) {
+      return other;
+    }
+    // false AND p => false，true OR p => true
+    // NULL 参与运算时结果为 NULL，仅在谓词上下文中与 false 等价
+    if (is_predicate && IsConstBool(*operand, !identity)) {
+      return operand;
+    }
+  }
+  return expr;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::SimplifyComparison(std::shared_ptr<OperatorExpression> expr,
+                                                                             bool is_predicate) {
+  auto comparison_type = std::dynamic_pointer_cast<Comparison>(expr)->GetComparisonType();
+  auto left = expr->children_[0];
+  auto right = expr->children_[1];
+
+  // 规范化：c op col => col op' c
+  if (left->GetExprType() != OperatorExpressionType::COLUMN_VALUE &&
+      right->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
+    std::optional<ComparisonType> flipped;
+    switch (comparison_type) {
+      case ComparisonType::EQUAL:
+      case ComparisonType::NOT_EQUAL:
+        flipped = comparison_type;
+        break;
+      case ComparisonType::LESS:
+        flipped = ComparisonType::GREATER;
+        break;
+      case ComparisonType::LESS_EQUAL:
+        flipped = ComparisonType::GREATER_EQUAL;
+        break;
+      case ComparisonType::GREATER:
+        flipped = ComparisonType::LESS;
+        break;
+      case ComparisonType::GREATER_EQUAL:
+        flipped = ComparisonType::LESS_EQUAL;
+        break;
+      default:
+        break;
+    }
+    if (flipped.has_value()) {
+      auto result = std::make_shared<Comparison>(*flipped, right, left);
+      result->SetName(expr->name_);
+      return result;
+    }
+  }
+
+  // 谓词上下文中 col BETWEEN c1 AND c2 => col >= c1 AND col <= c2，以便与其他范围谓词合并
+  if (is_predicate && comparison_type == ComparisonType::BETWEEN &&
+      left->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
+      right->GetExprType() == OperatorExpressionType::LIST) {
+    auto bounds = GetChildren(*right);
+    if (bounds.size() == 2 && IsConst(*bounds[0]) && IsConst(*bounds[1])) {
+      auto lower = std::make_shared<Comparison>(ComparisonType::GREATER_EQUAL, left, bounds[0]);
+      auto upper = std::make_shared<Comparison>(ComparisonType::LESS_EQUAL, left, bounds[1]);
+      return std::make_shared<Logic>(LogicType::AND, lower, upper);
+    }
+  }
+  return expr;
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::MergeRanges(std::shared_ptr<OperatorExpression> expr) {
+  std::vector<std::shared_ptr<OperatorExpression>> conjuncts;
+  SplitConjuncts(expr, conjuncts);
+
+  // 按列分组 col op c 形式的谓词，键为 (列下标, 是否为左表列)
+  std::map<std::pair<size_t, bool>, std::vector<size_t>> groups;
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    const auto &conjunct = conjuncts[i];
+    if (IsConstBool(*conjunct, false)) {
+      return conjunct;
+    }
+    if (conjunct->GetExprType() != OperatorExpressionType::COMPARISON) {
+      continue;
+    }
+    auto comparison_type = std::dynamic_pointer_cast<Comparison>(conjunct)->GetComparisonType();
+    if (comparison_type != ComparisonType::EQUAL && comparison_type != ComparisonType::LESS &&
+        comparison_type != ComparisonType::LESS_EQUAL && comparison_type != ComparisonType::GREATER &&
+        comparison_type != ComparisonType::GREATER_EQUAL) {
+      continue;
+    }
+    const auto &left = conjunct->children_[0];
+    const auto &right = conjunct->children_[1];
+    if (left->GetExprType() != OperatorExpressionType::COLUMN_VALUE || !IsConst(*right)) {
+      continue;
+    }
+    auto column = std::dynamic_pointer_cast<ColumnValue>(left);
+    groups[{column->GetColumnIndex(), column->IsLeft()}].push_back(i);
+  }
+
+  std::vector<bool> removed(conjuncts.size(), false);
+  for (const auto &[column, indexes] : groups) {
+    if (indexes.size() < 2) {
+      continue;
+    }
+    // 常量类型一致时才能比较
+    auto type = conjuncts[indexes[0]]->children_[1]->Evaluate(nullptr).GetType();
+    bool comparable = type == Type::INT || type == Type::DOUBLE || type == Type::CHAR || type == Type::VARCHAR;
+    for (auto index : indexes) {
+      auto value = conjuncts[index]->children_[1]->Evaluate(nullptr);
+      comparable = comparable && !value.IsNull() && value.GetType() == type;
+    }
+    if (!comparable) {
+      continue;
+    }
+
+    // 求出最紧的下界、上界以及等值条件
+    std::optional<size_t> equal, lower, upper;
+    bool lower_strict = false, upper_strict = false;
+    bool contradiction = false;
+    for (auto index : indexes) {
+      auto comparison_type = std::dynamic_pointer_cast<Comparison>(conjuncts[index])->GetComparisonType();
+      auto value = conjuncts[index]->children_[1]->Evaluate(nullptr);
+      switch (comparison_type) {
+        case ComparisonType::EQUAL:
+          if (equal.has_value() && !conjuncts[*equal]->children_[1]->Evaluate(nullptr).Equal(value)) {
+            contradiction = true;
+          }
+          equal = index;
+          break;
+        case ComparisonType::GREATER:
+        case ComparisonType::GREATER_EQUAL: {
+          bool strict = comparison_type == ComparisonType::GREATER;
+          if (!lower.has_value()) {
+            lower = index;
+            lower_strict = strict;
+          } else {
+            auto bound = conjuncts[*lower]->children_[1]->Evaluate(nullptr);
+            if (value.Greater(bound) || (value.Equal(bound) && strict && !lower_strict)) {
+              lower = index;
+              lower_strict = strict;
+            }
+          }
+          break;
+        }
+        case ComparisonType::LESS:
+        case ComparisonType::LESS_EQUAL: {
+          bool strict = comparison_type == ComparisonType::LESS;
+          if (!upper.has_value()) {
+            upper = index;
+            upper_strict = strict;
+          } else {
+            auto bound = conjuncts[*upper]->children_[1]->Evaluate(nullptr);
+            if (value.Less(bound) || (value.Equal(bound) && strict && !upper_strict)) {
+              upper = index;
+              upper_strict = strict;
+            }
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
+    std::vector<size_t> kept;
+    if (equal.has_value()) {
+      auto value = conjuncts[*equal]->children_[1]->Evaluate(nullptr);
+      if (lower.has_value()) {
+        auto bound = conjuncts[*lower]->children_[1]->Evaluate(nullptr);
+        contradiction = contradiction || value.Less(bound) || (lower_strict && value.Equal(bound));
+      }
+      if (upper.has_value()) {
+        auto bound = conjuncts[*upper]->children_[1]->Evaluate(nullptr);
+        contradiction = contradiction || value.Greater(bound) || (upper_strict && value.Equal(bound));
+      }
+      kept.push_back(*equal);
+    } else {
+      if (lower.has_value() && upper.has_value()) {
+        auto low = conjuncts[*lower]->children_[1]->Evaluate(nullptr);
+        auto high = conjuncts[*upper]->children_[1]->Evaluate(nullptr);
+        contradiction = low.Greater(high) || (low.Equal(high) && (lower_strict || upper_strict));
+      }
+      if (lower.has_value()) {
+        kept.push_back(*lower);
+      }
+      if (upper.has_value()) {
+        kept.push_back(*upper);
+      }
+    }
+    // 谓词恒为假（列为 NULL 时谓词为 NULL，同样不满足）
+    if (contradiction) {
+      return std::make_shared<Const>(Value(false));
+    }
+    for (auto index : indexes) {
+      removed[index] = true;
+    }
+    for (auto index : kept) {
+      removed[index] = false;
+    }
+  }
+
+  std::vector<std::shared_ptr<OperatorExpression>> result;
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    if (!removed[i] && !IsConstBool(*conjuncts[i], true)) {
+      result.push_back(conjuncts[i]);
+    }
+  }
+  if (result.size() == conjuncts.size()) {
+    return expr;
+  }
+  return MakeConjunction(result);
+}
+
+void ExpressionSimplifier::SplitConjuncts(const std::shared_ptr<OperatorExpression> &expr,
+                                          std::vector<std::shared_ptr<OperatorExpression>> &conjuncts) {
+  if (expr->GetExprType() == OperatorExpressionType::LOGIC &&
+      std::dynamic_pointer_cast<Logic>(expr)->GetLogicType() == LogicType::AND) {
+    SplitConjuncts(expr->children_[0], conjuncts);
+    SplitConjuncts(expr->children_[1], conjuncts);
+  } else {
+    conjuncts.push_back(expr);
+  }
+}
+
+std::shared_ptr<OperatorExpression> ExpressionSimplifier::MakeConjunction(
+    const std::vector<std::shared_ptr<OperatorExpression>> &conjuncts) {
+  if (conjuncts.empty()) {
+    return std::make_shared<Const>(Value(true));
+  }
+  auto result = conjuncts[0];
+  for (size_t i = 1; i < conjuncts.size(); i++) {
+    result = std::make_shared<Logic>(LogicType::AND, result, conjuncts[i]);
+  }
+  return result;
+}
+
+bool ExpressionSimplifier::IsConst(const OperatorExpression &expr) {
+  return expr.GetExprType() == OperatorExpressionType::CONST;
+}
+
+}  // namespace huadb
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "operators/expressions/expressions.h"
+
+namespace huadb {
+
+// 表达式化简：常量折叠、布尔代数化简、比较规范化（列在左侧）以及同一列上范围谓词的合并
+class ExpressionSimplifier {
+ public:
+  // is_predicate 表示表达式作为过滤或连接条件使用，此时结果为 NULL 与 false 等价
+  static std::shared_ptr<OperatorExpression> Simplify(std::shared_ptr<OperatorExpression> expr, bool is_predicate);
+  static bool IsConstBool(const OperatorExpression &expr, bool value);
+  // 将 AND 连接的谓词拆分为合取项，以及将合取项重新组合，没有合取项时为常量 true
+  static void SplitConjuncts(const std::shared_ptr<OperatorExpression> &expr,
+                             std::vector<std::shared_ptr<OperatorExpression>> &conjuncts);
+  static std::shared_ptr<OperatorExpression> MakeConjunction(
+      const std::vector<std::shared_ptr<OperatorExpression>> &conjuncts);
+
+ private:
+  static std::shared_ptr<OperatorExpression> SimplifyNode(std::shared_ptr<OperatorExpression> expr, bool is_predicate);
+  static std::vector<std::shared_ptr<OperatorExpression>> GetChildren(const OperatorExpression &expr);
+  // 使用新的子表达式重建节点，保留原有名字
+  static std::shared_ptr<OperatorExpression> Rebuild(const std::shared_ptr<OperatorExpression> &expr,
+                                                     std::vector<std::shared_ptr<OperatorExpression>> children);
+  static std::shared_ptr<OperatorExpression> FoldConstant(std::shared_ptr<OperatorExpression> expr);
+  static std::shared_ptr<OperatorExpression> SimplifyArithmetic(std::shared_ptr<OperatorExpression> expr);
+  static std::shared_ptr<OperatorExpression> SimplifyLogic(std::shared_ptr<OperatorExpression> expr,
+                                                           bool is_predicate);
+  static std::shared_ptr<OperatorExpression> SimplifyComparison(std::shared_ptr<OperatorExpression> expr,
+                                                                bool is_predicate);
+  static std::shared_ptr<OperatorExpression> MergeRanges(std::shared_ptr<OperatorExpression> expr);
+  static bool IsConst(const OperatorExpression &expr);
+};
+
+}  // namespace huadb
@@ -1,17 +1,245 @@
 #include "optimizer/optimizer.h"
 
+#include <algorithm>
+#include <optional>
+
+#include "common/hyper_log_log.h"
+#include "common/sort_key.h"
+#include "operators/operators.h"
+#include "optimizer/expression_simplifier.h"
+#include "planner/planner.h"
+
 namespace huadb {
 
-Optimizer::Optimizer(Catalog &catalog, JoinOrderAlgorithm join_order_algorithm)
-    : catalog_(catalog), join_order_algorithm_(join_order_algorithm) {}
+// 超过该行数时 Top-N 的堆不比完整排序更划算，保留 OrderBy 和 Limit
+static constexpr size_t TOP_N_MAX_ROWS = 10000;
+
+// 算子的输出按哪些列有序，按排序的优先级排列，每项为列的位置和是否降序
+static std::vector<std::pair<size_t, bool>> OutputOrder(const Operator &plan) {
+  std::vector<std::pair<size_t, bool>> order;
+  switch (plan.GetType()) {
+    case OperatorType::ORDERBY:
+    case OperatorType::TOPN: {
+      const auto &order_bys = plan.GetType() == OperatorType::ORDERBY
+                                  ? dynamic_cast<const OrderByOperator &>(plan).order_bys_
+                                  : dynamic_cast<const TopNOperator &>(plan).order_bys_;
+      for (const auto &[order_by_type, expr] : order_bys) {
+        if (expr->GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+          break;
+        }
+        order.emplace_back(dynamic_cast<const ColumnValue &>(*expr).GetColumnIndex(),
+                           order_by_type == OrderByType::DESC);
+      }
+      break;
+    }
+    case OperatorType::INDEXSCAN: {
+      // 索引扫描按键列升序输出，NULL 排在最后，与升序排序一致；哈希索引的输出无序
+      const auto &index_scan = dynamic_cast<const IndexScanOperator &>(plan);
+      if (index_scan.GetIndexType() == IndexType::HASH) {
+        break;
+      }
+      for (auto col_idx : index_scan.GetKeyColumns()) {
+        order.emplace_back(col_idx, false);
+      }
+      break;
+    }
+    case OperatorType::FILTER:
+    case OperatorType::LIMIT:
+    case OperatorType::LOCK_ROWS:
+      return OutputOrder(*plan.GetChildren()[0]);
+    case OperatorType::PROJECTION:
+    case OperatorType::AGGREGATE: {
+      // 子节点的有序列经投影或流式聚集后的位置
+      const auto &exprs = plan.GetType() == OperatorType::PROJECTION
+                              ? dynamic_cast<const ProjectionOperator &>(plan).exprs_
+                              : dynamic_cast<const AggregateOperator &>(plan).group_bys_;
+      if (plan.GetType() == OperatorType::AGGREGATE &&
+          dynamic_cast<const AggregateOperator &>(plan).algorithm_ != AggregateAlgorithm::SORT) {
+        break;
+      }
+      for (auto [col_idx, descending] : OutputOrder(*plan.GetChildren()[0])) {
+        size_t i = 0;
+        while (i < exprs.size() && !(exprs[i]->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
+                                     dynamic_cast<const ColumnValue &>(*exprs[i]).GetColumnIndex() == col_idx)) {
+          i++;
+        }
+        if (i == exprs.size()) {
+          break;
+        }
+        order.emplace_back(i, descending);
+      }
+      break;
+    }
+    case OperatorType::INDEXNESTEDLOOP:
+      // 按外表记录的顺序输出，外表的列位置不变
+      return OutputOrder(*plan.GetChildren()[0]);
+    case OperatorType::MERGEJOIN: {
+      // 内连接、左外连接、半连接和反连接的输出按左侧连接键升序排列
+      const auto &join = dynamic_cast<const MergeJoinOperator &>(plan);
+      if (join.join_type_ == JoinType::INNER || join.join_type_ == JoinType::LEFT ||
+          join.join_type_ == JoinType::SEMI || join.join_type_ == JoinType::ANTI) {
+        for (const auto &key : join.left_keys_) {
+          if (key->GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+            break;
+          }
+          order.emplace_back(dynamic_cast<const ColumnValue &>(*key).GetColumnIndex(), false);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return order;
+}
+
+// 算子的输出顺序是否满足 order_bys，满足时上方的排序可以删除
+static bool SatisfiesOrder(const Operator &plan,
+                           const std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> &order_bys) {
+  auto order = OutputOrder(plan);
+  if (order_bys.size() > order.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < order_bys.size(); i++) {
+    const auto &[order_by_type, expr] = order_bys[i];
+    if (expr->GetExprType() != OperatorExpressionType::COLUMN_VALUE ||
+        std::dynamic_pointer_cast<ColumnValue>(expr)->GetColumnIndex() != order[i].first ||
+        (order_by_type == OrderByType::DESC) != order[i].second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 分组列是否恰好为 order 的前若干列
+static bool GroupsMatchOrder(const AggregateOperator &aggregate, const std::vector<std::pair<size_t, bool>> &order) {
+  const auto &group_bys = aggregate.group_bys_;
+  if (group_bys.empty() || order.size() < group_bys.size()) {
+    return false;
+  }
+  std::vector<bool> covered(group_bys.size(), false);
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    size_t j = 0;
+    while (j < group_bys.size() &&
+           !(group_bys[j]->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
+             dynamic_cast<const ColumnValue &>(*group_bys[j]).GetColumnIndex() == order[i].first)) {
+      j++;
+    }
+    if (j == group_bys.size()) {
+      return false;
+    }
+    covered[j] = true;
+  }
+  return std::all_of(covered.begin(), covered.end(), [](bool c) { return c; });
+}
+
+Optimizer::Optimizer(Catalog &catalog, BufferPool &buffer_pool, JoinOrderAlgorithm join_order_algorithm,
+                     ForceJoin force_join, size_t work_mem, size_t max_parallel_workers)
+    : catalog_(catalog),
+      cost_model_(catalog, buffer_pool, work_mem),
+      join_order_algorithm_(join_order_algorithm),
+      force_join_(force_join),
+      max_parallel_workers_(max_parallel_workers) {}
 
 std::shared_ptr<Operator> Optimizer::Optimize(std::shared_ptr<Operator> plan) {
+  plan = SimplifyExpressions(plan);
   plan = SplitPredicates(plan);
   plan = PushDown(plan);
   plan = ReorderJoin(plan);
+  plan = ChooseIndexScans(plan);
+  plan = ChooseJoinAlgorithms(plan);
+  plan = ChooseZonePredicates(plan);
+  plan = FuseTopN(plan);
+  plan = RewriteDistinctAggregates(plan);
+  plan = ChooseAggregateAlgorithm(plan);
+  plan = ElideSorts(plan);
+  plan = ChooseIndexOnlyScans(plan);
+  if (max_parallel_workers_ > 0) {
+    plan = Parallelize(plan);
+  }
   return plan;
 }
 
+// 子树能否复制给多个 worker 各执行一份：最左侧路径上的顺序扫描按页面划分，连接的右侧在每个 worker 中完整执行
+// 右外连接和全外连接需要汇总所有 worker 的匹配情况才能输出右侧未匹配的记录，不能并行
+static bool IsParallelSafe(const Operator &plan) {
+  switch (plan.GetType()) {
+    case OperatorType::SEQSCAN:
+      return !dynamic_cast<const SeqScanOperator &>(plan).HasLock();
+    case OperatorType::FILTER:
+    case OperatorType::PROJECTION:
+      return IsParallelSafe(*plan.GetChildren()[0]);
+    case OperatorType::HASHJOIN:
+    case OperatorType::NESTEDLOOP: {
+      auto join_type = plan.GetType() == OperatorType::HASHJOIN
+                           ? dynamic_cast<const HashJoinOperator &>(plan).join_type_
+                           : dynamic_cast<const NestedLoopJoinOperator &>(plan).join_type_;
+      return join_type != JoinType::RIGHT && join_type != JoinType::FULL && IsParallelSafe(*plan.GetChildren()[0]);
+    }
+    case OperatorType::INDEXNESTEDLOOP:
+      return IsParallelSafe(*plan.GetChildren()[0]);
+    default:
+      return false;
+  }
+}
+
+static void MarkParallelScan(Operator &plan) {
+  auto *node = &plan;
+  while (node->GetType() != OperatorType::SEQSCAN) {
+    node = node->children_[0].get();
+  }
+  dynamic_cast<SeqScanOperator &>(*node).parallel_ = true;
+}
+
+std::shared_ptr<Operator> Optimizer::SimplifyExpressions(std::shared_ptr<Operator> plan) {
+  // 化简计划中的表达式：常量折叠、布尔代数化简、比较规范化以及范围谓词合并
+  for (auto &child : plan->children_) {
+    child = SimplifyExpressions(child);
+  }
+  switch (plan->GetType()) {
+    case OperatorType::FILTER: {
+      auto filter = std::dynamic_pointer_cast<FilterOperator>(plan);
+      filter->predicate_ = ExpressionSimplifier::Simplify(filter->predicate_, true);
+      // 谓词恒为真时删除 Filter 节点
+      if (ExpressionSimplifier::IsConstBool(*filter->predicate_, true)) {
+        return plan->children_[0];
+      }
+      break;
+    }
+    case OperatorType::NESTEDLOOP: {
+      auto join = std::dynamic_pointer_cast<NestedLoopJoinOperator>(plan);
+      join->join_condition_ = ExpressionSimplifier::Simplify(join->join_condition_, true);
+      break;
+    }
+    case OperatorType::PROJECTION:
+      SimplifyExpressionList(std::dynamic_pointer_cast<ProjectionOperator>(plan)->exprs_);
+      break;
+    case OperatorType::UPDATE:
+      SimplifyExpressionList(std::dynamic_pointer_cast<UpdateOperator>(plan)->update_exprs_);
+      break;
+    case OperatorType::ORDERBY:
+      for (auto &[order_by_type, expr] : std::dynamic_pointer_cast<OrderByOperator>(plan)->order_bys_) {
+        expr = ExpressionSimplifier::Simplify(expr, false);
+      }
+      break;
+    case OperatorType::AGGREGATE: {
+      auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(plan);
+      SimplifyExpressionList(aggregate->group_bys_);
+      SimplifyExpressionList(aggregate->aggregates_);
+      break;
+    }
+    default:
+      break;
+  }
+  return plan;
+}
+
+void Optimizer::SimplifyExpressionList(std::vector<std::shared_ptr<OperatorExpression>> &exprs) {
+  for (auto &expr : exprs) {
+    expr = ExpressionSimplifier::Simplify(expr, false);
+  }
+}
+
 std::shared_ptr<Operator> Optimizer::SplitPredicates(std::shared_ptr<Operator> plan) {
   // 分解复合的选择谓词
   // 遍历查询计划树，判断每个节点是否为 Filter 节点
@@ -76,4 +304,842 @@ std::shared_ptr<Operator> Optimizer::ReorderJoin(std::shared_ptr<Operator> plan)
   return plan;
 }
 
+// 将与列比较的常量转换为索引键列的类型，无法无损转换时返回空
+static std::optional<Value> ConvertKeyValue(const Value &value, Type col_type) {
+  if (value.IsNull()) {
+    return std::nullopt;
+  }
+  auto type = value.GetType();
+  if (type == col_type) {
+    return value;
+  }
+  if (col_type == Type::DOUBLE && type == Type::INT) {
+    return Value(static_cast<double>(value.GetValue<int32_t>()));
+  }
+  if ((col_type == Type::CHAR || col_type == Type::VARCHAR) && (type == Type::CHAR || type == Type::VARCHAR)) {
+    return Value(value.GetValue<std::string>(), col_type);
+  }
+  return std::nullopt;
+}
+
+// 可用于确定索引扫描范围的合取项：col op const，或 col IN (const, ...)
+struct KeyComparison {
+  size_t col_idx_;
+  ComparisonType type_;
+  // 转换后的常量，IN 列表去掉 NULL 和重复值后按键的顺序排列
+  std::vector<Value> values_;
+};
+
+// 合取项为可用于索引的比较时，返回列的下标、比较类型和转换为列类型的常量
+static std::optional<KeyComparison> MatchKeyComparison(const std::shared_ptr<OperatorExpression> &expr,
+                                                       const ColumnList &column_list) {
+  if (expr->GetExprType() != OperatorExpressionType::COMPARISON ||
+      expr->children_[0]->GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+    return std::nullopt;
+  }
+  auto type = std::dynamic_pointer_cast<Comparison>(expr)->GetComparisonType();
+  auto col_idx = std::dynamic_pointer_cast<ColumnValue>(expr->children_[0])->GetColumnIndex();
+  auto col_type = column_list.GetColumn(col_idx).type_;
+  if (type == ComparisonType::IN) {
+    if (expr->children_[1]->GetExprType() != OperatorExpressionType::LIST) {
+      return std::nullopt;
+    }
+    // NULL 与任何值比较都不为真，可以直接去掉
+    std::vector<std::pair<std::string, Value>> keyed_values;
+    for (const auto &item : std::dynamic_pointer_cast<List>(expr->children_[1])->exprs_) {
+      if (item->GetExprType() != OperatorExpressionType::CONST) {
+        return std::nullopt;
+      }
+      const auto &item_value = std::dynamic_pointer_cast<Const>(item)->value_;
+      if (item_value.IsNull()) {
+        continue;
+      }
+      auto value = ConvertKeyValue(item_value, col_type);
+      if (!value.has_value()) {
+        return std::nullopt;
+      }
+      std::string key;
+      SortKey::Append(*value, false, key);
+      keyed_values.emplace_back(std::move(key), std::move(*value));
+    }
+    std::sort(keyed_values.begin(), keyed_values.end(),
+              [](const auto &lhs, const auto &rhs) { return SortKey::Compare(lhs.first, rhs.first) < 0; });
+    KeyComparison comparison{col_idx, type, {}};
+    for (size_t i = 0; i < keyed_values.size(); i++) {
+      if (i == 0 || keyed_values[i].first != keyed_values[i - 1].first) {
+        comparison.values_.push_back(std::move(keyed_values[i].second));
+      }
+    }
+    return comparison;
+  }
+  if (expr->children_[1]->GetExprType() != OperatorExpressionType::CONST) {
+    return std::nullopt;
+  }
+  if (type != ComparisonType::EQUAL && type != ComparisonType::LESS && type != ComparisonType::LESS_EQUAL &&
+      type != ComparisonType::GREATER && type != ComparisonType::GREATER_EQUAL) {
+    return std::nullopt;
+  }
+  auto value = ConvertKeyValue(std::dynamic_pointer_cast<Const>(expr->children_[1])->value_, col_type);
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+  return KeyComparison{col_idx, type, {std::move(*value)}};
+}
+
+std::shared_ptr<Operator> Optimizer::ChooseIndexScans(std::shared_ptr<Operator> plan,
+                                                      const OrderByOperator *order_by) {
+  // 基于规则选择索引：顺序扫描上方的谓词能确定某个索引键列前缀的扫描范围时，改为索引扫描
+  // 优先选择等值匹配的键列最多的索引，其次是最后一个键列上有范围条件的索引，相同时优先选择哈希索引，
+  // 但上方的排序可以被 B+ 树索引的顺序消除时优先选择 B+ 树索引
+  // 键列上的 IN 条件视为等值条件，每个值对应一个扫描范围，为限制范围的个数，每个索引只使用一个 IN 条件
+  // 哈希索引只在全部键列都有等值或 IN 条件时可用
+  for (auto &child : plan->children_) {
+    child = ChooseIndexScans(child, plan->GetType() == OperatorType::ORDERBY
+                                        ? dynamic_cast<const OrderByOperator *>(plan.get())
+                                        : nullptr);
+  }
+  if (plan->GetType() != OperatorType::FILTER || plan->children_[0]->GetType() != OperatorType::SEQSCAN) {
+    return plan;
+  }
+  auto filter = std::dynamic_pointer_cast<FilterOperator>(plan);
+  auto scan = std::dynamic_pointer_cast<SeqScanOperator>(plan->children_[0]);
+  if (scan->HasLock()) {
+    return plan;
+  }
+  std::vector<std::shared_ptr<OperatorExpression>> conjuncts;
+  ExpressionSimplifier::SplitConjuncts(filter->predicate_, conjuncts);
+  const auto &column_list = scan->OutputColumns();
+  std::vector<std::optional<KeyComparison>> comparisons;
+  for (const auto &conjunct : conjuncts) {
+    comparisons.push_back(MatchKeyComparison(conjunct, column_list));
+  }
+  // 列 col_idx 上类型为 type 的第一个未使用的合取项
+  auto find_comparison = [&comparisons](size_t col_idx, ComparisonType type) -> std::optional<size_t> {
+    for (size_t i = 0; i < comparisons.size(); i++) {
+      if (comparisons[i] && comparisons[i]->col_idx_ == col_idx && comparisons[i]->type_ == type) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  };
+
+  // 转换为扫描范围的合取项由索引扫描保证，其余合取项保留在 Filter 中
+  auto make_index_scan = [&filter, &scan, &conjuncts](const std::shared_ptr<Index> &index,
+                                                      std::vector<IndexRange> ranges,
+                                                      const std::vector<bool> &used) -> std::shared_ptr<Operator> {
+    std::vector<std::shared_ptr<OperatorExpression>> index_conds, residuals;
+    for (size_t i = 0; i < conjuncts.size(); i++) {
+      (used[i] ? index_conds : residuals).push_back(conjuncts[i]);
+    }
+    auto index_scan = std::make_shared<IndexScanOperator>(
+        scan->column_list_, scan->GetTableOid(), scan->GetTableName(), scan->GetAlias(), index->GetOid(),
+        index->GetName(), index->GetIndexType(), index->GetKeyColumns(), std::move(ranges),
+        ExpressionSimplifier::MakeConjunction(index_conds));
+    if (residuals.empty()) {
+      return index_scan;
+    }
+    return std::make_shared<FilterOperator>(filter->column_list_, std::move(index_scan),
+                                            ExpressionSimplifier::MakeConjunction(residuals));
+  };
+
+  // 上方有排序时，输出顺序不满足排序的候选计划计入排序的代价，ElideSorts 可以删除满足排序的候选计划上方的排序
+  auto sorted = [order_by](const Operator &candidate) {
+    return order_by != nullptr && SatisfiesOrder(candidate, order_by->order_bys_);
+  };
+  auto estimate_cost = [this, order_by, &sorted](const std::shared_ptr<Operator> &candidate) {
+    if (order_by == nullptr || sorted(*candidate)) {
+      return cost_model_.EstimateCost(*candidate);
+    }
+    return cost_model_.EstimateCost(OrderByOperator(std::make_shared<ColumnList>(candidate->OutputColumns()),
+                                                    candidate, order_by->order_bys_));
+  };
+
+  // 有统计信息时选择代价最小的索引，代价都不低于顺序扫描时保留顺序扫描；否则按上述规则选择
+  // 代价相同时优先选择输出顺序满足上方排序的索引
+  bool use_cost = cost_model_.HasStatistics(*scan);
+  double best_cost = use_cost ? estimate_cost(plan) : 0;
+  std::shared_ptr<Index> best_index;
+  std::shared_ptr<Operator> best_plan;
+  size_t best_score = 0;
+  bool best_sorted = false;
+  for (const auto &index : catalog_.GetTableIndexes(scan->GetTableOid())) {
+    bool hash = index->GetIndexType() == IndexType::HASH;
+    IndexRange range;
+    std::vector<bool> used(conjuncts.size(), false);
+    // IN 条件的值和对应的键列在 equal_values_ 中的位置
+    std::vector<Value> in_values;
+    std::optional<size_t> in_position;
+    size_t matched_count = 0;
+    for (auto key_column : index->GetKeyColumns()) {
+      // 当前键列上的等值或 IN 条件，有则继续匹配下一个键列
+      if (auto i = find_comparison(key_column, ComparisonType::EQUAL)) {
+        range.equal_values_.push_back(comparisons[*i]->values_[0]);
+        used[*i] = true;
+        matched_count++;
+        continue;
+      }
+      if (auto i = find_comparison(key_column, ComparisonType::IN); i && !in_position) {
+        in_values = comparisons[*i]->values_;
+        in_position = range.equal_values_.size();
+        range.equal_values_.emplace_back();
+        used[*i] = true;
+        matched_count++;
+        continue;
+      }
+      if (hash) {
+        break;
+      }
+      // 没有等值条件时，使用该键列上的范围条件，之后的键列不再匹配
+      for (size_t i = 0; i < conjuncts.size(); i++) {
+        if (!comparisons[i] || comparisons[i]->col_idx_ != key_column) {
+          continue;
+        }
+        auto type = comparisons[i]->type_;
+        const auto &value = comparisons[i]->values_[0];
+        if ((type == ComparisonType::GREATER || type == ComparisonType::GREATER_EQUAL) && !range.lower_) {
+          range.lower_ = value;
+          range.lower_inclusive_ = type == ComparisonType::GREATER_EQUAL;
+          used[i] = true;
+        } else if ((type == ComparisonType::LESS || type == ComparisonType::LESS_EQUAL) && !range.upper_) {
+          range.upper_ = value;
+          range.upper_inclusive_ = type == ComparisonType::LESS_EQUAL;
+          used[i] = true;
+        }
+      }
+      break;
+    }
+    if (hash && matched_count != index->GetKeyColumns().size()) {
+      continue;
+    }
+    size_t score = matched_count * 2 + (range.lower_ || range.upper_ ? 1 : 0);
+    if (score == 0) {
+      continue;
+    }
+    if (!use_cost && score < best_score) {
+      continue;
+    }
+    // IN 列表的值按键的顺序排列，各个范围互不重叠，依次扫描时仍按键的顺序输出
+    std::vector<IndexRange> ranges;
+    if (in_position) {
+      for (const auto &value : in_values) {
+        ranges.push_back(range);
+        ranges.back().equal_values_[*in_position] = value;
+      }
+    } else {
+      ranges.push_back(std::move(range));
+    }
+    auto candidate = make_index_scan(index, std::move(ranges), used);
+    bool candidate_sorted = sorted(*candidate);
+    if (use_cost) {
+      auto cost = estimate_cost(candidate);
+      if (cost > best_cost || (cost == best_cost && (best_plan == nullptr || !candidate_sorted || best_sorted))) {
+        continue;
+      }
+      best_cost = cost;
+    } else if (score == best_score &&
+               (candidate_sorted != best_sorted
+                    ? !candidate_sorted
+                    : !(hash && best_index->GetIndexType() != IndexType::HASH))) {
+      continue;
+    }
+    best_index = index;
+    best_plan = std::move(candidate);
+    best_score = score;
+    best_sorted = candidate_sorted;
+  }
+  return best_plan == nullptr ? plan : best_plan;
+}
+
+// 按连接键升序排列的输入，已经有序时不需要排序
+static std::shared_ptr<Operator> SortedByKeys(std::shared_ptr<Operator> plan,
+                                              const std::vector<std::shared_ptr<OperatorExpression>> &keys) {
+  auto order = OutputOrder(*plan);
+  bool sorted = order.size() >= keys.size();
+  for (size_t i = 0; i < keys.size() && sorted; i++) {
+    sorted = keys[i]->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
+             std::dynamic_pointer_cast<ColumnValue>(keys[i])->GetColumnIndex() == order[i].first && !order[i].second;
+  }
+  if (sorted) {
+    return plan;
+  }
+  std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> order_bys;
+  for (const auto &key : keys) {
+    order_bys.emplace_back(OrderByType::ASC, key);
+  }
+  auto column_list = std::make_shared<ColumnList>(plan->OutputColumns());
+  return std::make_shared<OrderByOperator>(std::move(column_list), std::move(plan), std::move(order_bys));
+}
+
+std::shared_ptr<Operator> Optimizer::ChooseJoinAlgorithms(std::shared_ptr<Operator> plan) {
+  // 有统计信息时，按代价为等值连接在嵌套循环、哈希、归并和索引嵌套循环连接中选择算法
+  // 哈希连接以右侧为构建侧，索引嵌套循环连接以右侧为内表，两者都还考虑交换两侧，由投影恢复列的顺序
+  // 没有统计信息时，只在可以按连接键查找内表的索引时改为索引嵌套循环连接，优先以右侧为内表
+  // 通过 force_join 指定连接算法时保持规划器的选择
+  if (force_join_ != ForceJoin::NONE) {
+    return plan;
+  }
+  for (auto &child : plan->children_) {
+    child = ChooseJoinAlgorithms(child);
+  }
+  if (plan->GetType() != OperatorType::NESTEDLOOP && plan->GetType() != OperatorType::HASHJOIN) {
+    return plan;
+  }
+  JoinType join_type;
+  std::vector<std::shared_ptr<OperatorExpression>> left_keys, right_keys;
+  std::vector<std::shared_ptr<Operator>> candidates{plan};
+  if (plan->GetType() == OperatorType::NESTEDLOOP) {
+    auto join = std::dynamic_pointer_cast<NestedLoopJoinOperator>(plan);
+    if (!Planner::ExtractEquiJoinKeys(join->join_condition_, left_keys, right_keys)) {
+      return plan;
+    }
+    join_type = join->join_type_;
+  } else {
+    auto join = std::dynamic_pointer_cast<HashJoinOperator>(plan);
+    if (join->null_aware_) {
+      return plan;
+    }
+    left_keys = join->left_keys_;
+    right_keys = join->right_keys_;
+    join_type = join->join_type_;
+    std::vector<std::shared_ptr<OperatorExpression>> equals;
+    for (size_t i = 0; i < left_keys.size(); i++) {
+      equals.push_back(std::make_shared<Comparison>(ComparisonType::EQUAL, left_keys[i], right_keys[i]));
+    }
+    candidates.push_back(std::make_shared<NestedLoopJoinOperator>(
+        plan->column_list_, plan->children_[0], plan->children_[1], ExpressionSimplifier::MakeConjunction(equals),
+        join_type));
+  }
+  const auto &left = plan->children_[0];
+  const auto &right = plan->children_[1];
+  // 交换两侧的连接之上由投影恢复列的顺序
+  auto restore_columns = [&plan, &left, &right](std::shared_ptr<Operator> swapped) {
+    auto left_count = left->OutputColumns().Length();
+    auto right_count = right->OutputColumns().Length();
+    std::vector<std::shared_ptr<OperatorExpression>> exprs;
+    for (size_t i = 0; i < left_count + right_count; i++) {
+      const auto &column = plan->OutputColumns().GetColumn(i);
+      exprs.push_back(std::make_shared<ColumnValue>(i < left_count ? right_count + i : i - left_count,
+                                                    column.type_, column.name_, column.GetMaxSize()));
+    }
+    return std::make_shared<ProjectionOperator>(plan->column_list_, std::move(swapped), std::move(exprs));
+  };
+  auto index_join = MakeIndexNestedLoopJoin(plan->column_list_, left, right, left_keys, right_keys, join_type);
+  std::shared_ptr<Operator> swapped_index_join;
+  if (join_type == JoinType::INNER || join_type == JoinType::RIGHT) {
+    auto swapped_type = join_type == JoinType::RIGHT ? JoinType::LEFT : JoinType::INNER;
+    if (auto swapped = MakeIndexNestedLoopJoin(Planner::GetJoinColumnList(*right, *left), right, left, right_keys,
+                                               left_keys, swapped_type)) {
+      swapped_index_join = restore_columns(std::move(swapped));
+    }
+  }
+  if (!cost_model_.HasStatistics(*plan)) {
+    return index_join != nullptr ? index_join : swapped_index_join != nullptr ? swapped_index_join : plan;
+  }
+  if (plan->GetType() == OperatorType::NESTEDLOOP) {
+    candidates.push_back(
+        std::make_shared<HashJoinOperator>(plan->column_list_, left, right, left_keys, right_keys, join_type));
+  }
+  if (join_type == JoinType::INNER || join_type == JoinType::LEFT || join_type == JoinType::RIGHT) {
+    auto swapped_type = join_type == JoinType::LEFT    ? JoinType::RIGHT
+                        : join_type == JoinType::RIGHT ? JoinType::LEFT
+                                                       : JoinType::INNER;
+    candidates.push_back(restore_columns(std::make_shared<HashJoinOperator>(
+        Planner::GetJoinColumnList(*right, *left), right, left, right_keys, left_keys, swapped_type)));
+  }
+  if (index_join != nullptr) {
+    candidates.push_back(std::move(index_join));
+  }
+  if (swapped_index_join != nullptr) {
+    candidates.push_back(std::move(swapped_index_join));
+  }
+  candidates.push_back(std::make_shared<MergeJoinOperator>(plan->column_list_, SortedByKeys(left, left_keys),
+                                                           SortedByKeys(right, right_keys), left_keys, right_keys,
+                                                           join_type));
+
+  // 代价相同时保留规划器的选择
+  std::shared_ptr<Operator> best_plan;
+  double best_cost = 0;
+  for (auto &candidate : candidates) {
+    auto cost = cost_model_.EstimateCost(*candidate);
+    if (best_plan == nullptr || cost < best_cost) {
+      best_plan = std::move(candidate);
+      best_cost = cost;
+    }
+  }
+  return best_plan;
+}
+
+std::shared_ptr<Operator> Optimizer::MakeIndexNestedLoopJoin(
+    std::shared_ptr<ColumnList> column_list, std::shared_ptr<Operator> outer, std::shared_ptr<Operator> inner,
+    std::vector<std::shared_ptr<OperatorExpression>> outer_keys,
+    std::vector<std::shared_ptr<OperatorExpression>> inner_keys, JoinType join_type) {
+  // 外表的每条记录独立查找，不需要记录内表的匹配情况，只支持内连接、左外连接、半连接和反连接
+  if (join_type != JoinType::INNER && join_type != JoinType::LEFT && join_type != JoinType::SEMI &&
+      join_type != JoinType::ANTI) {
+    return nullptr;
+  }
+  // 内表上只选取列的投影（如子查询改写得到的半连接）保留在索引扫描之上，连接键经投影对应到表的列
+  std::shared_ptr<ProjectionOperator> projection;
+  auto scan_plan = inner;
+  if (scan_plan->GetType() == OperatorType::PROJECTION) {
+    projection = std::dynamic_pointer_cast<ProjectionOperator>(scan_plan);
+    if (!std::all_of(projection->exprs_.begin(), projection->exprs_.end(), [](const auto &expr) {
+          return expr->GetExprType() == OperatorExpressionType::COLUMN_VALUE;
+        })) {
+      return nullptr;
+    }
+    scan_plan = scan_plan->children_[0];
+  }
+  std::shared_ptr<FilterOperator> filter;
+  if (scan_plan->GetType() == OperatorType::FILTER) {
+    filter = std::dynamic_pointer_cast<FilterOperator>(scan_plan);
+    scan_plan = scan_plan->children_[0];
+  }
+  if (scan_plan->GetType() != OperatorType::SEQSCAN) {
+    return nullptr;
+  }
+  auto scan = std::dynamic_pointer_cast<SeqScanOperator>(scan_plan);
+  if (scan->HasLock()) {
+    return nullptr;
+  }
+  // 内表的连接键须为列，两侧类型相同时外表的值才能直接用于查找索引和比较
+  // scan_keys 为连接键对应的扫描输出的列
+  std::vector<std::shared_ptr<OperatorExpression>> scan_keys;
+  std::vector<size_t> key_columns;
+  for (size_t i = 0; i < inner_keys.size(); i++) {
+    if (inner_keys[i]->GetExprType() != OperatorExpressionType::COLUMN_VALUE ||
+        inner_keys[i]->GetValueType() != outer_keys[i]->GetValueType()) {
+      return nullptr;
+    }
+    auto col_idx = std::dynamic_pointer_cast<ColumnValue>(inner_keys[i])->GetColumnIndex();
+    scan_keys.push_back(projection != nullptr ? projection->exprs_[col_idx] : inner_keys[i]);
+    key_columns.push_back(std::dynamic_pointer_cast<ColumnValue>(scan_keys.back())->GetColumnIndex());
+  }
+
+  // 选择连接键覆盖的键列前缀最长的索引，哈希索引须覆盖全部键列
+  std::shared_ptr<Index> best_index;
+  std::vector<size_t> best_keys;
+  for (const auto &index : catalog_.GetTableIndexes(scan->GetTableOid())) {
+    std::vector<size_t> keys;
+    for (auto key_column : index->GetKeyColumns()) {
+      auto it = std::find(key_columns.begin(), key_columns.end(), key_column);
+      if (it == key_columns.end()) {
+        break;
+      }
+      keys.push_back(it - key_columns.begin());
+    }
+    if (keys.empty() || (index->GetIndexType() == IndexType::HASH && keys.size() < index->GetKeyColumns().size())) {
+      continue;
+    }
+    if (keys.size() > best_keys.size()) {
+      best_index = index;
+      best_keys = std::move(keys);
+    }
+  }
+  if (best_index == nullptr) {
+    return nullptr;
+  }
+
+  // 用于查找索引的连接键按键列的顺序排在前面，其余连接键在取出内表记录后比较
+  std::vector<bool> used(inner_keys.size(), false);
+  std::vector<std::shared_ptr<OperatorExpression>> join_outer_keys, join_inner_keys, index_conds;
+  for (auto i : best_keys) {
+    used[i] = true;
+    join_outer_keys.push_back(outer_keys[i]);
+    join_inner_keys.push_back(inner_keys[i]);
+    index_conds.push_back(std::make_shared<Comparison>(ComparisonType::EQUAL, scan_keys[i], outer_keys[i]));
+  }
+  for (size_t i = 0; i < inner_keys.size(); i++) {
+    if (!used[i]) {
+      join_outer_keys.push_back(outer_keys[i]);
+      join_inner_keys.push_back(inner_keys[i]);
+    }
+  }
+  auto index_scan = std::make_shared<IndexScanOperator>(
+      scan->column_list_, scan->GetTableOid(), scan->GetTableName(), scan->GetAlias(), best_index->GetOid(),
+      best_index->GetName(), best_index->GetIndexType(), best_index->GetKeyColumns(), std::vector<IndexRange>{},
+      ExpressionSimplifier::MakeConjunction(index_conds));
+  index_scan->parameterized_ = true;
+  std::shared_ptr<Operator> new_inner = index_scan;
+  if (filter != nullptr) {
+    new_inner = std::make_shared<FilterOperator>(filter->column_list_, std::move(new_inner), filter->predicate_);
+  }
+  if (projection != nullptr) {
+    new_inner =
+        std::make_shared<ProjectionOperator>(projection->column_list_, std::move(new_inner), projection->exprs_);
+  }
+  return std::make_shared<IndexNestedLoopJoinOperator>(std::move(column_list), std::move(outer), std::move(new_inner),
+                                                       std::move(join_outer_keys), std::move(join_inner_keys),
+                                                       best_keys.size(), join_type);
+}
+
+std::shared_ptr<Operator> Optimizer::ChooseZonePredicates(std::shared_ptr<Operator> plan) {
+  // 顺序扫描上方的谓词中，可以根据区域映射的最小值、最大值和空值个数判断的合取项交给顺序扫描，用于整段跳过页面
+  for (auto &child : plan->children_) {
+    child = ChooseZonePredicates(child);
+  }
+  if (plan->GetType() != OperatorType::FILTER || plan->children_[0]->GetType() != OperatorType::SEQSCAN) {
+    return plan;
+  }
+  auto filter = std::dynamic_pointer_cast<FilterOperator>(plan);
+  auto scan = std::dynamic_pointer_cast<SeqScanOperator>(plan->children_[0]);
+  std::vector<std::shared_ptr<OperatorExpression>> conjuncts;
+  ExpressionSimplifier::SplitConjuncts(filter->predicate_, conjuncts);
+  std::vector<ZonePredicate> predicates;
+  for (const auto &conjunct : conjuncts) {
+    if (conjunct->GetExprType() == OperatorExpressionType::NULL_TEST) {
+      auto null_test = std::dynamic_pointer_cast<NullTest>(conjunct);
+      if (null_test->arg_->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
+        predicates.push_back({std::dynamic_pointer_cast<ColumnValue>(null_test->arg_)->GetColumnIndex(),
+                              null_test->is_null_ ? ZonePredicateType::IS_NULL : ZonePredicateType::IS_NOT_NULL,
+                              {}});
+      }
+      continue;
+    }
+    auto comparison = MatchKeyComparison(conjunct, scan->OutputColumns());
+    if (!comparison) {
+      continue;
+    }
+    ZonePredicateType type;
+    switch (comparison->type_) {
+      case ComparisonType::EQUAL:
+        type = ZonePredicateType::EQUAL;
+        break;
+      case ComparisonType::LESS:
+        type = ZonePredicateType::LESS;
+        break;
+      case ComparisonType::LESS_EQUAL:
+        type = ZonePredicateType::LESS_EQUAL;
+        break;
+      case ComparisonType::GREATER:
+        type = ZonePredicateType::GREATER;
+        break;
+      case ComparisonType::GREATER_EQUAL:
+        type = ZonePredicateType::GREATER_EQUAL;
+        break;
+      default:
+        type = ZonePredicateType::IN;
+        break;
+    }
+    predicates.push_back({comparison->col_idx_, type, std::move(comparison->values_)});
+  }
+  scan->zone_predicates_ = std::move(predicates);
+  return plan;
+}
+
+// 收集表达式引用的列
+static void CollectColumnIndices(const OperatorExpression &expr, std::vector<size_t> &col_indices) {
+  if (expr.GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
+    col_indices.push_back(dynamic_cast<const ColumnValue &>(expr).GetColumnIndex());
+  }
+  for (const auto &child : expr.children_) {
+    CollectColumnIndices(*child, col_indices);
+  }
+}
+
+std::shared_ptr<Operator> Optimizer::ChooseIndexOnlyScans(std::shared_ptr<Operator> plan) {
+  // 投影或聚集之下只经过过滤、排序和 Limit 到达索引扫描时，这些算子引用的列都在索引的键列或包含列中，
+  // 则索引扫描不需要读取表中的其他列，改为仅索引扫描
+  for (auto &child : plan->children_) {
+    child = ChooseIndexOnlyScans(child);
+  }
+  std::vector<size_t> col_indices;
+  if (plan->GetType() == OperatorType::PROJECTION) {
+    for (const auto &expr : std::dynamic_pointer_cast<ProjectionOperator>(plan)->exprs_) {
+      CollectColumnIndices(*expr, col_indices);
+    }
+  } else if (plan->GetType() == OperatorType::AGGREGATE) {
+    auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(plan);
+    for (const auto &expr : aggregate->group_bys_) {
+      CollectColumnIndices(*expr, col_indices);
+    }
+    for (const auto &expr : aggregate->aggregates_) {
+      CollectColumnIndices(*expr, col_indices);
+    }
+  } else {
+    return plan;
+  }
+  auto node = plan->children_[0];
+  while (true) {
+    if (node->GetType() == OperatorType::FILTER) {
+      CollectColumnIndices(*std::dynamic_pointer_cast<FilterOperator>(node)->predicate_, col_indices);
+    } else if (node->GetType() == OperatorType::ORDERBY || node->GetType() == OperatorType::TOPN) {
+      const auto &order_bys = node->GetType() == OperatorType::ORDERBY
+                                  ? std::dynamic_pointer_cast<OrderByOperator>(node)->order_bys_
+                                  : std::dynamic_pointer_cast<TopNOperator>(node)->order_bys_;
+      for (const auto &[order_by_type, expr] : order_bys) {
+        CollectColumnIndices(*expr, col_indices);
+      }
+    } else if (node->GetType() != OperatorType::LIMIT) {
+      break;
+    }
+    node = node->children_[0];
+  }
+  if (node->GetType() != OperatorType::INDEXSCAN) {
+    return plan;
+  }
+  auto index_scan = std::dynamic_pointer_cast<IndexScanOperator>(node);
+  // 索引嵌套循环连接的内表由连接直接回表
+  if (index_scan->parameterized_) {
+    return plan;
+  }
+  auto index = catalog_.GetIndex(index_scan->GetIndexOid());
+  const auto &key_columns = index->GetKeyColumns();
+  const auto &include_columns = index->GetIncludeColumns();
+  for (auto col_idx : col_indices) {
+    if (std::find(key_columns.begin(), key_columns.end(), col_idx) == key_columns.end() &&
+        std::find(include_columns.begin(), include_columns.end(), col_idx) == include_columns.end()) {
+      return plan;
+    }
+  }
+  index_scan->index_only_ = true;
+  return plan;
+}
+
+std::shared_ptr<Operator> Optimizer::FuseTopN(std::shared_ptr<Operator> plan) {
+  // 将 Limit 和其下方的 OrderBy 合并为 TopN
+  for (auto &child : plan->children_) {
+    child = FuseTopN(child);
+  }
+  if (plan->GetType() != OperatorType::LIMIT || plan->children_[0]->GetType() != OperatorType::ORDERBY) {
+    return plan;
+  }
+  auto limit = std::dynamic_pointer_cast<LimitOperator>(plan);
+  if (!limit->limit_count_.has_value()) {
+    return plan;
+  }
+  uint32_t limit_count = *limit->limit_count_;
+  uint32_t limit_offset = limit->limit_offset_.value_or(0);
+  if (static_cast<size_t>(limit_count) + limit_offset > TOP_N_MAX_ROWS) {
+    return plan;
+  }
+  auto orderby = std::dynamic_pointer_cast<OrderByOperator>(plan->children_[0]);
+  return std::make_shared<TopNOperator>(limit->column_list_, orderby->children_[0], orderby->order_bys_, limit_count,
+                                        limit_offset);
+}
+
+std::shared_ptr<Operator> Optimizer::RewriteDistinctAggregates(std::shared_ptr<Operator> plan) {
+  // 所有聚集函数都是同一参数上的 DISTINCT 聚集时，改写为两层分组：
+  // 下层按 (分组列, 参数) 分组去重，上层按分组列对去重后的参数做普通聚集
+  // 去重由哈希聚集完成，超出内存时可以溢出到临时文件，不需要为每个分组维护 DISTINCT 集合
+  for (auto &child : plan->children_) {
+    child = RewriteDistinctAggregates(child);
+  }
+  if (plan->GetType() != OperatorType::AGGREGATE) {
+    return plan;
+  }
+  auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(plan);
+  const auto &aggregates = aggregate->aggregates_;
+  if (aggregate->mode_ != AggregateMode::SIMPLE || aggregates.empty()) {
+    return plan;
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    if (!aggregate->is_distincts_[i] || aggregates[i]->ToString() != aggregates[0]->ToString()) {
+      return plan;
+    }
+  }
+
+  const auto &arg = aggregates[0];
+  const auto &group_bys = aggregate->group_bys_;
+  auto group_count = group_bys.size();
+  auto inner_column_list = std::make_shared<ColumnList>();
+  for (size_t i = 0; i < group_count; i++) {
+    inner_column_list->AddColumn(aggregate->OutputColumns().GetColumn(i));
+  }
+  inner_column_list->AddColumn(ColumnDefinition(arg->name_, arg->GetValueType(), arg->GetSize()));
+  auto inner_group_bys = group_bys;
+  inner_group_bys.push_back(arg);
+  auto inner = std::make_shared<AggregateOperator>(std::move(inner_column_list), aggregate->children_[0],
+                                                   std::move(inner_group_bys),
+                                                   std::vector<std::shared_ptr<OperatorExpression>>{},
+                                                   std::vector<bool>{}, std::vector<AggregateType>{});
+
+  std::vector<std::shared_ptr<OperatorExpression>> outer_group_bys;
+  for (size_t i = 0; i < group_count; i++) {
+    outer_group_bys.push_back(std::make_shared<ColumnValue>(i, group_bys[i]->GetValueType(), group_bys[i]->name_,
+                                                            group_bys[i]->GetSize()));
+  }
+  auto distinct_arg = std::make_shared<ColumnValue>(group_count, arg->GetValueType(), arg->name_, arg->GetSize());
+  std::vector<std::shared_ptr<OperatorExpression>> outer_aggregates(aggregates.size(), distinct_arg);
+  return std::make_shared<AggregateOperator>(aggregate->column_list_, std::move(inner), std::move(outer_group_bys),
+                                             std::move(outer_aggregates), std::vector<bool>(aggregates.size(), false),
+                                             aggregate->aggregate_types_);
+}
+
+std::shared_ptr<Operator> Optimizer::ChooseAggregateAlgorithm(std::shared_ptr<Operator> plan) {
+  // 输入已按分组列有序时使用流式聚集，不需要哈希表
+  for (auto &child : plan->children_) {
+    child = ChooseAggregateAlgorithm(child);
+  }
+  if (plan->GetType() == OperatorType::AGGREGATE) {
+    auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(plan);
+    if (GroupsMatchOrder(*aggregate, OutputOrder(*aggregate->children_[0]))) {
+      aggregate->algorithm_ = AggregateAlgorithm::SORT;
+    } else if (!aggregate->group_bys_.empty() && cost_model_.HasStatistics(*plan)) {
+      // 哈希表超出 work_mem 时，先排序再流式聚集可能代价更低
+      auto hash_cost = cost_model_.EstimateCost(*plan);
+      std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> order_bys;
+      for (const auto &group_by : aggregate->group_bys_) {
+        order_bys.emplace_back(OrderByType::ASC, group_by);
+      }
+      auto child = aggregate->children_[0];
+      auto column_list = std::make_shared<ColumnList>(child->OutputColumns());
+      aggregate->children_[0] = std::make_shared<OrderByOperator>(std::move(column_list), child, std::move(order_bys));
+      aggregate->algorithm_ = AggregateAlgorithm::SORT;
+      if (cost_model_.EstimateCost(*plan) >= hash_cost) {
+        aggregate->children_[0] = std::move(child);
+        aggregate->algorithm_ = AggregateAlgorithm::HASH;
+      }
+    }
+    return plan;
+  }
+  if (plan->GetType() != OperatorType::ORDERBY) {
+    return plan;
+  }
+  // ORDER BY 的前若干个排序键恰好为全部分组列时，将排序移到聚集之下，流式聚集的输出保持该顺序
+  // 分组列在每个分组内取值唯一，其余的排序键不影响结果
+  auto orderby = std::dynamic_pointer_cast<OrderByOperator>(plan);
+  auto node = plan->children_[0];
+  while (node->GetType() == OperatorType::FILTER) {
+    node = node->children_[0];
+  }
+  if (node->GetType() != OperatorType::AGGREGATE) {
+    return plan;
+  }
+  auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(node);
+  const auto &group_bys = aggregate->group_bys_;
+  if (aggregate->algorithm_ != AggregateAlgorithm::HASH || group_bys.empty() ||
+      orderby->order_bys_.size() < group_bys.size()) {
+    return plan;
+  }
+  std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> order_bys;
+  std::vector<bool> covered(group_bys.size(), false);
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    const auto &[order_by_type, expr] = orderby->order_bys_[i];
+    if (expr->GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+      return plan;
+    }
+    auto col_idx = std::dynamic_pointer_cast<ColumnValue>(expr)->GetColumnIndex();
+    if (col_idx >= group_bys.size() || covered[col_idx]) {
+      return plan;
+    }
+    covered[col_idx] = true;
+    order_bys.emplace_back(order_by_type, group_bys[col_idx]);
+  }
+  // 有统计信息时，排序全部输入的代价高于对聚集结果排序时保持原计划
+  bool use_cost = cost_model_.HasStatistics(*plan);
+  auto cost = use_cost ? cost_model_.EstimateCost(*plan) : 0;
+  auto child = aggregate->children_[0];
+  auto column_list = std::make_shared<ColumnList>(child->OutputColumns());
+  aggregate->children_[0] = std::make_shared<OrderByOperator>(std::move(column_list), child, std::move(order_bys));
+  aggregate->algorithm_ = AggregateAlgorithm::SORT;
+  if (use_cost && cost_model_.EstimateCost(*plan->children_[0]) > cost) {
+    aggregate->children_[0] = std::move(child);
+    aggregate->algorithm_ = AggregateAlgorithm::HASH;
+    return plan;
+  }
+  return plan->children_[0];
+}
+
+std::shared_ptr<Operator> Optimizer::ElideSorts(std::shared_ptr<Operator> plan) {
+  // 子节点的输出已按排序键有序时删除 OrderBy 节点，例如归并连接的输入来自另一个归并连接或已有的排序
+  // FuseTopN 先于本遍执行，有序输入之上的 TopN 改写为 Limit，不再缓冲和比较记录
+  for (auto &child : plan->children_) {
+    child = ElideSorts(child);
+  }
+  if (plan->GetType() == OperatorType::TOPN) {
+    auto topn = std::dynamic_pointer_cast<TopNOperator>(plan);
+    if (!SatisfiesOrder(*plan->children_[0], topn->order_bys_)) {
+      return plan;
+    }
+    return std::make_shared<LimitOperator>(topn->column_list_, topn->children_[0], topn->limit_count_,
+                                           topn->limit_offset_);
+  }
+  if (plan->GetType() != OperatorType::ORDERBY) {
+    return plan;
+  }
+  const auto &order_bys = std::dynamic_pointer_cast<OrderByOperator>(plan)->order_bys_;
+  return SatisfiesOrder(*plan->children_[0], order_bys) ? plan->children_[0] : plan;
+}
+
+std::shared_ptr<Operator> Optimizer::Parallelize(std::shared_ptr<Operator> plan) {
+  // 在只包含扫描、过滤、投影和连接探测的最大子树之上插入 Gather，由多个 worker 并行执行
+  // 子树之上的哈希聚集拆分为子树中的部分聚集和 Gather 之上的最终聚集
+  switch (plan->GetType()) {
+    case OperatorType::INSERT:
+    case OperatorType::UPDATE:
+    case OperatorType::DELETE:
+    case OperatorType::LOCK_ROWS:
+      // 修改数据和加锁的查询不并行执行
+      return plan;
+    case OperatorType::AGGREGATE: {
+      auto aggregate = std::dynamic_pointer_cast<AggregateOperator>(plan);
+      bool has_distinct = std::find(aggregate->is_distincts_.begin(), aggregate->is_distincts_.end(), true) !=
+                          aggregate->is_distincts_.end();
+      if (aggregate->mode_ == AggregateMode::SIMPLE && aggregate->algorithm_ == AggregateAlgorithm::HASH &&
+          !has_distinct && IsParallelSafe(*aggregate->children_[0])) {
+        return SplitAggregate(std::move(aggregate));
+      }
+      break;
+    }
+    default:
+      if (IsParallelSafe(*plan)) {
+        MarkParallelScan(*plan);
+        auto column_list = std::make_shared<ColumnList>(plan->OutputColumns());
+        return std::make_shared<GatherOperator>(std::move(column_list), std::move(plan), max_parallel_workers_);
+      }
+      break;
+  }
+  for (auto &child : plan->children_) {
+    child = Parallelize(child);
+  }
+  return plan;
+}
+
+std::shared_ptr<Operator> Optimizer::SplitAggregate(std::shared_ptr<AggregateOperator> aggregate) {
+  // 部分聚集输出分组列和各聚集函数的中间状态，列的布局与 AggregateAccumulator::Partial 一致
+  const auto &group_bys = aggregate->group_bys_;
+  const auto &aggregates = aggregate->aggregates_;
+  auto group_count = group_bys.size();
+  auto partial_column_list = std::make_shared<ColumnList>();
+  for (size_t i = 0; i < group_count; i++) {
+    partial_column_list->AddColumn(aggregate->OutputColumns().GetColumn(i));
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    const auto &name = aggregate->OutputColumns().GetColumn(group_count + i).name_;
+    switch (aggregate->aggregate_types_[i]) {
+      case AggregateType::AVG:
+        partial_column_list->AddColumn(ColumnDefinition(name, Type::DOUBLE));
+        partial_column_list->AddColumn(ColumnDefinition(name, Type::INT));
+        break;
+      case AggregateType::COUNT_STAR:
+      case AggregateType::COUNT:
+        partial_column_list->AddColumn(ColumnDefinition(name, Type::INT));
+        break;
+      case AggregateType::APPROX_COUNT_DISTINCT:
+        partial_column_list->AddColumn(
+            ColumnDefinition(name, Type::VARCHAR, size_t(1) << HyperLogLog::DEFAULT_PRECISION));
+        break;
+      default:
+        partial_column_list->AddColumn(ColumnDefinition(name, aggregates[i]->GetValueType(), aggregates[i]->GetSize()));
+        break;
+    }
+  }
+  MarkParallelScan(*aggregate->children_[0]);
+  auto partial = std::make_shared<AggregateOperator>(partial_column_list, aggregate->children_[0], group_bys,
+                                                     aggregates, aggregate->is_distincts_,
+                                                     aggregate->aggregate_types_, AggregateMode::PARTIAL);
+  auto gather = std::make_shared<GatherOperator>(std::make_shared<ColumnList>(*partial_column_list),
+                                                 std::move(partial), max_parallel_workers_);
+
+  std::vector<std::shared_ptr<OperatorExpression>> final_group_bys;
+  for (size_t i = 0; i < group_count; i++) {
+    final_group_bys.push_back(std::make_shared<ColumnValue>(i, group_bys[i]->GetValueType(), group_bys[i]->name_,
+                                                            group_bys[i]->GetSize()));
+  }
+  return std::make_shared<AggregateOperator>(aggregate->column_list_, std::move(gather), std::move(final_group_bys),
+                                             aggregates, aggregate->is_distincts_, aggregate->aggregate_types_,
+                                             AggregateMode::FINAL);
+}
+
 }  // namespace huadb
@@ -1,7 +1,13 @@
 #pragma once
 
 #include "catalog/catalog.h"
+#include "operators/expressions/expression.h"
+#include "operators/aggregate_operator.h"
+#include "operators/orderby_operator.h"
 #include "operators/operator.h"
+#include "optimizer/cost_model.h"
+#include "planner/planner.h"
+#include "storage/buffer_pool.h"
 
 namespace huadb {
 
@@ -10,10 +16,16 @@ static constexpr JoinOrderAlgorithm DEFAULT_JOIN_ORDER_ALGORITHM = JoinOrderAlgo
 
 class Optimizer {
  public:
-  Optimizer(Catalog &catalog, JoinOrderAlgorithm join_order_algorithm);
+  // force_join 不为 NONE 时保持规划器选择的连接算法，work_mem 为单个执行器可使用的内存（字节）
+  // max_parallel_workers 为每个 Gather 使用的工作线程数，为 0 时不生成并行计划
+  Optimizer(Catalog &catalog, BufferPool &buffer_pool, JoinOrderAlgorithm join_order_algorithm, ForceJoin force_join,
+            size_t work_mem, size_t max_parallel_workers = 0);
   std::shared_ptr<Operator> Optimize(std::shared_ptr<Operator> plan);
 
  private:
+  std::shared_ptr<Operator> SimplifyExpressions(std::shared_ptr<Operator> plan);
+  void SimplifyExpressionList(std::vector<std::shared_ptr<OperatorExpression>> &exprs);
+
   std::shared_ptr<Operator> SplitPredicates(std::shared_ptr<Operator> plan);
   std::shared_ptr<Operator> PushDown(std::shared_ptr<Operator> plan);
   std::shared_ptr<Operator> PushDownFilter(std::shared_ptr<Operator> plan);
@@ -23,8 +35,33 @@ class Optimizer {
 
   std::shared_ptr<Operator> ReorderJoin(std::shared_ptr<Operator> plan);
 
-  JoinOrderAlgorithm join_order_algorithm_;
+  // order_by 为直接位于 plan 上方的排序，用于在代价相同的索引中优先选择可以消除排序的索引
+  std::shared_ptr<Operator> ChooseIndexScans(std::shared_ptr<Operator> plan, const OrderByOperator *order_by = nullptr);
+  std::shared_ptr<Operator> ChooseJoinAlgorithms(std::shared_ptr<Operator> plan);
+  // inner 为顺序扫描或其上的过滤，且内表的连接键覆盖某个索引的键列前缀时，返回按该索引查找内表的索引嵌套循环连接，
+  // 否则返回空
+  std::shared_ptr<Operator> MakeIndexNestedLoopJoin(std::shared_ptr<ColumnList> column_list,
+                                                    std::shared_ptr<Operator> outer, std::shared_ptr<Operator> inner,
+                                                    std::vector<std::shared_ptr<OperatorExpression>> outer_keys,
+                                                    std::vector<std::shared_ptr<OperatorExpression>> inner_keys,
+                                                    JoinType join_type);
+  std::shared_ptr<Operator> ChooseIndexOnlyScans(std::shared_ptr<Operator> plan);
+  std::shared_ptr<Operator> ChooseZonePredicates(std::shared_ptr<Operator> plan);
+
+  std::shared_ptr<Operator> FuseTopN(std::shared_ptr<Operator> plan);
+
+  std::shared_ptr<Operator> RewriteDistinctAggregates(std::shared_ptr<Operator> plan);
+  std::shared_ptr<Operator> ChooseAggregateAlgorithm(std::shared_ptr<Operator> plan);
+  std::shared_ptr<Operator> ElideSorts(std::shared_ptr<Operator> plan);
+
+  std::shared_ptr<Operator> Parallelize(std::shared_ptr<Operator> plan);
+  std::shared_ptr<Operator> SplitAggregate(std::shared_ptr<AggregateOperator> aggregate);
+
   Catalog &catalog_;
+  CostModel cost_model_;
+  JoinOrderAlgorithm join_order_algorithm_;
+  ForceJoin force_join_;
+  size_t max_parallel_workers_;
 };
 
 }  // namespace huadb
@@ -1,5 +1,6 @@
 #include "planner/planner.h"
 
+#include <algorithm>
 #include <optional>
 #include <string>
 
@@ -17,6 +18,70 @@
 
 namespace huadb {
 
+// 将 AND 连接的谓词拆分为合取项
+static void SplitConjuncts(const Expression &expr, std::vector<const Expression *> &conjuncts) {
+  if (expr.type_ == ExpressionType::BINARY_OP) {
+    const auto &binary_op = dynamic_cast<const BinaryOpExpression &>(expr);
+    if (binary_op.op_name_ == "and") {
+      SplitConjuncts(*binary_op.left_, conjuncts);
+      SplitConjuncts(*binary_op.right_, conjuncts);
+      return;
+    }
+  }
+  conjuncts.push_back(&expr);
+}
+
+// 收集表达式引用的全部列名
+static void CollectColumnRefs(const Expression &expr, std::vector<std::string> &names) {
+  switch (expr.type_) {
+    case ExpressionType::COLUMN_REF:
+      names.push_back(expr.ToString());
+      break;
+    case ExpressionType::ALIAS:
+      CollectColumnRefs(*dynamic_cast<const AliasExpression &>(expr).expr_, names);
+      break;
+    case ExpressionType::BINARY_OP: {
+      const auto &binary_op = dynamic_cast<const BinaryOpExpression &>(expr);
+      CollectColumnRefs(*binary_op.left_, names);
+      CollectColumnRefs(*binary_op.right_, names);
+      break;
+    }
+    case ExpressionType::UNARY_OP:
+      CollectColumnRefs(*dynamic_cast<const UnaryOpExpression &>(expr).arg_, names);
+      break;
+    case ExpressionType::TYPE_CAST:
+      CollectColumnRefs(*dynamic_cast<const TypeCastExpression &>(expr).arg_, names);
+      break;
+    case ExpressionType::NULL_TEST:
+      CollectColumnRefs(*dynamic_cast<const NullTestExpression &>(expr).arg_, names);
+      break;
+    case ExpressionType::FUNC_CALL:
+      for (const auto &arg : dynamic_cast<const FuncCallExpression &>(expr).args_) {
+        CollectColumnRefs(*arg, names);
+      }
+      break;
+    case ExpressionType::AGGREGATE:
+      for (const auto &arg : dynamic_cast<const AggregateExpression &>(expr).args_) {
+        CollectColumnRefs(*arg, names);
+      }
+      break;
+    case ExpressionType::LIST:
+      for (const auto &item : dynamic_cast<const ListExpression &>(expr).exprs_) {
+        CollectColumnRefs(*item, names);
+      }
+      break;
+    case ExpressionType::SUBQUERY: {
+      const auto &subquery = dynamic_cast<const SubqueryExpression &>(expr);
+      if (subquery.left_ != nullptr) {
+        CollectColumnRefs(*subquery.left_, names);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 Planner::Planner(ForceJoin force_join) : force_join_(force_join) {}
 
 std::shared_ptr<Operator> Planner::PlanQuery(const Statement &stmt) {
@@ -124,9 +189,9 @@ std::shared_ptr<Operator> Planner::PlanSelect(const SelectStatement &stmt) {
   }
 
   if (stmt.where_ != nullptr) {
-    auto column_list = std::make_shared<ColumnList>(plan->OutputColumns());
-    auto expr = PlanExpression(*stmt.where_, {plan});
-    plan = std::make_shared<FilterOperator>(std::move(column_list), std::move(plan), std::move(expr));
+    std::vector<const Expression *> conjuncts;
+    SplitConjuncts(*stmt.where_, conjuncts);
+    plan = PlanFilter(conjuncts, std::move(plan));
   }
 
   bool has_agg = false;
@@ -277,6 +342,8 @@ std::shared_ptr<OperatorExpression> Planner::PlanExpression(const Expression &ex
       }
       return std::make_shared<FuncCall>(func_call_expr.function_name_, std::move(args));
     }
+    case ExpressionType::SUBQUERY:
+      throw DbException("Subquery is only supported as a conjunct of WHERE clause");
     default:
       throw DbException("Unsupported expression type in PlanExpression");
   }
@@ -369,6 +436,8 @@ std::tuple<AggregateType, bool, std::shared_ptr<OperatorExpression>> Planner::Ge
     return {AggregateType::MAX, expr.is_distinct_, std::move(arg_expr)};
   } else if (expr.function_name_ == "min") {
     return {AggregateType::MIN, expr.is_distinct_, std::move(arg_expr)};
+  } else if (expr.function_name_ == "approx_count_distinct") {
+    return {AggregateType::APPROX_COUNT_DISTINCT, false, std::move(arg_expr)};
   } else {
     throw DbException("Unknown function name " + expr.function_name_);
   }
@@ -433,6 +502,152 @@ std::shared_ptr<Operator> Planner::PlanAggregate(const SelectStatement &stmt, st
   return plan;
 }
 
+std::shared_ptr<Operator> Planner::PlanFilter(const std::vector<const Expression *> &conjuncts,
+                                              std::shared_ptr<Operator> plan) {
+  std::vector<std::pair<const SubqueryExpression *, bool>> subqueries;
+  std::shared_ptr<OperatorExpression> filter_expr;
+  for (const auto *conjunct : conjuncts) {
+    // NOT IN 和 NOT EXISTS 改写为反连接
+    const auto *expr = conjunct;
+    bool negated = false;
+    if (expr->type_ == ExpressionType::UNARY_OP) {
+      const auto &unary_op = dynamic_cast<const UnaryOpExpression &>(*expr);
+      if (unary_op.op_name_ == "not" && unary_op.arg_->type_ == ExpressionType::SUBQUERY) {
+        expr = unary_op.arg_.get();
+        negated = true;
+      }
+    }
+    if (expr->type_ == ExpressionType::SUBQUERY) {
+      subqueries.emplace_back(dynamic_cast<const SubqueryExpression *>(expr), negated);
+      continue;
+    }
+    auto planned_expr = PlanExpression(*conjunct, {plan});
+    filter_expr =
+        filter_expr == nullptr ? std::move(planned_expr) : BinaryFactory("and", filter_expr, std::move(planned_expr));
+  }
+  // 先执行普通谓词，减少半连接和反连接的输入
+  if (filter_expr != nullptr) {
+    auto column_list = std::make_shared<ColumnList>(plan->OutputColumns());
+    plan = std::make_shared<FilterOperator>(std::move(column_list), std::move(plan), std::move(filter_expr));
+  }
+  for (const auto &[subquery, negated] : subqueries) {
+    plan = PlanSubquery(*subquery, negated, std::move(plan));
+  }
+  return plan;
+}
+
+std::shared_ptr<Operator> Planner::PlanSubquery(const SubqueryExpression &expr, bool negated,
+                                                std::shared_ptr<Operator> left) {
+  const auto &subquery = *expr.subquery_;
+  bool is_in = expr.subquery_type_ == SubqueryType::IN;
+  std::shared_ptr<Operator> right;
+  if (subquery.table_->type_ != TableRefType::EMPTY) {
+    right = PlanTableRef(*subquery.table_);
+  }
+  // 引用了子查询 FROM 子句以外的列的表达式与外层查询关联
+  auto is_correlated = [&right](const Expression &item) {
+    std::vector<std::string> names;
+    CollectColumnRefs(item, names);
+    return std::any_of(names.begin(), names.end(), [&right](const std::string &name) {
+      return right == nullptr || !right->OutputColumns().TryGetColumnIndex(name);
+    });
+  };
+  std::vector<const Expression *> conjuncts;
+  if (subquery.where_ != nullptr) {
+    SplitConjuncts(*subquery.where_, conjuncts);
+  }
+  std::vector<const Expression *> inner_conjuncts;
+  std::vector<const Expression *> correlated_conjuncts;
+  for (const auto *conjunct : conjuncts) {
+    (is_correlated(*conjunct) ? correlated_conjuncts : inner_conjuncts).push_back(conjunct);
+  }
+  const Expression *item = nullptr;
+  if (is_in) {
+    item = subquery.select_list_[0].get();
+    if (item->type_ == ExpressionType::ALIAS) {
+      item = dynamic_cast<const AliasExpression &>(*item).expr_.get();
+    }
+  }
+
+  std::shared_ptr<OperatorExpression> condition;
+  std::shared_ptr<OperatorExpression> left_key;
+  std::shared_ptr<OperatorExpression> right_key;
+  if (correlated_conjuncts.empty() && (item == nullptr || !is_correlated(*item))) {
+    // 非关联子查询与外层查询无关，作为独立的查询规划，可以包含聚集、排序等
+    right = Planner(force_join_).PlanSelect(subquery);
+    if (is_in) {
+      left_key = PlanExpression(*expr.left_, {left});
+      const auto &column = right->OutputColumns().GetColumn(0);
+      right_key = std::make_shared<ColumnValue>(0, column.type_, column.name_, column.GetMaxSize(), false);
+    }
+  } else {
+    // 关联子查询去关联：关联谓词作为连接条件，其余谓词留在子查询一侧
+    if (right == nullptr || !subquery.group_by_.empty() || subquery.having_ != nullptr ||
+        subquery.limit_count_ != nullptr || subquery.limit_offset_ != nullptr ||
+        std::any_of(subquery.select_list_.begin(), subquery.select_list_.end(),
+                    [](const auto &select_item) { return select_item->HasAggregation(); })) {
+      throw DbException("Correlated subquery with aggregation or limit is not supported");
+    }
+    right = PlanFilter(inner_conjuncts, std::move(right));
+    for (const auto *conjunct : correlated_conjuncts) {
+      auto planned_expr = PlanExpression(*conjunct, {left, right});
+      condition = condition == nullptr ? std::move(planned_expr) : BinaryFactory("and", condition, planned_expr);
+    }
+    if (is_in) {
+      left_key = PlanExpression(*expr.left_, {left, right});
+      right_key = PlanExpression(*item, {left, right});
+    }
+  }
+
+  auto column_list = std::make_shared<ColumnList>(left->OutputColumns());
+  auto join_type = negated ? JoinType::ANTI : JoinType::SEMI;
+  std::vector<std::shared_ptr<OperatorExpression>> left_keys, right_keys;
+  if (is_in) {
+    auto equal = BinaryFactory("=", left_key, right_key);
+    if (negated) {
+      // NOT IN：子查询结果含有 NULL，或左侧为 NULL 且子查询结果非空时，比较结果为 NULL，记录不输出
+      // 非关联的单列等值比较由哈希反连接专门处理 NULL，其余情况将 NULL 视为匹配，由嵌套循环反连接执行
+      if (condition == nullptr && ExtractEquiJoinKeys(equal, left_keys, right_keys)) {
+        auto hash_join = std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                                            std::move(left_keys), std::move(right_keys), join_type);
+        hash_join->null_aware_ = true;
+        return hash_join;
+      }
+      equal = BinaryFactory("or", BinaryFactory("or", equal, std::make_shared<NullTest>(true, left_key)),
+                            std::make_shared<NullTest>(true, right_key));
+      condition = condition == nullptr ? std::move(equal) : BinaryFactory("and", condition, std::move(equal));
+      return std::make_shared<NestedLoopJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                                      std::move(condition), join_type);
+    }
+    condition = condition == nullptr ? std::move(equal) : BinaryFactory("and", condition, std::move(equal));
+  }
+  if (condition == nullptr) {
+    // 非关联的 EXISTS 只需判断子查询结果是否为空
+    condition = std::make_shared<Const>(Value(true));
+  }
+  if (force_join_ != ForceJoin::NESTLOOP && ExtractEquiJoinKeys(condition, left_keys, right_keys)) {
+    if (force_join_ == ForceJoin::MERGE) {
+      std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> left_order_bys, right_order_bys;
+      for (size_t i = 0; i < left_keys.size(); i++) {
+        left_order_bys.emplace_back(OrderByType::ASC, left_keys[i]);
+        right_order_bys.emplace_back(OrderByType::ASC, right_keys[i]);
+      }
+      auto left_column_list = std::make_shared<ColumnList>(left->OutputColumns());
+      auto right_column_list = std::make_shared<ColumnList>(right->OutputColumns());
+      auto left_order =
+          std::make_shared<OrderByOperator>(std::move(left_column_list), std::move(left), std::move(left_order_bys));
+      auto right_order =
+          std::make_shared<OrderByOperator>(std::move(right_column_list), std::move(right), std::move(right_order_bys));
+      return std::make_shared<MergeJoinOperator>(std::move(column_list), std::move(left_order), std::move(right_order),
+                                                 std::move(left_keys), std::move(right_keys), join_type);
+    }
+    return std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                              std::move(left_keys), std::move(right_keys), join_type);
+  }
+  return std::make_shared<NestedLoopJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                                  std::move(condition), join_type);
+}
+
 std::shared_ptr<Operator> Planner::PlanTableRef(const TableRef &ref, bool has_lock) {
   switch (ref.type_) {
     case TableRefType::BASE_TABLE: {
@@ -499,41 +714,29 @@ std::shared_ptr<Operator> Planner::PlanJoin(const JoinRef &ref) {
   const auto join_condition = PlanExpression(*ref.condition_, {left, right});
 
   if (force_join_ == ForceJoin::MERGE) {
-    if (join_condition->GetExprType() == OperatorExpressionType::COMPARISON) {
-      const auto expr = std::dynamic_pointer_cast<Comparison>(join_condition);
-      if (expr->GetComparisonType() == ComparisonType::EQUAL &&
-          expr->children_[0]->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
-          expr->children_[1]->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
-        auto left_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[0]);
-        auto right_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[1]);
-        auto column_list = GetJoinColumnList(*left, *right);
-        auto left_column_list = std::make_shared<ColumnList>(left->OutputColumns());
-        auto right_column_list = std::make_shared<ColumnList>(right->OutputColumns());
-        auto left_order =
-            std::make_shared<OrderByOperator>(std::move(left_column_list), std::move(left),
-                                              std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>>{
-                                                  std::make_pair(OrderByType::ASC, left_key)});
-        auto right_order =
-            std::make_shared<OrderByOperator>(std::move(right_column_list), std::move(right),
-                                              std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>>{
-                                                  std::make_pair(OrderByType::ASC, right_key)});
-        return std::make_shared<MergeJoinOperator>(std::move(column_list), std::move(left_order),
-                                                   std::move(right_order), std::move(left_key), std::move(right_key),
-                                                   ref.join_type_);
+    std::vector<std::shared_ptr<OperatorExpression>> left_keys, right_keys;
+    if (ExtractEquiJoinKeys(join_condition, left_keys, right_keys)) {
+      std::vector<std::pair<OrderByType, std::shared_ptr<OperatorExpression>>> left_order_bys, right_order_bys;
+      for (size_t i = 0; i < left_keys.size(); i++) {
+        left_order_bys.emplace_back(OrderByType::ASC, left_keys[i]);
+        right_order_bys.emplace_back(OrderByType::ASC, right_keys[i]);
       }
+      auto column_list = GetJoinColumnList(*left, *right);
+      auto left_column_list = std::make_shared<ColumnList>(left->OutputColumns());
+      auto right_column_list = std::make_shared<ColumnList>(right->OutputColumns());
+      auto left_order =
+          std::make_shared<OrderByOperator>(std::move(left_column_list), std::move(left), std::move(left_order_bys));
+      auto right_order =
+          std::make_shared<OrderByOperator>(std::move(right_column_list), std::move(right), std::move(right_order_bys));
+      return std::make_shared<MergeJoinOperator>(std::move(column_list), std::move(left_order), std::move(right_order),
+                                                 std::move(left_keys), std::move(right_keys), ref.join_type_);
     }
   } else if (force_join_ == ForceJoin::HASH) {
-    if (join_condition->GetExprType() == OperatorExpressionType::COMPARISON) {
-      const auto expr = std::dynamic_pointer_cast<Comparison>(join_condition);
-      if (expr->GetComparisonType() == ComparisonType::EQUAL &&
-          expr->children_[0]->GetExprType() == OperatorExpressionType::COLUMN_VALUE &&
-          expr->children_[1]->GetExprType() == OperatorExpressionType::COLUMN_VALUE) {
-        auto left_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[0]);
-        auto right_key = std::dynamic_pointer_cast<ColumnValue>(expr->children_[1]);
-        auto column_list = GetJoinColumnList(*left, *right);
-        return std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
-                                                  std::move(left_key), std::move(right_key), ref.join_type_);
-      }
+    std::vector<std::shared_ptr<OperatorExpression>> left_keys, right_keys;
+    if (ExtractEquiJoinKeys(join_condition, left_keys, right_keys)) {
+      auto column_list = GetJoinColumnList(*left, *right);
+      return std::make_shared<HashJoinOperator>(std::move(column_list), std::move(left), std::move(right),
+                                                std::move(left_keys), std::move(right_keys), ref.join_type_);
     }
   }
   auto column_list = GetJoinColumnList(*left, *right);
@@ -541,6 +744,38 @@ std::shared_ptr<Operator> Planner::PlanJoin(const JoinRef &ref) {
                                                   std::move(join_condition), ref.join_type_);
 }
 
+bool Planner::ExtractEquiJoinKeys(const std::shared_ptr<OperatorExpression> &condition,
+                                  std::vector<std::shared_ptr<OperatorExpression>> &left_keys,
+                                  std::vector<std::shared_ptr<OperatorExpression>> &right_keys) {
+  // 连接条件须为若干个 左表列 = 右表列 的合取
+  if (condition->GetExprType() == OperatorExpressionType::LOGIC) {
+    const auto logic = std::dynamic_pointer_cast<Logic>(condition);
+    return logic->GetLogicType() == LogicType::AND &&
+           ExtractEquiJoinKeys(logic->children_[0], left_keys, right_keys) &&
+           ExtractEquiJoinKeys(logic->children_[1], left_keys, right_keys);
+  }
+  if (condition->GetExprType() != OperatorExpressionType::COMPARISON) {
+    return false;
+  }
+  const auto expr = std::dynamic_pointer_cast<Comparison>(condition);
+  if (expr->GetComparisonType() != ComparisonType::EQUAL ||
+      expr->children_[0]->GetExprType() != OperatorExpressionType::COLUMN_VALUE ||
+      expr->children_[1]->GetExprType() != OperatorExpressionType::COLUMN_VALUE) {
+    return false;
+  }
+  auto first = std::dynamic_pointer_cast<ColumnValue>(expr->children_[0]);
+  auto second = std::dynamic_pointer_cast<ColumnValue>(expr->children_[1]);
+  if (first->IsLeft() == second->IsLeft()) {
+    return false;
+  }
+  if (!first->IsLeft()) {
+    std::swap(first, second);
+  }
+  left_keys.push_back(std::move(first));
+  right_keys.push_back(std::move(second));
+  return true;
+}
+
 std::shared_ptr<OperatorExpression> Planner::BinaryFactory(const std::string &op_name,
                                                            std::shared_ptr<OperatorExpression> left,
                                                            std::shared_ptr<OperatorExpression> right) {
@@ -25,6 +25,7 @@ class BinaryOpExpression;
 class UnaryOpExpression;
 class ColumnRefExpression;
 class AggregateExpression;
+class SubqueryExpression;
 
 class TableRef;
 class BaseTableRef;
@@ -35,7 +36,7 @@ class JoinRef;
 class ColumnValue;
 enum class AggregateType;
 
-enum class ForceJoin { NONE, MERGE, HASH };
+enum class ForceJoin { NONE, NESTLOOP, MERGE, HASH };
 
 class Planner {
  public:
@@ -62,11 +63,19 @@ class Planner {
       const AggregateExpression &expr, const std::vector<std::shared_ptr<Operator>> &children);
 
   std::shared_ptr<Operator> PlanAggregate(const SelectStatement &stmt, std::shared_ptr<Operator> child);
+  // WHERE 子句的各个合取项，IN/EXISTS 子查询改写为半连接或反连接，其余合取项合并为一个过滤条件
+  std::shared_ptr<Operator> PlanFilter(const std::vector<const Expression *> &conjuncts,
+                                       std::shared_ptr<Operator> plan);
+  std::shared_ptr<Operator> PlanSubquery(const SubqueryExpression &expr, bool negated, std::shared_ptr<Operator> left);
   std::shared_ptr<Operator> PlanTableRef(const TableRef &ref, bool has_lock = false);
   std::shared_ptr<Operator> PlanBaseTable(const BaseTableRef &ref, bool has_lock);
   std::shared_ptr<Operator> PlanExpressionList(const ExpressionListRef &ref);
   std::shared_ptr<Operator> PlanCrossJoin(const CrossJoinRef &ref);
   std::shared_ptr<Operator> PlanJoin(const JoinRef &ref);
+  // 从连接条件中提取等值连接键，条件不全为列之间的等值比较时返回 false
+  static bool ExtractEquiJoinKeys(const std::shared_ptr<OperatorExpression> &condition,
+                                  std::vector<std::shared_ptr<OperatorExpression>> &left_keys,
+                                  std::vector<std::shared_ptr<OperatorExpression>> &right_keys);
 
   std::shared_ptr<OperatorExpression> BinaryFactory(const std::string &op_name,
                                                     std::shared_ptr<OperatorExpression> left,
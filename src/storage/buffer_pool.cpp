@@ -1,5 +1,7 @@
 #include "storage/buffer_pool.h"
 
+#include <algorithm>
+
 #include "common/constants.h"
 #include "common/exceptions.h"
 #include "log/log_manager.h"
@@ -14,6 +16,7 @@ BufferPool::BufferPool(Disk &disk, LogManager &log_manager) : disk_(disk), log_m
 }
 
 std::shared_ptr<Page> BufferPool::GetPage(oid_t db_oid, oid_t table_oid, pageid_t page_id) {
+  std::lock_guard lock(mutex_);
   auto &buffers = (db_oid == SYSTEM_DATABASE_OID) ? systable_buffers_ : buffers_;
   auto &hashmap = (db_oid == SYSTEM_DATABASE_OID) ? systable_hashmap_ : hashmap_;
   auto entry = hashmap.find({table_oid, page_id});
@@ -28,12 +31,14 @@ std::shared_ptr<Page> BufferPool::GetPage(oid_t db_oid, oid_t table_oid, pageid_
 }
 
 std::shared_ptr<Page> BufferPool::NewPage(oid_t db_oid, oid_t table_oid, pageid_t page_id) {
+  std::lock_guard lock(mutex_);
   auto page = std::make_shared<Page>();
   AddToBuffer(db_oid, table_oid, page_id, page);
   return page;
 }
 
 void BufferPool::Flush(bool regular_only) {
+  std::lock_guard lock(mutex_);
   for (size_t i = 0; i < buffers_.size(); i++) {
     FlushPage(i);
   }
@@ -47,16 +52,41 @@ void BufferPool::Flush(bool regular_only) {
 }
 
 void BufferPool::Clear() {
+  std::lock_guard lock(mutex_);
   buffers_.clear();
   hashmap_.clear();
   systable_buffers_.clear();
   systable_hashmap_.clear();
+  resident_counts_.clear();
+  systable_resident_counts_.clear();
+  buffered_page_counts_.clear();
+  systable_buffered_page_counts_.clear();
+}
+
+size_t BufferPool::GetResidentPageCount(oid_t db_oid, oid_t table_oid) {
+  std::lock_guard lock(mutex_);
+  const auto &resident_counts = (db_oid == SYSTEM_DATABASE_OID) ? systable_resident_counts_ : resident_counts_;
+  auto entry = resident_counts.find(table_oid);
+  return entry == resident_counts.end() ? 0 : entry->second;
+}
+
+pageid_t BufferPool::GetPageCount(oid_t db_oid, oid_t table_oid) {
+  std::lock_guard lock(mutex_);
+  auto page_count = disk_.GetPageCount(Disk::GetFilePath(db_oid, table_oid));
+  const auto &buffered_page_counts =
+      (db_oid == SYSTEM_DATABASE_OID) ? systable_buffered_page_counts_ : buffered_page_counts_;
+  auto entry = buffered_page_counts.find(table_oid);
+  return entry == buffered_page_counts.end() ? page_count : std::max(page_count, entry->second);
 }
 
 void BufferPool::AddToBuffer(oid_t db_oid, oid_t table_oid, pageid_t page_id, std::shared_ptr<Page> page) {
+  auto &buffered_page_count =
+      (db_oid == SYSTEM_DATABASE_OID ? systable_buffered_page_counts_ : buffered_page_counts_)[table_oid];
+  buffered_page_count = std::max(buffered_page_count, page_id + 1);
   if (db_oid == SYSTEM_DATABASE_OID) {
     systable_hashmap_[{table_oid, page_id}] = systable_buffers_.size();
     systable_buffers_.push_back({db_oid, table_oid, page_id, page});
+    systable_resident_counts_[table_oid]++;
   } else {
     if (buffers_.size() == BUFFER_SIZE) {
       size_t victim = buffer_strategy_->Evict();
@@ -69,6 +99,7 @@ void BufferPool::AddToBuffer(oid_t db_oid, oid_t table_oid, pageid_t page_id, st
       hashmap_[{table_oid, page_id}] = buffers_.size();
       buffers_.push_back({db_oid, table_oid, page_id, page});
     }
+    resident_counts_[table_oid]++;
   }
 }
 
@@ -82,6 +113,9 @@ void BufferPool::FlushPage(size_t frame_id) {
                     buffer_entry.page_->GetData());
   }
   hashmap_.erase({buffer_entry.table_oid_, buffer_entry.page_id_});
+  if (--resident_counts_[buffer_entry.table_oid_] == 0) {
+    resident_counts_.erase(buffer_entry.table_oid_);
+  }
 }
 
 void BufferPool::FlushSysTablePage(size_t frame_id) {
@@ -92,6 +126,9 @@ void BufferPool::FlushSysTablePage(size_t frame_id) {
                     buffer_entry.page_->GetData());
   }
   systable_hashmap_.erase({buffer_entry.table_oid_, buffer_entry.page_id_});
+  if (--systable_resident_counts_[buffer_entry.table_oid_] == 0) {
+    systable_resident_counts_.erase(buffer_entry.table_oid_);
+  }
 }
 
 }  // namespace huadb
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -30,6 +31,10 @@ class BufferPool {
   void Flush(bool regular_only = false);
   // 清空 buffer pool，不刷脏，用于数据库故障模拟
   void Clear();
+  // 表在 buffer pool 中的页面数，供优化器估计 I/O 代价
+  size_t GetResidentPageCount(oid_t db_oid, oid_t table_oid);
+  // 表的页面数。页面号连续分配，取磁盘文件的页面数与加入过 buffer pool 的最大页面号的较大者，不需要遍历页面链表
+  pageid_t GetPageCount(oid_t db_oid, oid_t table_oid);
 
  private:
   // 将页面加入 buffer pool
@@ -41,6 +46,8 @@ class BufferPool {
 
   Disk &disk_;
   LogManager &log_manager_;
+  // 并行扫描时多个线程同时访问 buffer pool，保护缓存的映射和替换策略
+  std::mutex mutex_;
   std::unique_ptr<BufferStrategy> buffer_strategy_;  // 缓存替换策略
 
   // 普通表缓存
@@ -51,6 +58,12 @@ class BufferPool {
   std::vector<BufferPoolEntry> systable_buffers_;
   // 系统表专用映射
   std::unordered_map<TablePageid, size_t> systable_hashmap_;
+  // 各个表在 buffer 和 systable_buffer 中的页面数，页面加入时增加，刷出 buffer pool 时减少
+  std::unordered_map<oid_t, size_t> resident_counts_;
+  std::unordered_map<oid_t, size_t> systable_resident_counts_;
+  // 各个表加入过 buffer pool 的最大页面号加一，刷出时不减少，刷出的页面已写入磁盘文件
+  std::unordered_map<oid_t, pageid_t> buffered_page_counts_;
+  std::unordered_map<oid_t, pageid_t> systable_buffered_page_counts_;
 };
 
 }  // namespace huadb
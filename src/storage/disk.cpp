@@ -1,5 +1,6 @@
 #include "storage/disk.h"
 
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 
@@ -72,6 +73,12 @@ void Disk::ReadPage(const std::string &path, pageid_t page_id, char *data) {
   auto &fs = hashmap_[path];
   fs.seekg(page_id * DB_PAGE_SIZE);
   fs.read(data, DB_PAGE_SIZE);
+  // 已分配但尚未刷盘的页面可能超出文件末尾，读到的部分之后补零
+  // 需要清除流的错误状态，否则之后对该文件的读写都会失败
+  if (fs.gcount() < static_cast<std::streamsize>(DB_PAGE_SIZE)) {
+    memset(data + fs.gcount(), 0, DB_PAGE_SIZE - fs.gcount());
+    fs.clear();
+  }
 }
 
 void Disk::WritePage(const std::string &path, pageid_t page_id, const char *data) {
@@ -90,6 +97,13 @@ void Disk::WritePage(const std::string &path, pageid_t page_id, const char *data
   fs.flush();
 }
 
+pageid_t Disk::GetPageCount(const std::string &path) {
+  if (!FileExists(path)) {
+    return 0;
+  }
+  return std::filesystem::file_size(path) / DB_PAGE_SIZE;
+}
+
 void Disk::ReadLog(uint32_t offset, uint32_t count, char *data) {
   log_fs_.seekg(offset);
   log_fs_.read(data, count);
@@ -26,6 +26,8 @@ class Disk {
 
   void ReadPage(const std::string &path, pageid_t page_id, char *data);
   void WritePage(const std::string &path, pageid_t page_id, const char *data);
+  // 文件中的页面数，文件不存在时返回 0
+  pageid_t GetPageCount(const std::string &path);
 
   void ReadLog(uint32_t offset, uint32_t count, char *data);
   void WriteLog(uint32_t offset, uint32_t count, const char *data);
@@ -0,0 +1,159 @@
+#include "storage/spill_file.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+
+namespace huadb {
+
+static std::atomic<uint64_t> next_spill_file_id(0);
+
+SpillFile::SpillFile() {
+  auto directory = std::to_string(TEMP_DATABASE_OID);
+  std::filesystem::create_directories(directory);
+  path_ = directory + "/spill_" + std::to_string(next_spill_file_id++);
+  fs_.open(path_, std::fstream::in | std::fstream::out | std::fstream::trunc | std::fstream::binary);
+  if (!fs_) {
+    throw DbException("Cannot create spill file " + path_);
+  }
+}
+
+SpillFile::~SpillFile() {
+  fs_.close();
+  std::error_code ec;
+  std::filesystem::remove(path_, ec);
+}
+
+void SpillFile::Append(const std::vector<Value> &values) {
+  // 每行先写列数，每列写类型和是否为空，非空时再写值
+  auto count = static_cast<uint32_t>(values.size());
+  fs_.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  for (const auto &value : values) {
+    auto type = static_cast<uint8_t>(value.GetType());
+    uint8_t is_null = value.IsNull();
+    fs_.write(reinterpret_cast<const char *>(&type), sizeof(type));
+    fs_.write(reinterpret_cast<const char *>(&is_null), sizeof(is_null));
+    if (is_null) {
+      continue;
+    }
+    switch (value.GetType()) {
+      case Type::BOOL: {
+        auto val = value.GetValue<bool>();
+        fs_.write(reinterpret_cast<const char *>(&val), sizeof(val));
+        break;
+      }
+      case Type::INT: {
+        auto val = value.GetValue<int32_t>();
+        fs_.write(reinterpret_cast<const char *>(&val), sizeof(val));
+        break;
+      }
+      case Type::UINT: {
+        auto val = value.GetValue<uint32_t>();
+        fs_.write(reinterpret_cast<const char *>(&val), sizeof(val));
+        break;
+      }
+      case Type::DOUBLE: {
+        auto val = value.GetValue<double>();
+        fs_.write(reinterpret_cast<const char *>(&val), sizeof(val));
+        break;
+      }
+      case Type::CHAR:
+      case Type::VARCHAR: {
+        auto val = value.GetValue<std::string>();
+        auto length = static_cast<uint32_t>(val.size());
+        fs_.write(reinterpret_cast<const char *>(&length), sizeof(length));
+        fs_.write(val.data(), length);
+        break;
+      }
+      default:
+        throw DbException("Type unsupported for spill file");
+    }
+  }
+  if (!fs_) {
+    throw DbException("Failed to write spill file " + path_);
+  }
+  size_++;
+}
+
+void SpillFile::Rewind() {
+  fs_.flush();
+  fs_.clear();
+  fs_.seekg(0);
+}
+
+bool SpillFile::Read(std::vector<Value> &values) {
+  uint32_t count;
+  if (!fs_.read(reinterpret_cast<char *>(&count), sizeof(count))) {
+    return false;
+  }
+  values.clear();
+  values.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint8_t type, is_null;
+    fs_.read(reinterpret_cast<char *>(&type), sizeof(type));
+    fs_.read(reinterpret_cast<char *>(&is_null), sizeof(is_null));
+    if (is_null) {
+      auto value_type = static_cast<Type>(type);
+      values.push_back(value_type == Type::NULL_TYPE ? Value() : Value(value_type, 0));
+      continue;
+    }
+    switch (static_cast<Type>(type)) {
+      case Type::BOOL: {
+        bool val;
+        fs_.read(reinterpret_cast<char *>(&val), sizeof(val));
+        values.emplace_back(val);
+        break;
+      }
+      case Type::INT: {
+        int32_t val;
+        fs_.read(reinterpret_cast<char *>(&val), sizeof(val));
+        values.emplace_back(val);
+        break;
+      }
+      case Type::UINT: {
+        uint32_t val;
+        fs_.read(reinterpret_cast<char *>(&val), sizeof(val));
+        values.emplace_back(val);
+        break;
+      }
+      case Type::DOUBLE: {
+        double val;
+        fs_.read(reinterpret_cast<char *>(&val), sizeof(val));
+        values.emplace_back(val);
+        break;
+      }
+      case Type::CHAR:
+      case Type::VARCHAR: {
+        uint32_t length;
+        fs_.read(reinterpret_cast<char *>(&length), sizeof(length));
+        std::string val(length, '\0');
+        fs_.read(val.data(), length);
+        values.emplace_back(std::move(val), static_cast<Type>(type));
+        break;
+      }
+      default:
+        throw DbException("Type unsupported for spill file");
+    }
+  }
+  if (!fs_) {
+    throw DbException("Failed to read spill file " + path_);
+  }
+  return true;
+}
+
+size_t SpillFile::Size() const { return size_; }
+
+size_t SpillFile::MemorySize(const std::vector<Value> &values) {
+  size_t size = sizeof(values) + values.size() * sizeof(Value);
+  for (const auto &value : values) {
+    if (!value.IsNull() && (value.GetType() == Type::CHAR || value.GetType() == Type::VARCHAR)) {
+      size += value.GetSize();
+    }
+  }
+  return size;
+}
+
+}  // namespace huadb
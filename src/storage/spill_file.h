@@ -0,0 +1,37 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "common/value.h"
+
+namespace huadb {
+
+// 执行器内存不足时使用的临时文件，位于 TEMP_DATABASE_OID 目录下，析构时删除
+// 先顺序写入若干行，调用 Rewind 后再顺序读出
+class SpillFile {
+ public:
+  SpillFile();
+  ~SpillFile();
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+
+  void Append(const std::vector<Value> &values);
+  // 结束写入，从头开始读取
+  void Rewind();
+  // 读取下一行，文件读完时返回 false
+  bool Read(std::vector<Value> &values);
+  // 已写入的行数
+  size_t Size() const;
+
+  // 估计一行在内存中占用的字节数，用于执行器的内存统计
+  static size_t MemorySize(const std::vector<Value> &values);
+
+ private:
+  std::string path_;
+  std::fstream fs_;
+  size_t size_ = 0;
+};
+
+}  // namespace huadb
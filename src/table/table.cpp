@@ -1,6 +1,7 @@
 #include "table/table.h"
 
 #include "table/table_page.h"
+#include "table/table_scan.h"
 
 namespace huadb {
 
@@ -57,6 +58,20 @@ Rid Table::UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, std::shared_ptr<Re
   return InsertRecord(record, xid, cid, write_log);
 }
 
+std::shared_ptr<Record> Table::GetRecord(const Rid &rid, xid_t xid, IsolationLevel isolation_level, cid_t cid,
+                                         const std::unordered_set<xid_t> &active_xids) {
+  auto table_page = std::make_unique<TablePage>(buffer_pool_.GetPage(db_oid_, oid_, rid.page_id_));
+  if (rid.slot_id_ >= table_page->GetRecordCount()) {
+    return nullptr;
+  }
+  std::shared_ptr<Record> record = table_page->GetRecord(rid.slot_id_, column_list_);
+  if (!TableScan::IsVisible(*record, xid, isolation_level, cid, active_xids)) {
+    return nullptr;
+  }
+  record->SetRid(rid);
+  return record;
+}
+
 pageid_t Table::GetFirstPageId() const { return first_page_id_; }
 
 oid_t Table::GetOid() const { return oid_; }
@@ -65,4 +80,8 @@ oid_t Table::GetDbOid() const { return db_oid_; }
 
 const ColumnList &Table::GetColumnList() const { return column_list_; }
 
+VisibilityMap &Table::GetVisibilityMap() { return visibility_map_; }
+
+ZoneMap &Table::GetZoneMap() { return zone_map_; }
+
 }  // namespace huadb
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <unordered_set>
+
 #include "catalog/column_list.h"
 #include "common/typedefs.h"
 #include "log/log_manager.h"
 #include "storage/buffer_pool.h"
 #include "table/record.h"
+#include "table/visibility_map.h"
+#include "table/zone_map.h"
 
 namespace huadb {
 
@@ -20,6 +24,10 @@ class Table {
   void DeleteRecord(const Rid &rid, xid_t xid, bool write_log = true);
   // 更新记录
   Rid UpdateRecord(const Rid &rid, xid_t xid, cid_t cid, std::shared_ptr<Record> record, bool write_log = true);
+  // 按 rid 读取记录，记录对事务不可见时返回 nullptr，供索引扫描回表使用
+  // 删除和更新不删除旧版本的索引项，回表时与顺序扫描一样使用 TableScan::IsVisible 判断可见性
+  std::shared_ptr<Record> GetRecord(const Rid &rid, xid_t xid, IsolationLevel isolation_level, cid_t cid,
+                                    const std::unordered_set<xid_t> &active_xids);
 
   // 获取表的第一个页面的页面号
   pageid_t GetFirstPageId() const;
@@ -27,6 +35,8 @@ class Table {
   oid_t GetOid() const;
   oid_t GetDbOid() const;
   const ColumnList &GetColumnList() const;
+  VisibilityMap &GetVisibilityMap();
+  ZoneMap &GetZoneMap();
 
  private:
   BufferPool &buffer_pool_;
@@ -35,6 +45,8 @@ class Table {
   oid_t db_oid_;
   pageid_t first_page_id_;  // 第一个页面的页面号
   ColumnList column_list_;  // 表的 schema 信息
+  VisibilityMap visibility_map_;
+  ZoneMap zone_map_;
 };
 
 }  // namespace huadb
@@ -9,7 +9,7 @@ TableScan::TableScan(BufferPool &buffer_pool, std::shared_ptr<Table> table, Rid
 
 std::shared_ptr<Record> TableScan::GetNextRecord(xid_t xid, IsolationLevel isolation_level, cid_t cid,
                                                  const std::unordered_set<xid_t> &active_xids) {
-  // 根据事务隔离级别及活跃事务集合，判断记录是否可见
+  // 根据事务隔离级别及活跃事务集合，使用 IsVisible 判断记录是否可见
   // LAB 3 BEGIN
 
   // 每次调用读取一条记录
@@ -19,4 +19,30 @@ std::shared_ptr<Record> TableScan::GetNextRecord(xid_t xid, IsolationLevel isola
   return nullptr;
 }
 
+bool TableScan::IsVisible(const Record &record, xid_t xid, IsolationLevel isolation_level, cid_t cid,
+                          const std::unordered_set<xid_t> &active_xids) {
+  if (record.IsDeleted()) {
+    return false;
+  }
+  if (xid == NULL_XID) {
+    return true;
+  }
+  // 读已提交时 active_xids 为当前活跃事务，其余隔离级别为事务开始时的快照，快照之后开始的事务的修改不可见
+  auto committed = [&](xid_t other) {
+    return active_xids.find(other) == active_xids.end() &&
+           (isolation_level == IsolationLevel::READ_COMMITTED || other < xid);
+  };
+  auto xmin = record.GetXmin();
+  if (xmin == xid) {
+    // 本事务插入的记录只对之后的命令可见
+    if (record.GetCid() >= cid) {
+      return false;
+    }
+  } else if (!committed(xmin)) {
+    return false;
+  }
+  auto xmax = record.GetXmax();
+  return xmax == NULL_XID || (xmax != xid && !committed(xmax));
+}
+
 }  // namespace huadb
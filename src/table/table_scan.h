@@ -19,6 +19,10 @@ class TableScan {
   // 均为 Lab 3 相关参数
   std::shared_ptr<Record> GetNextRecord(xid_t xid = NULL_XID, IsolationLevel isolation_level = DEFAULT_ISOLATION_LEVEL,
                                         cid_t cid = NULL_CID, const std::unordered_set<xid_t> &active_xids = {});
+  // 判断记录对事务是否可见，参数与 GetNextRecord 相同，xid 为 NULL_XID 时只跳过已删除的记录
+  // GetNextRecord 与按 rid 回表的 Table::GetRecord 共用同一套可见性规则
+  static bool IsVisible(const Record &record, xid_t xid, IsolationLevel isolation_level, cid_t cid,
+                        const std::unordered_set<xid_t> &active_xids);
 
  private:
   BufferPool &buffer_pool_;
@@ -0,0 +1,28 @@
+#include "table/visibility_map.h"
+
+namespace huadb {
+
+void VisibilityMap::SetAllVisible(pageid_t page_id, const std::function<bool()> &all_visible) {
+  std::lock_guard lock(mutex_);
+  if (!all_visible()) {
+    return;
+  }
+  if (page_id >= all_visible_.size()) {
+    all_visible_.resize(page_id + 1, false);
+  }
+  all_visible_[page_id] = true;
+}
+
+void VisibilityMap::ClearAllVisible(pageid_t page_id) {
+  std::lock_guard lock(mutex_);
+  if (page_id < all_visible_.size()) {
+    all_visible_[page_id] = false;
+  }
+}
+
+bool VisibilityMap::IsAllVisible(pageid_t page_id) const {
+  std::lock_guard lock(mutex_);
+  return page_id < all_visible_.size() && all_visible_[page_id];
+}
+
+}  // namespace huadb
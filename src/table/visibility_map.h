@@ -0,0 +1,27 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "common/typedefs.h"
+
+namespace huadb {
+
+// 可见性映射：记录表的每个页面是否全部可见，即页面中的记录对所有事务都可见且没有被删除的记录
+// 全部可见的页面在仅索引扫描时不需要回表
+// 映射只保存在内存中，由 VACUUM 设置，页面被修改后清除，重启后所有页面都视为不是全部可见
+class VisibilityMap {
+ public:
+  // 在映射的锁内调用 all_visible 重新检查页面，通过时才设置标记
+  // 写者修改页面后再清除标记，因此检查之后的修改一定会清除本次设置的标记
+  void SetAllVisible(pageid_t page_id, const std::function<bool()> &all_visible);
+  void ClearAllVisible(pageid_t page_id);
+  bool IsAllVisible(pageid_t page_id) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<bool> all_visible_;
+};
+
+}  // namespace huadb
@@ -0,0 +1,127 @@
+#include "table/zone_map.h"
+
+#include <algorithm>
+
+#include "common/constants.h"
+
+namespace huadb {
+
+// 只有这些类型的最小值和最大值可以比较
+static bool IsComparable(Type type) {
+  return type == Type::INT || type == Type::DOUBLE || type == Type::CHAR || type == Type::VARCHAR;
+}
+
+void ZoneMap::Update(const Rid &rid, const Record &record) {
+  std::lock_guard lock(mutex_);
+  auto zone_id = ZoneOf(rid.page_id_);
+  if (zone_id >= zones_.size()) {
+    zones_.resize(zone_id + 1);
+  }
+  auto &zone = zones_[zone_id];
+  if (zone.state_ == ZoneState::ABSENT) {
+    if (rid.page_id_ % ZONE_MAP_PAGES != 0 || rid.slot_id_ != 0) {
+      // 段内已有未被摘要覆盖的记录
+      zone.state_ = ZoneState::INVALID;
+      return;
+    }
+    zone.state_ = ZoneState::VALID;
+    zone.columns_.resize(record.GetValues().size());
+  }
+  if (zone.state_ == ZoneState::INVALID) {
+    return;
+  }
+  zone.last_page_id_ = std::max(zone.last_page_id_, rid.page_id_);
+  zone.record_count_++;
+  const auto &values = record.GetValues();
+  for (size_t i = 0; i < values.size(); i++) {
+    auto &column = zone.columns_[i];
+    if (values[i].IsNull()) {
+      column.null_count_++;
+      continue;
+    }
+    if (!IsComparable(values[i].GetType())) {
+      continue;
+    }
+    if (column.min_.IsNull() || values[i].Less(column.min_)) {
+      column.min_ = values[i];
+    }
+    if (column.max_.IsNull() || values[i].Greater(column.max_)) {
+      column.max_ = values[i];
+    }
+  }
+}
+
+void ZoneMap::Reset() {
+  std::lock_guard lock(mutex_);
+  zones_.clear();
+}
+
+bool ZoneMap::CanSkip(size_t zone_id, const std::vector<ZonePredicate> &predicates, pageid_t &last_page_id) const {
+  std::lock_guard lock(mutex_);
+  if (zone_id >= zones_.size() || zones_[zone_id].state_ != ZoneState::VALID) {
+    return false;
+  }
+  const auto &zone = zones_[zone_id];
+  for (const auto &predicate : predicates) {
+    if (!MightMatch(zone, predicate)) {
+      last_page_id = zone.last_page_id_;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t ZoneMap::ZoneOf(pageid_t page_id) { return page_id / ZONE_MAP_PAGES; }
+
+bool ZoneMap::MightMatch(const Zone &zone, const ZonePredicate &predicate) {
+  if (predicate.col_idx_ >= zone.columns_.size()) {
+    return true;
+  }
+  const auto &column = zone.columns_[predicate.col_idx_];
+  switch (predicate.type_) {
+    case ZonePredicateType::IS_NULL:
+      return column.null_count_ > 0;
+    case ZonePredicateType::IS_NOT_NULL:
+      return column.null_count_ < zone.record_count_;
+    default:
+      break;
+  }
+  if (column.null_count_ == zone.record_count_) {
+    // 全部为空值，与任何值比较都不为真
+    return false;
+  }
+  if (column.min_.IsNull()) {
+    return true;
+  }
+  // 常量与列的类型不同时无法比较，保守地认为可能满足
+  auto in_range = [&column](const Value &value, ZonePredicateType type) {
+    if (value.GetType() != column.min_.GetType()) {
+      return true;
+    }
+    switch (type) {
+      case ZonePredicateType::EQUAL:
+        return !value.Less(column.min_) && !value.Greater(column.max_);
+      case ZonePredicateType::LESS:
+        return column.min_.Less(value);
+      case ZonePredicateType::LESS_EQUAL:
+        return !column.min_.Greater(value);
+      case ZonePredicateType::GREATER:
+        return column.max_.Greater(value);
+      case ZonePredicateType::GREATER_EQUAL:
+        return !column.max_.Less(value);
+      default:
+        return true;
+    }
+  };
+  if (predicate.type_ == ZonePredicateType::IN) {
+    for (const auto &value : predicate.values_) {
+      if (in_range(value, ZonePredicateType::EQUAL)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return in_range(predicate.values_[0], predicate.type_);
+}
+
+}  // namespace huadb
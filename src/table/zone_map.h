@@ -0,0 +1,61 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "common/typedefs.h"
+#include "common/value.h"
+#include "table/record.h"
+
+namespace huadb {
+
+enum class ZonePredicateType { EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, IN, IS_NULL, IS_NOT_NULL };
+
+// 可用于跳过页面段的合取项：col op const、col IN (const, ...)、col IS [NOT] NULL，常量已转换为列的类型
+struct ZonePredicate {
+  size_t col_idx_;
+  ZonePredicateType type_;
+  std::vector<Value> values_;
+};
+
+// 区域映射：将表按页面号每 ZONE_MAP_PAGES 个页面划为一段，记录段内各列的最小值、最大值和空值个数
+// 顺序扫描时，摘要表明段内没有满足谓词的记录的页面段可以整段跳过
+// 摘要只增不减，删除记录不收缩范围。映射只保存在内存中，插入记录时更新，由 VACUUM 重新计算
+// 表的页面按页面号顺序分配，段的第一条记录位于段首页面的 0 号槽时摘要才覆盖段内全部记录，
+// 否则（如重启后向已有记录的段插入）该段标记为无效，直到 VACUUM 重新计算前都不会被跳过
+class ZoneMap {
+ public:
+  // 记录插入到 rid 之后更新所在段的摘要
+  void Update(const Rid &rid, const Record &record);
+  // 清空所有摘要，之后按页面顺序重新 Update 全部记录即可重建
+  void Reset();
+  // 段的摘要有效且表明段内没有满足全部谓词的记录时返回 true，并通过 last_page_id 返回段内有记录的最大页面号
+  bool CanSkip(size_t zone_id, const std::vector<ZonePredicate> &predicates, pageid_t &last_page_id) const;
+
+  static size_t ZoneOf(pageid_t page_id);
+
+ private:
+  enum class ZoneState { ABSENT, VALID, INVALID };
+
+  struct ColumnSummary {
+    // 非空值的最小值和最大值，尚无非空值或类型不支持比较时为空值
+    Value min_;
+    Value max_;
+    size_t null_count_ = 0;
+  };
+
+  struct Zone {
+    ZoneState state_ = ZoneState::ABSENT;
+    pageid_t last_page_id_ = 0;
+    size_t record_count_ = 0;
+    std::vector<ColumnSummary> columns_;
+  };
+
+  // 段内可能有满足谓词的记录时返回 true
+  static bool MightMatch(const Zone &zone, const ZonePredicate &predicate);
+
+  mutable std::mutex mutex_;
+  std::vector<Zone> zones_;
+};
+
+}  // namespace huadb
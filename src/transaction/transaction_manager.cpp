@@ -1,5 +1,6 @@
 #include "transaction/transaction_manager.h"
 
+#include <algorithm>
 #include <string>
 
 #include "common/exceptions.h"
@@ -69,6 +70,17 @@ std::unordered_set<xid_t> TransactionManager::GetActiveTransactions() {
   return active_xids;
 }
 
+xid_t TransactionManager::GetOldestXmin() {
+  xid_t oldest_xmin = next_xid_;
+  for (const auto &[xid, active_xids] : xid2active_set_) {
+    oldest_xmin = std::min(oldest_xmin, xid);
+    for (auto active_xid : active_xids) {
+      oldest_xmin = std::min(oldest_xmin, active_xid);
+    }
+  }
+  return oldest_xmin;
+}
+
 void TransactionManager::ReleaseLocks(xid_t xid) { lock_manager_.ReleaseLocks(xid); }
 
 }  // namespace huadb
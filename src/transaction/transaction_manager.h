@@ -35,6 +35,9 @@ class TransactionManager {
   std::unordered_set<xid_t> GetSnapshot(xid_t xid);
   // 获取活跃事务表
   std::unordered_set<xid_t> GetActiveTransactions();
+  // 获取活跃事务及其快照中最小的 xid，没有活跃事务时为下一个 xid
+  // 插入事务早于该 xid 的记录已经提交，并且对所有正在运行的事务的快照都可见
+  xid_t GetOldestXmin();
 
  private:
   // 释放事务持有的锁
@@ -0,0 +1,104 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/constants.h"
+#include "common/exceptions.h"
+#include "index/b_plus_tree.h"
+#include "log/log_manager.h"
+#include "storage/buffer_pool.h"
+#include "storage/disk.h"
+#include "transaction/lock_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace fs = std::filesystem;
+
+// 多个线程同时向同一棵 B+ 树插入交错的键，插入过程中叶节点、内部节点和根节点都会并发地分裂
+// 插入结束后检查每个键都能查到，且按顺序遍历时恰好得到全部键
+static constexpr size_t THREAD_COUNT = 4;
+static constexpr uint32_t KEYS_PER_THREAD = 5000;
+static constexpr const char *TEST_DIRECTORY = "huadb_test";
+static constexpr huadb::oid_t DB_OID = huadb::PRESERVED_OID;
+static constexpr huadb::oid_t INDEX_OID = huadb::PRESERVED_OID + 1;
+
+// 大端序编码，按 memcmp 比较的顺序与数值顺序一致
+static std::string MakeKey(uint32_t value) {
+  std::string key(sizeof(uint32_t), '\0');
+  for (size_t i = 0; i < sizeof(uint32_t); i++) {
+    key[i] = static_cast<char>(value >> (8 * (sizeof(uint32_t) - 1 - i)));
+  }
+  return key;
+}
+
+static bool Run(huadb::BPlusTree &tree) {
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < THREAD_COUNT; t++) {
+    threads.emplace_back([&tree, t]() {
+      // 各线程的键交错排列，相邻的键由不同线程插入，使各线程频繁修改相同的节点
+      for (uint32_t i = 0; i < KEYS_PER_THREAD; i++) {
+        tree.Insert(MakeKey(i * THREAD_COUNT + t));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  uint32_t key_count = KEYS_PER_THREAD * THREAD_COUNT;
+  for (uint32_t value = 0; value < key_count; value++) {
+    auto key = MakeKey(value);
+    auto iter = tree.Seek(key, true);
+    if (iter.IsEnd() || iter.Key() != key) {
+      std::cerr << "Key " << value << " not found" << std::endl;
+      return false;
+    }
+  }
+  uint32_t expected = 0;
+  for (auto iter = tree.Seek("", true); !iter.IsEnd(); iter.Next()) {
+    if (expected == key_count || iter.Key() != MakeKey(expected)) {
+      std::cerr << "Unexpected key at position " << expected << std::endl;
+      return false;
+    }
+    expected++;
+  }
+  if (expected != key_count) {
+    std::cerr << "Scan returned " << expected << " keys, expected " << key_count << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  if (fs::is_directory(TEST_DIRECTORY)) {
+    fs::remove_all(TEST_DIRECTORY);
+  }
+  fs::create_directory(TEST_DIRECTORY);
+  fs::current_path(TEST_DIRECTORY);
+
+  bool success;
+  try {
+    huadb::Disk disk;
+    huadb::LockManager lock_manager;
+    huadb::TransactionManager transaction_manager(lock_manager);
+    huadb::LogManager log_manager(disk, transaction_manager);
+    huadb::BufferPool buffer_pool(disk, log_manager);
+    disk.CreateDirectory(std::to_string(DB_OID));
+    disk.CreateFile(huadb::Disk::GetFilePath(DB_OID, INDEX_OID));
+    huadb::BPlusTree tree(buffer_pool, log_manager, INDEX_OID, DB_OID, true);
+    success = Run(tree);
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    success = false;
+  }
+  fs::current_path("..");
+
+  std::cout << "b_plus_tree_concurrency ";
+  if (success) {
+    std::cout << huadb::BOLD << huadb::GREEN << "PASS" << huadb::RESET << std::endl;
+    return 0;
+  }
+  std::cerr << huadb::BOLD << huadb::RED << "ERROR" << huadb::RESET << std::endl;
+  return 1;
+}